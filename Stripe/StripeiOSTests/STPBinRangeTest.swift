@@ -6,6 +6,8 @@
 //  Copyright © 2016 Stripe, Inc. All rights reserved.
 //
 
+import StripeCoreTestUtils
+
 @testable@_spi(STP) import Stripe
 @testable@_spi(STP) import StripeCore
 @testable@_spi(STP) import StripePayments
@@ -240,4 +242,68 @@ class STPBinRangeTest: XCTestCase {
         let missingFundingRange = try decoder.decode(STPBINRange.self, from: missingFundingJSON)
         XCTAssertEqual(missingFundingRange.funding, .other)
     }
+
+    func testRangeTableMatchesFilteringAllRanges() {
+        let table = STPBINRangeTable.initial.merging([
+            STPBINRange(
+                panLength: 16,
+                brand: .unionPay,
+                accountRangeLow: "6244780000000000",
+                accountRangeHigh: "6244789999999999",
+                country: "CN",
+                funding: .credit
+            ),
+            STPBINRange(
+                panLength: 16,
+                brand: .visa,
+                accountRangeLow: "41",
+                accountRangeHigh: "4",
+                country: nil,
+                funding: .other
+            ),
+        ])
+        let numbers = [
+            "", "4", "42", "4242424242424242", "4506", "450629", "62", "624478", "6244781", "81", "9", "3 4", "x",
+        ]
+
+        var generator = SplitMix64(seed: 0xB1A5)
+        let randomNumbers = (0..<1_000).map { _ in String(Int.random(in: 0...999_999_999, using: &generator)) }
+        for number in numbers + randomNumbers {
+            XCTAssertEqual(
+                table.ranges(forNumber: number),
+                table.ranges.filter { $0.matchesNumber(number) },
+                number
+            )
+        }
+        for brand in STPCardBrand.allCases {
+            XCTAssertEqual(table.ranges(for: brand), table.ranges.filter { $0.brand == brand })
+        }
+    }
+
+    // MARK: - Benchmarks
+
+    /// Every prefix of a card number, like a customer typing it in
+    let keystrokes = (1...16).map { String("4242424242424242".prefix($0)) }
+        + (1...16).map { String("6244780000000000".prefix($0)) }
+
+    func testFilteringAllRangesPerKeystrokePerformance() {
+        let ranges = STPBINController.shared.allRanges()
+        measure {
+            for _ in 0..<200 {
+                for number in keystrokes {
+                    _ = Set(ranges.filter { $0.matchesNumber(number) }.map { $0.brand })
+                }
+            }
+        }
+    }
+
+    func testRangeTablePerKeystrokePerformance() {
+        measure {
+            for _ in 0..<200 {
+                for number in keystrokes {
+                    _ = STPCardValidator.possibleBrands(forNumber: number)
+                }
+            }
+        }
+    }
 }
@@ -28,7 +28,12 @@ struct AppleOcr {
 
     }
 
-    static func performOcr(image: CGImage, completion: @escaping ([OcrObject]) -> Void) {
+    /// Builds a text request for `image`. `completion` only runs if the request completes, so
+    /// callers that hold on to the request can `cancel()` it while `perform` is running.
+    static func textRequest(
+        image: CGImage,
+        completion: @escaping ([OcrObject]) -> Void
+    ) -> VNRecognizeTextRequest {
         let textRequest = VNRecognizeTextRequest { request, _ in
             let imageSize = CGSize(width: image.width, height: image.height)
 
@@ -62,18 +67,20 @@ struct AppleOcr {
 
         textRequest.recognitionLevel = .accurate
         textRequest.usesLanguageCorrection = false
+        return textRequest
+    }
 
+    /// Runs `request` synchronously on the calling thread
+    ///
+    /// - Returns: `false` if Vision failed or the request was cancelled
+    @discardableResult
+    static func perform(_ request: VNRequest, on image: CGImage) -> Bool {
         let handler = VNImageRequestHandler(cgImage: image, options: [:])
         do {
-            try handler.perform([textRequest])
+            try handler.perform([request])
+            return true
         } catch {
-            completion([])
-        }
-    }
-
-    static func recognizeText(in image: CGImage, complete: @escaping ([OcrObject]) -> Void) {
-        DispatchQueue.global(qos: .userInitiated).async {
-            performOcr(image: image) { complete($0) }
+            return false
         }
     }
 }
@@ -1,4 +1,5 @@
 import Foundation
+@_spi(STP) import StripeCore
 
 struct CreditCardUtils {
     static let maxCvvLength = 3
@@ -26,6 +27,28 @@ struct CreditCardUtils {
 
     static var prefixesRegional: [String] = []
 
+    /// The prefixes above in the order `determineCardNetwork` checks them
+    private static func networkPrefixes(
+        regionalPrefixes: [String]
+    ) -> [(prefix: String, network: CardNetwork)] {
+        let networks: [([String], CardNetwork)] = [
+            (prefixesAmericanExpress, .AMEX),
+            (prefixesDiscover, .DISCOVER),
+            (prefixesJcb, .JCB),
+            (prefixesDinersClub, .DINERSCLUB),
+            (prefixesVisa, .VISA),
+            (prefixesMastercard, .MASTERCARD),
+            (prefixesUnionPay, .UNIONPAY),
+            (regionalPrefixes, .REGIONAL),
+        ]
+        return networks.flatMap { prefixes, network in prefixes.map { ($0, network) } }
+    }
+
+    /// `networkPrefixes` indexed by digit, along with the regional prefixes it was built from so that
+    /// it's rebuilt when `prefixesRegional` changes. Only access it with `networkTrieLock` held.
+    private static var networkTrie: (regionalPrefixes: [String], trie: DigitPrefixTrie, networks: [CardNetwork])?
+    private static let networkTrieLock = NSLock()
+
     private static var cardTypeMap: [(ClosedRange<Int>, CardType)]?
 
     ///    Adds the BINs implemented by the MIR network in Russia as regional cards
@@ -224,26 +247,30 @@ struct CreditCardUtils {
             return CardNetwork.UNKNOWN
         }
 
-        switch true {
-        case hasAnyPrefix(cardNumber: cardNumber, prefixes: prefixesAmericanExpress):
-            return CardNetwork.AMEX
-        case hasAnyPrefix(cardNumber: cardNumber, prefixes: prefixesDiscover):
-            return CardNetwork.DISCOVER
-        case hasAnyPrefix(cardNumber: cardNumber, prefixes: prefixesJcb):
-            return CardNetwork.JCB
-        case hasAnyPrefix(cardNumber: cardNumber, prefixes: prefixesDinersClub):
-            return CardNetwork.DINERSCLUB
-        case hasAnyPrefix(cardNumber: cardNumber, prefixes: prefixesVisa):
-            return CardNetwork.VISA
-        case hasAnyPrefix(cardNumber: cardNumber, prefixes: prefixesMastercard):
-            return CardNetwork.MASTERCARD
-        case hasAnyPrefix(cardNumber: cardNumber, prefixes: prefixesUnionPay):
-            return CardNetwork.UNIONPAY
-        case hasAnyPrefix(cardNumber: cardNumber, prefixes: prefixesRegional):
-            return CardNetwork.REGIONAL
-        default:
+        // the first prefix that matches wins, and prefixes are indexed in the order they're checked
+        let (trie, networks) = networkLookup()
+        guard let first = trie.ranges(containing: cardNumber).first else {
             return CardNetwork.UNKNOWN
         }
+        return networks[first]
+    }
+
+    /// Checking the cached trie against the current regional prefixes and rebuilding it happen under one
+    /// lock, so a trie built from prefixes that have since changed is never published or used
+    private static func networkLookup() -> (DigitPrefixTrie, [CardNetwork]) {
+        networkTrieLock.lock()
+        defer { networkTrieLock.unlock() }
+
+        let regionalPrefixes = prefixesRegional
+        if let networkTrie = networkTrie, networkTrie.regionalPrefixes == regionalPrefixes {
+            return (networkTrie.trie, networkTrie.networks)
+        }
+
+        let prefixes = networkPrefixes(regionalPrefixes: regionalPrefixes)
+        let trie = DigitPrefixTrie(ranges: prefixes.map { (low: $0.prefix, high: $0.prefix) })
+        let networks = prefixes.map { $0.network }
+        networkTrie = (regionalPrefixes, trie, networks)
+        return (trie, networks)
     }
 
     ///    Returns the card's type (debit, credit, preiad, unknown) based on the card number
@@ -300,15 +327,6 @@ struct CreditCardUtils {
         return cardTypes.first { $0.0.contains(iin) }?.1 ?? .UNKNOWN
     }
 
-    ///     Determines whether a card number belongs to any bank network according to their bin
-    ///     -   Parameters:
-    ///         -   cardNumber: The card number as a string
-    ///         -   prefixes: The set of bin prefixes used with certain bank networks
-    ///     -   Returns: `true` if card number belongs to a bank network, `false` otherwise
-    static func hasAnyPrefix(cardNumber: String, prefixes: [String]) -> Bool {
-        return prefixes.filter { cardNumber.hasPrefix($0) }.count > 0
-    }
-
     // TODO: Will be replaced with `formatCardNumber` in future version
     static func format(number: String) -> String {
         return formatCardNumber(cardNumber: number)
@@ -0,0 +1,199 @@
+//
+//  AnalyzerScheduler.swift
+//  StripeCardScan
+//
+//  Created by Stripe on 10/17/26.
+//
+
+import Foundation
+
+/// How `AnalyzerScheduler` picked the analyzer for the most recent frame
+enum AnalyzerSchedulingPolicy: String {
+    /// Not enough measurements yet, idle analyzers take frames in the order they became idle
+    case roundRobin = "round_robin"
+    /// The idle analyzer with the most hits per second of computation takes the frame
+    case yieldWeighted = "yield_weighted"
+    /// Same as `yieldWeighted`, but at least one low-yield analyzer is paused
+    case throttled = "throttled"
+}
+
+/// Decides which idle OCR analyzer gets the next frame in `OcrMainLoop`.
+///
+/// The scheduler keeps an exponentially weighted moving average of each analyzer's latency and hit
+/// rate, where a hit is a prediction that read anything, be it a number, an expiry or a name. Analyzers
+/// that contribute different fields, like Apple's OCR which is the only source of expiries and names,
+/// are then judged on what they contribute rather than on the number alone. Once every analyzer has a few
+/// measurements it hands frames to the analyzer that produces the most hits per second of
+/// computation, and it pauses analyzers whose hit rate stays low while another analyzer is doing
+/// better. Pauses get longer as the device heats up, and the best analyzer is never paused.
+///
+/// All methods must be called from the `OcrMainLoop` `mutexQueue`.
+class AnalyzerScheduler {
+    struct AnalyzerStats {
+        var latency = 0.0
+        var hitRate = 0.0
+        var samples = 0
+        var pausedUntil: Date?
+        var pauses = 0
+
+        /// Hits per second of computation
+        var yield: Double {
+            return hitRate / max(latency, 0.001)
+        }
+    }
+
+    /// Weight of the newest measurement in the moving averages
+    let smoothing: Double
+    /// Measurements an analyzer needs before the scheduler trusts its averages
+    let minimumSamples: Int
+    /// Analyzers whose hit rate drops below this get paused if another analyzer is doing better
+    let pauseHitRate: Double
+    /// How long to pause a low-yield analyzer when the device is at a nominal thermal state
+    let basePauseDuration: TimeInterval
+
+    private(set) var policy: AnalyzerSchedulingPolicy = .roundRobin
+    private var stats: [ObjectIdentifier: AnalyzerStats] = [:]
+
+    private let now: () -> Date
+    private let thermalState: () -> ProcessInfo.ThermalState
+
+    init(
+        smoothing: Double = 0.2,
+        minimumSamples: Int = 5,
+        pauseHitRate: Double = 0.1,
+        basePauseDuration: TimeInterval = 0.5,
+        now: @escaping () -> Date = { Date() },
+        thermalState: @escaping () -> ProcessInfo.ThermalState = {
+            ProcessInfo.processInfo.thermalState
+        }
+    ) {
+        self.smoothing = smoothing
+        self.minimumSamples = minimumSamples
+        self.pauseHitRate = pauseHitRate
+        self.basePauseDuration = basePauseDuration
+        self.now = now
+        self.thermalState = thermalState
+    }
+
+    func stats(for analyzer: CreditCardOcrImplementation) -> AnalyzerStats {
+        return stats[ObjectIdentifier(analyzer)] ?? AnalyzerStats()
+    }
+
+    /// The total number of times any analyzer has been paused
+    var pauseCount: Int {
+        return stats.values.reduce(0) { $0 + $1.pauses }
+    }
+
+    /// Records how long an analyzer took on a frame and what it read. It's a hit if the analyzer read a
+    /// number, an expiry or a name.
+    func record(
+        analyzer: CreditCardOcrImplementation,
+        latency: TimeInterval,
+        prediction: CreditCardOcrPrediction
+    ) {
+        let hit =
+            prediction.number != nil || prediction.expiryMonth != nil || prediction.expiryYear != nil
+            || prediction.name != nil
+        record(analyzer: analyzer, latency: latency, hit: hit)
+    }
+
+    /// Records how long an analyzer took on a frame and whether it read anything
+    func record(analyzer: CreditCardOcrImplementation, latency: TimeInterval, hit: Bool) {
+        let key = ObjectIdentifier(analyzer)
+        var analyzerStats = stats[key] ?? AnalyzerStats()
+        let hitValue = hit ? 1.0 : 0.0
+        if analyzerStats.samples == 0 {
+            analyzerStats.latency = latency
+            analyzerStats.hitRate = hitValue
+        } else {
+            analyzerStats.latency += smoothing * (latency - analyzerStats.latency)
+            analyzerStats.hitRate += smoothing * (hitValue - analyzerStats.hitRate)
+        }
+        analyzerStats.samples += 1
+        stats[key] = analyzerStats
+
+        pauseIfLowYield(key)
+    }
+
+    /// Removes and returns the idle analyzer that should get the next frame, or `nil` if every
+    /// idle analyzer is paused.
+    ///
+    /// - Parameter idleAnalyzers: The idle analyzers, with the analyzer that has been idle the
+    ///   longest at the end
+    func nextAnalyzer(
+        from idleAnalyzers: inout [CreditCardOcrImplementation]
+    ) -> CreditCardOcrImplementation? {
+        let currentTime = now()
+        let isMeasured = stats.count > 1 && stats.values.allSatisfy { $0.samples >= minimumSamples }
+
+        var bestIndex: Int?
+        var bestYield = -1.0
+        var hasPausedAnalyzer = false
+        for index in idleAnalyzers.indices.reversed() {
+            let analyzerStats = stats(for: idleAnalyzers[index])
+            if let pausedUntil = analyzerStats.pausedUntil, pausedUntil > currentTime {
+                hasPausedAnalyzer = true
+                continue
+            }
+
+            guard isMeasured else {
+                bestIndex = index
+                break
+            }
+
+            // strictly greater so that ties go to the analyzer that has been idle the longest
+            if analyzerStats.yield > bestYield {
+                bestYield = analyzerStats.yield
+                bestIndex = index
+            }
+        }
+
+        if hasPausedAnalyzer {
+            policy = .throttled
+        } else {
+            policy = isMeasured ? .yieldWeighted : .roundRobin
+        }
+
+        return bestIndex.map { idleAnalyzers.remove(at: $0) }
+    }
+
+    private func pauseIfLowYield(_ key: ObjectIdentifier) {
+        guard var analyzerStats = stats[key],
+            analyzerStats.samples >= minimumSamples,
+            analyzerStats.hitRate < pauseHitRate
+        else {
+            return
+        }
+
+        // only pause an analyzer if a measured analyzer is doing better, so we never pause them all
+        let isOutperformed = stats.contains { otherKey, other in
+            otherKey != key && other.samples >= minimumSamples && other.yield > analyzerStats.yield
+        }
+        guard isOutperformed else {
+            return
+        }
+
+        let currentTime = now()
+        if let pausedUntil = analyzerStats.pausedUntil, pausedUntil > currentTime {
+            return
+        }
+        analyzerStats.pausedUntil = currentTime.addingTimeInterval(pauseDuration())
+        analyzerStats.pauses += 1
+        stats[key] = analyzerStats
+    }
+
+    private func pauseDuration() -> TimeInterval {
+        switch thermalState() {
+        case .nominal:
+            return basePauseDuration
+        case .fair:
+            return basePauseDuration * 2
+        case .serious:
+            return basePauseDuration * 4
+        case .critical:
+            return basePauseDuration * 8
+        @unknown default:
+            return basePauseDuration
+        }
+    }
+}
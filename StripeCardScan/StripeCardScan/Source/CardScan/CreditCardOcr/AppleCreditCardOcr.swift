@@ -6,13 +6,20 @@
 //  Copyright © 2020 Sam King. All rights reserved.
 //
 import UIKit
+import Vision
 
 class AppleCreditCardOcr: CreditCardOcrImplementation {
+    /// The Vision request that is running, so that `cancel()` can stop it
+    @AtomicProperty private var inFlightRequest: VNRequest?
+
+    /// Runs Vision directly on the calling analyzer queue rather than handing it to another queue and
+    /// waiting, so each frame in flight only ties up one thread.
     override func recognizeCard(
         in fullImage: CGImage,
         roiRectangle: CGRect
     ) -> CreditCardOcrPrediction {
-        guard let (image, roiForOcr) = fullImage.croppedImageForSsd(roiRectangle: roiRectangle)
+        guard !isCancelled,
+            let (image, roiForOcr) = fullImage.croppedImageForSsd(roiRectangle: roiRectangle)
         else {
             return CreditCardOcrPrediction.emptyPrediction(cgImage: fullImage)
         }
@@ -20,52 +27,57 @@ class AppleCreditCardOcr: CreditCardOcrImplementation {
         var pan: String?
         var expiryMonth: String?
         var expiryYear: String?
-        let semaphore = DispatchSemaphore(value: 0)
         let startTime = Date()
         var name: String?
         var nameBox: CGRect?
         var numberBox: CGRect?
         var expiryBox: CGRect?
-        var nameCandidates: [OcrObject] = []
-        AppleOcr.recognizeText(in: image) { results in
-            for result in results {
-                let predictedPan = CreditCardOcrPrediction.pan(result.text)
-                let expiry = CreditCardOcrPrediction.likelyExpiry(result.text)
-                if let (month, year) = expiry {
-                    if CreditCardUtils.isValidDate(expMonth: month, expYear: year) {
-                        if expiryMonth == nil {
-                            expiryBox = result.rect
-                            expiryMonth = month
-                        }
-                        if expiryYear == nil { expiryYear = year }
-                    }
-                }
-                if pan == nil && predictedPan != nil {
-                    pan = predictedPan
-                    numberBox = result.rect
-                }
+        var nameCandidates: [(OcrObject, String)] = []
 
-                let predictedName = AppleCreditCardOcr.likelyName(result.text)
-                if predictedName != nil {
-                    nameCandidates.append(result)
-                }
+        var results: [OcrObject] = []
+        let request = AppleOcr.textRequest(image: image) { results = $0 }
+        inFlightRequest = request
+        // check again in case `cancel()` ran before the request was visible to it
+        if !isCancelled {
+            instrumentation.measure(.appleOcr) {
+                AppleOcr.perform(request, on: image)
             }
+        }
+        inFlightRequest = nil
 
-            let minY = numberBox.map({ $0.minY - $0.height }) ?? expiryBox?.minY
-            let names = nameCandidates.filter { name in
-                let isInExpectedLocation = minY.map({ name.rect.minY >= ($0 - 5.0) }) ?? false
-                return name.confidence >= 0.5 && isInExpectedLocation
+        for result in results {
+            let classification = OcrTextClassifier.classify(result.text)
+            if let (month, year) = classification.expiry {
+                if CreditCardUtils.isValidDate(expMonth: month, expYear: year) {
+                    if expiryMonth == nil {
+                        expiryBox = result.rect
+                        expiryMonth = month
+                    }
+                    if expiryYear == nil { expiryYear = year }
+                }
+            }
+            if pan == nil && classification.pan != nil {
+                pan = classification.pan
+                numberBox = result.rect
             }
 
-            // just pick the first one for now
-            if let nameResult = names.first {
-                name = AppleCreditCardOcr.likelyName(nameResult.text)
-                nameBox = nameResult.rect
+            if let predictedName = classification.name {
+                nameCandidates.append((result, predictedName))
             }
+        }
+
+        let minY = numberBox.map({ $0.minY - $0.height }) ?? expiryBox?.minY
+        let names = nameCandidates.filter { name, _ in
+            let isInExpectedLocation = minY.map({ name.rect.minY >= ($0 - 5.0) }) ?? false
+            return name.confidence >= 0.5 && isInExpectedLocation
+        }
 
-            semaphore.signal()
+        // just pick the first one for now
+        if let (nameResult, predictedName) = names.first {
+            name = predictedName
+            nameBox = nameResult.rect
         }
-        semaphore.wait()
+
         let duration = -startTime.timeIntervalSinceNow
         self.computationTime += duration
         self.frames += 1
@@ -84,6 +96,11 @@ class AppleCreditCardOcr: CreditCardOcrImplementation {
         )
     }
 
+    override func cancel() {
+        super.cancel()
+        inFlightRequest?.cancel()
+    }
+
     static func likelyName(_ text: String) -> String? {
         let words = text.split(separator: " ").map { String($0) }
         let validWords = words.filter {
@@ -9,12 +9,24 @@ import UIKit
 
 /// Base class for any OCR prediction systems. All implementations must override `recognizeCard` and update the `frames`
 /// and `computationTime` member variables
+///
+/// Callers that shouldn't block, like `OcrMainLoop`, use the completion handler version of `recognizeCard`.
+/// Implementations that wait on other work override the completion handler version so that
+/// they call back when that work is done instead of parking a thread on it.
 
 @_spi(STP) public class CreditCardOcrImplementation {
     let dispatchQueue: ActiveStateComputation
     var frames = 0
     var computationTime = 0.0
     let startTime = Date()
+    /// Times the stages of each frame. `OcrMainLoop` replaces it with the one for the whole scan before
+    /// the first frame.
+    var instrumentation = ScanInstrumentation()
+    /// What the UX model saw in the frame being recognized, set by `UxAnalyzer` before it passes the
+    /// frame on. Implementations can use it to skip work on frames without a card.
+    var latestCardState: CenteredCardState?
+    /// Set by `cancel()`, implementations check it between steps and stop early once it's set
+    @AtomicProperty private(set) var isCancelled = false
 
     var framesPerSecond: Double {
         return Double(frames) / -startTime.timeIntervalSinceNow
@@ -24,6 +36,23 @@ import UIKit
         return Double(frames) / computationTime
     }
 
+    /// What the implementation's `FrameGate` decided so far, if it has one
+    var frameGateStatistics: FrameGateStatistics? {
+        return nil
+    }
+
+    /// The most frames `recognizeCards` takes at once. `OcrMainLoop` keeps at least this many frames
+    /// waiting for its analyzers.
+    var maxBatchSize: Int {
+        return 1
+    }
+
+    /// How many frames the implementation wants for its next `recognizeCards` call, from 1 up to
+    /// `maxBatchSize`
+    var preferredBatchSize: Int {
+        return 1
+    }
+
     init(
         dispatchQueueLabel: String
     ) {
@@ -39,4 +68,51 @@ import UIKit
     func recognizeCard(in fullImage: CGImage, roiRectangle: CGRect) -> CreditCardOcrPrediction {
         preconditionFailure("This method must be overridden")
     }
+
+    /// Calls `completion` with the prediction for the frame, or an empty prediction once cancelled.
+    /// By default this runs `recognizeCard(in:roiRectangle:)` on the calling thread.
+    func recognizeCard(
+        in fullImage: CGImage,
+        roiRectangle: CGRect,
+        completion: @escaping (CreditCardOcrPrediction) -> Void
+    ) {
+        guard !isCancelled else {
+            completion(CreditCardOcrPrediction.emptyPrediction(cgImage: fullImage))
+            return
+        }
+        completion(recognizeCard(in: fullImage, roiRectangle: roiRectangle))
+    }
+
+    /// Calls `completion` with one prediction per frame, in order. By default this recognizes the frames
+    /// one after the other, implementations that can run their model over several frames at once override it.
+    func recognizeCards(
+        in frames: [(image: CGImage, roiRectangle: CGRect)],
+        completion: @escaping ([CreditCardOcrPrediction]) -> Void
+    ) {
+        recognizeCards(in: frames[...], predictions: [], completion: completion)
+    }
+
+    private func recognizeCards(
+        in frames: ArraySlice<(image: CGImage, roiRectangle: CGRect)>,
+        predictions: [CreditCardOcrPrediction],
+        completion: @escaping ([CreditCardOcrPrediction]) -> Void
+    ) {
+        guard let frame = frames.first else {
+            completion(predictions)
+            return
+        }
+        recognizeCard(in: frame.image, roiRectangle: frame.roiRectangle) { prediction in
+            self.recognizeCards(
+                in: frames.dropFirst(),
+                predictions: predictions + [prediction],
+                completion: completion
+            )
+        }
+    }
+
+    /// Stops this analyzer for good, e.g. when the user cancels the scan. Any recognition that is
+    /// running finishes as soon as the implementation notices, possibly with an empty prediction.
+    func cancel() {
+        isCancelled = true
+    }
 }
@@ -41,6 +41,10 @@ struct CreditCardOcrPrediction {
     let numberBoxes: [CGRect]?
     let expiryBoxes: [CGRect]?
     let nameBoxes: [CGRect]?
+    /// Whether `number` and `numberBoxes` were carried over from an earlier frame instead of read from
+    /// this one, because `SSDCreditCardOcr`'s gate found the frame to be a near duplicate. Reused
+    /// predictions still vote, but they aren't new reads, so they don't count as hits or as OCR'd frames.
+    let isReused: Bool
 
     // this is only used by Card Verify and the Liveness check and filled in by the UxModel
     var centeredCardState: CenteredCardState?
@@ -57,6 +61,7 @@ struct CreditCardOcrPrediction {
         numberBoxes: [CGRect]?,
         expiryBoxes: [CGRect]?,
         nameBoxes: [CGRect]?,
+        isReused: Bool = false,
         centeredCardState: CenteredCardState? = nil,
         uxFrameConfidenceValues: UxFrameConfidenceValues? = nil
     ) {
@@ -71,6 +76,7 @@ struct CreditCardOcrPrediction {
         self.numberBoxes = numberBoxes
         self.expiryBoxes = expiryBoxes
         self.nameBoxes = nameBoxes
+        self.isReused = isReused
         self.centeredCardState = centeredCardState
         self.uxFrameConfidenceValues = uxFrameConfidenceValues
     }
@@ -78,7 +84,7 @@ struct CreditCardOcrPrediction {
     func with(uxPrediction: UxModelOutput) -> CreditCardOcrPrediction {
         let uxFrameConfidenceValues: UxFrameConfidenceValues? = {
             if let (hasPan, hasNoPan, hasNoCard) = uxPrediction.confidenceValues() {
-                let hasOcr = self.number != nil
+                let hasOcr = self.number != nil && !self.isReused
                 return UxFrameConfidenceValues(
                     hasOcr: hasOcr,
                     uxPan: hasPan,
@@ -100,6 +106,7 @@ struct CreditCardOcrPrediction {
             numberBoxes: self.numberBoxes,
             expiryBoxes: self.expiryBoxes,
             nameBoxes: self.nameBoxes,
+            isReused: self.isReused,
             centeredCardState: uxPrediction.cardCenteredState(),
             uxFrameConfidenceValues: uxFrameConfidenceValues
         )
@@ -3,9 +3,10 @@ import Foundation
 class ErrorCorrection {
     let stateMachine: MainLoopStateMachine
     var frames = 0
-    var numbers: [String: Int] = [:]
-    var expiries: [String: Int] = [:]
-    var names: [String: Int] = [:]
+    let voteDecay: Double
+    var numbers: VoteTracker<String>
+    var expiries: VoteTracker<String>
+    var names: VoteTracker<String>
     let startTime = Date()
     var mostRecentPrediction: CreditCardOcrPrediction?
 
@@ -13,21 +14,28 @@ class ErrorCorrection {
         return Double(frames) / -startTime.timeIntervalSinceNow
     }
 
+    /// - Parameter voteDecay: How much each older frame's votes count relative to the next frame.
+    ///   1 counts every frame equally.
     init(
-        stateMachine: MainLoopStateMachine
+        stateMachine: MainLoopStateMachine,
+        voteDecay: Double = 1.0
     ) {
         self.stateMachine = stateMachine
+        self.voteDecay = voteDecay
+        self.numbers = VoteTracker(decay: voteDecay)
+        self.expiries = VoteTracker(decay: voteDecay)
+        self.names = VoteTracker(decay: voteDecay)
     }
 
     var number: String? {
-        return self.numbers.sorted { $0.1 > $1.1 }.map { $0.0 }.first
+        return self.numbers.leader
     }
 
     func result() -> CreditCardOcrResult? {
         guard stateMachine.loopState() != .initial else { return nil }
-        let predictedNumber = self.numbers.sorted { $0.1 > $1.1 }.map { $0.0 }.first
-        let predictedExpiry = self.expiries.sorted { $0.1 > $1.1 }.map { $0.0 }.first
-        let predictedName = self.names.sorted { $0.1 > $1.1 }.map { $0.0 }.first
+        let predictedNumber = self.numbers.leader
+        let predictedExpiry = self.expiries.leader
+        let predictedName = self.names.leader
         guard let prediction = self.mostRecentPrediction else { return nil }
 
         guard let number = predictedNumber else {
@@ -69,19 +77,32 @@ class ErrorCorrection {
 
     func add(prediction: CreditCardOcrPrediction) -> CreditCardOcrResult? {
         self.frames += 1
+        self.numbers.nextFrame()
+        self.expiries.nextFrame()
+        self.names.nextFrame()
 
         let newState = stateMachine.event(prediction: prediction)
 
         if newState != .ocrIncorrect {
             if let pan = prediction.number {
-                self.numbers[pan] = (self.numbers[pan] ?? 0) + 1
+                self.numbers.vote(for: pan)
             }
             if let expiry = prediction.expiryForDisplay {
-                self.expiries[expiry] = (self.expiries[expiry] ?? 0) + 1
+                self.expiries.vote(for: expiry)
             }
-            for name in prediction.name?.split(separator: "\n").map({ String($0) }) ?? [] {
-                self.names[name] = (self.names[name] ?? 0) + 1
+            if let name = prediction.name {
+                // most names are a single line, so only split when we need to
+                if name.contains("\n") {
+                    for line in name.split(separator: "\n") {
+                        self.names.vote(for: String(line))
+                    }
+                } else {
+                    self.names.vote(for: name)
+                }
             }
+
+            // let the state machine finish early once the number is clearly settled
+            (stateMachine as? OcrMainLoopStateMachine)?.numberConfidence = self.numbers.confidence
         }
 
         self.mostRecentPrediction = prediction
@@ -90,6 +111,6 @@ class ErrorCorrection {
     }
 
     func reset() -> ErrorCorrection {
-        return ErrorCorrection(stateMachine: stateMachine.reset())
+        return ErrorCorrection(stateMachine: stateMachine.reset(), voteDecay: voteDecay)
     }
 }
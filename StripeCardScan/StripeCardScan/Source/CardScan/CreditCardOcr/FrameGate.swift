@@ -0,0 +1,161 @@
+//
+//  FrameGate.swift
+//  StripeCardScan
+//
+//  Created by Stripe on 10/17/26.
+//
+
+import CoreGraphics
+import Foundation
+
+/// What `FrameGate` decided to do with a frame
+enum FrameGateDecision: Equatable {
+    /// Run the model on the frame
+    case analyze
+    /// The UX model didn't find a card in the frame, so there's no number to read
+    case skipNoCard
+    /// The frame looks the same as the last analyzed frame, so its result still holds
+    case reuseLast
+}
+
+/// Counts of what `FrameGate` decided
+struct FrameGateStatistics: Equatable {
+    var analyzed = 0
+    var skippedNoCard = 0
+    var reusedLast = 0
+
+    static func + (lhs: FrameGateStatistics, rhs: FrameGateStatistics) -> FrameGateStatistics {
+        return FrameGateStatistics(
+            analyzed: lhs.analyzed + rhs.analyzed,
+            skippedNoCard: lhs.skippedNoCard + rhs.skippedNoCard,
+            reusedLast: lhs.reusedLast + rhs.reusedLast
+        )
+    }
+
+    func toDictionaryForAnalytics() -> [String: Any] {
+        return [
+            "analyzed": analyzed,
+            "skipped_no_card": skippedNoCard,
+            "reused_last": reusedLast,
+        ]
+    }
+}
+
+/// Decides whether a frame is worth running SSD OCR on.
+///
+/// The gate shrinks each frame's crop down to a tiny luminance thumbnail and compares it with the
+/// thumbnail of the last frame it let through. Frames whose mean absolute difference is under
+/// `duplicateThreshold` are near duplicates, so the model would read the same thing again. Frames
+/// that the UX model says have no card in them are skipped outright.
+///
+/// So that a card held perfectly still still gets fresh reads, and a wrong UX prediction can't starve
+/// OCR, the gate lets a frame through after `maxConsecutiveSkips` frames in a row were skipped or reused.
+/// Near duplicates are compared with the last analyzed frame rather than the previous frame, so slow
+/// drift eventually gets analyzed too.
+///
+/// The gate keeps its thumbnails between frames and isn't thread safe, so each analyzer owns one and
+/// only uses it from its own queue. `statistics` can be read from any queue.
+final class FrameGate {
+    static let thumbnailWidth = 32
+    static let thumbnailHeight = 20
+
+    /// Mean absolute luminance difference, out of 255, under which a frame counts as a duplicate
+    let duplicateThreshold: Double
+    let maxConsecutiveSkips: Int
+
+    @AtomicProperty private(set) var statistics = FrameGateStatistics()
+
+    private var thumbnail = [UInt8](repeating: 0, count: FrameGate.thumbnailWidth * FrameGate.thumbnailHeight)
+    private var lastAnalyzedThumbnail: [UInt8]?
+    private var consecutiveSkips = 0
+
+    init(
+        duplicateThreshold: Double = 2.0,
+        maxConsecutiveSkips: Int = 3
+    ) {
+        self.duplicateThreshold = duplicateThreshold
+        self.maxConsecutiveSkips = maxConsecutiveSkips
+    }
+
+    /// - Parameters:
+    ///   - image: The crop that the model would run on
+    ///   - cardState: What the UX model saw in the same frame, if it ran
+    func decision(for image: CGImage, cardState: CenteredCardState?) -> FrameGateDecision {
+        let decision = makeDecision(for: image, cardState: cardState)
+        switch decision {
+        case .analyze:
+            consecutiveSkips = 0
+            statistics.analyzed += 1
+        case .skipNoCard:
+            consecutiveSkips += 1
+            statistics.skippedNoCard += 1
+        case .reuseLast:
+            consecutiveSkips += 1
+            statistics.reusedLast += 1
+        }
+        return decision
+    }
+
+    // MARK: - Helpers
+
+    private func makeDecision(for image: CGImage, cardState: CenteredCardState?) -> FrameGateDecision {
+        guard consecutiveSkips < maxConsecutiveSkips else {
+            // later frames get compared with this one
+            updateLastAnalyzedThumbnail(from: image)
+            return .analyze
+        }
+
+        if cardState == .noCard {
+            return .skipNoCard
+        }
+
+        guard drawThumbnail(of: image) else {
+            lastAnalyzedThumbnail = nil
+            return .analyze
+        }
+        if let last = lastAnalyzedThumbnail,
+            FrameGate.meanAbsoluteDifference(thumbnail, last) < duplicateThreshold
+        {
+            return .reuseLast
+        }
+        lastAnalyzedThumbnail = thumbnail
+        return .analyze
+    }
+
+    private func updateLastAnalyzedThumbnail(from image: CGImage) {
+        lastAnalyzedThumbnail = drawThumbnail(of: image) ? thumbnail : nil
+    }
+
+    /// Draws `image` into `thumbnail` as 8 bit luminance
+    private func drawThumbnail(of image: CGImage) -> Bool {
+        let width = FrameGate.thumbnailWidth
+        let height = FrameGate.thumbnailHeight
+        return thumbnail.withUnsafeMutableBytes { bytes -> Bool in
+            guard
+                let context = CGContext(
+                    data: bytes.baseAddress,
+                    width: width,
+                    height: height,
+                    bitsPerComponent: 8,
+                    bytesPerRow: width,
+                    space: CGColorSpaceCreateDeviceGray(),
+                    bitmapInfo: CGImageAlphaInfo.none.rawValue
+                )
+            else {
+                return false
+            }
+            context.interpolationQuality = .low
+            context.draw(image, in: CGRect(x: 0, y: 0, width: width, height: height))
+            return true
+        }
+    }
+
+    static func meanAbsoluteDifference(_ lhs: [UInt8], _ rhs: [UInt8]) -> Double {
+        guard lhs.count == rhs.count, !lhs.isEmpty else { return .infinity }
+        var total = 0
+        for index in lhs.indices {
+            total += abs(Int(lhs[index]) - Int(rhs[index]))
+        }
+        return Double(total) / Double(lhs.count)
+    }
+}
@@ -0,0 +1,161 @@
+//
+//  LatestFramesBuffer.swift
+//  StripeCardScan
+//
+//  Created by Stripe on 10/17/26.
+//
+
+import Foundation
+
+/// Counters describing what happened to the frames pushed into a `LatestFramesBuffer`
+struct LatestFramesStatistics: Equatable {
+    /// Frames accepted from the producer
+    var pushed = 0
+    /// Frames evicted by a newer frame before any consumer took them
+    var dropped = 0
+    /// Frames handed to a consumer
+    var consumed = 0
+    /// Frames discarded because the buffer was closed or shrunk while they were waiting
+    var stale = 0
+}
+
+/// A bounded ring buffer that hands frames from the capture thread to the OCR analyzers.
+///
+/// The buffer only ever holds the `capacity` most recent frames. Pushing into a full buffer drops
+/// the oldest frame, so the producer never waits for a consumer. Consumers take the oldest frame
+/// still in the buffer, which spaces out the frames that get analyzed.
+///
+/// Every operation is O(1) and holds an unfair lock for a handful of index updates, so the capture
+/// thread never waits behind analyzer bookkeeping. Frames that are evicted are released after the
+/// lock is dropped.
+final class LatestFramesBuffer<Element> {
+    private var storage: [Element?]
+    private var head = 0
+    private var count = 0
+    private var isClosed = false
+    private var counters = LatestFramesStatistics()
+
+    // Allocated up front rather than lazily so that the first push and pop can't race to create it
+    private let lock: os_unfair_lock_t
+
+    init(
+        capacity: Int
+    ) {
+        self.storage = [Element?](repeating: nil, count: max(capacity, 1))
+        self.lock = os_unfair_lock_t.allocate(capacity: 1)
+        self.lock.initialize(to: os_unfair_lock_s())
+    }
+
+    deinit {
+        lock.deallocate()
+    }
+
+    /// The maximum number of frames held at once. Shrinking the buffer keeps the most recent frames.
+    var capacity: Int {
+        get {
+            os_unfair_lock_lock(lock)
+            defer { os_unfair_lock_unlock(lock) }
+            return storage.count
+        }
+        set {
+            let newCapacity = max(newValue, 1)
+            os_unfair_lock_lock(lock)
+            let oldStorage = storage
+            let kept = min(count, newCapacity)
+            var newStorage = [Element?](repeating: nil, count: newCapacity)
+            for offset in 0..<kept {
+                newStorage[offset] = storage[(head + count - kept + offset) % storage.count]
+            }
+            counters.stale += count - kept
+            storage = newStorage
+            head = 0
+            count = kept
+            os_unfair_lock_unlock(lock)
+            withExtendedLifetime(oldStorage) {}
+        }
+    }
+
+    var isEmpty: Bool {
+        os_unfair_lock_lock(lock)
+        defer { os_unfair_lock_unlock(lock) }
+        return count == 0
+    }
+
+    var statistics: LatestFramesStatistics {
+        os_unfair_lock_lock(lock)
+        defer { os_unfair_lock_unlock(lock) }
+        return counters
+    }
+
+    /// Adds a frame, dropping the oldest frame if the buffer is full.
+    ///
+    /// - Returns: `false` if the buffer is closed and the frame was ignored
+    @discardableResult
+    func push(_ element: Element) -> Bool {
+        var evicted: Element?
+        os_unfair_lock_lock(lock)
+        guard !isClosed else {
+            os_unfair_lock_unlock(lock)
+            return false
+        }
+
+        let tail = (head + count) % storage.count
+        if count == storage.count {
+            evicted = storage[tail]
+            head = (head + 1) % storage.count
+            counters.dropped += 1
+        } else {
+            count += 1
+        }
+        storage[tail] = element
+        counters.pushed += 1
+        os_unfair_lock_unlock(lock)
+
+        withExtendedLifetime(evicted) {}
+        return true
+    }
+
+    /// Removes and returns the oldest frame, or `nil` if there is nothing to analyze
+    func popOldest() -> Element? {
+        os_unfair_lock_lock(lock)
+        defer { os_unfair_lock_unlock(lock) }
+        guard count > 0 else {
+            return nil
+        }
+
+        let element = storage[head]
+        storage[head] = nil
+        head = (head + 1) % storage.count
+        count -= 1
+        counters.consumed += 1
+        return element
+    }
+
+    /// Discards any waiting frames and ignores new ones until `open` is called
+    func close() {
+        var discarded: [Element] = []
+        os_unfair_lock_lock(lock)
+        isClosed = true
+        discarded.reserveCapacity(count)
+        while count > 0 {
+            if let element = storage[head] {
+                discarded.append(element)
+            }
+            storage[head] = nil
+            head = (head + 1) % storage.count
+            count -= 1
+            counters.stale += 1
+        }
+        head = 0
+        os_unfair_lock_unlock(lock)
+
+        withExtendedLifetime(discarded) {}
+    }
+
+    /// Starts accepting frames again after `close`
+    func open() {
+        os_unfair_lock_lock(lock)
+        isClosed = false
+        os_unfair_lock_unlock(lock)
+    }
+}
@@ -29,8 +29,12 @@ protocol MainLoopStateMachine {
 // from the `OcrMainLoop`
 class OcrMainLoopStateMachine: NSObject, MainLoopStateMachine {
     var state: MainLoopState = .initial
+    /// The clock for state durations, replaced with a virtual clock when replaying recorded scans
+    var now: () -> Date = { Date() }
     var startTimeForCurrentState = Date()
     let errorCorrectionDurationSeconds = 2.0
+    /// How settled the error corrected number is, updated by `ErrorCorrection` after each frame
+    var numberConfidence = VoteConfidence()
 
     override init() {}
 
@@ -41,7 +45,7 @@ class OcrMainLoopStateMachine: NSObject, MainLoopStateMachine {
     func event(prediction: CreditCardOcrPrediction) -> MainLoopState {
         let newState = transition(prediction: prediction)
         if let newState = newState {
-            startTimeForCurrentState = Date()
+            startTimeForCurrentState = now()
             state = newState
         }
 
@@ -49,7 +53,7 @@ class OcrMainLoopStateMachine: NSObject, MainLoopStateMachine {
     }
 
     func transition(prediction: CreditCardOcrPrediction) -> MainLoopState? {
-        let timeInCurrentStateSeconds = -startTimeForCurrentState.timeIntervalSinceNow
+        let timeInCurrentStateSeconds = secondsInCurrentState
         let frameHasOcr = prediction.number != nil
 
         switch (state, timeInCurrentStateSeconds, frameHasOcr) {
@@ -63,13 +67,22 @@ class OcrMainLoopStateMachine: NSObject, MainLoopStateMachine {
         }
     }
 
+    var secondsInCurrentState: TimeInterval {
+        return now().timeIntervalSince(startTimeForCurrentState)
+    }
+
     func reset() -> MainLoopStateMachine {
-        return OcrMainLoopStateMachine()
+        let stateMachine = OcrMainLoopStateMachine()
+        stateMachine.now = now
+        stateMachine.startTimeForCurrentState = now()
+        return stateMachine
     }
 }
 
 class OcrAccurateMainLoopStateMachine: NSObject, MainLoopStateMachine {
     var state: MainLoopState = .initial
+    /// The clock for state durations, replaced with a virtual clock when replaying recorded scans
+    var now: () -> Date = { Date() }
     var startTimeForCurrentState = Date()
     var hasExpiryPrediction = false
 
@@ -91,14 +104,14 @@ class OcrAccurateMainLoopStateMachine: NSObject, MainLoopStateMachine {
     func event(prediction: CreditCardOcrPrediction) -> MainLoopState {
         let newState = transition(prediction: prediction)
         if let newState = newState {
-            startTimeForCurrentState = Date()
+            startTimeForCurrentState = now()
             state = newState
         }
         return newState ?? state
     }
 
     func transition(prediction: CreditCardOcrPrediction) -> MainLoopState? {
-        let timeInCurrentStateSeconds = -startTimeForCurrentState.timeIntervalSinceNow
+        let timeInCurrentStateSeconds = secondsInCurrentState
         let frameHasOcr = prediction.number != nil
         hasExpiryPrediction = hasExpiryPrediction || prediction.expiryForDisplay != nil
         switch (state, timeInCurrentStateSeconds, frameHasOcr, hasExpiryPrediction) {
@@ -113,7 +126,14 @@ class OcrAccurateMainLoopStateMachine: NSObject, MainLoopStateMachine {
             return nil
         }
     }
+    var secondsInCurrentState: TimeInterval {
+        return now().timeIntervalSince(startTimeForCurrentState)
+    }
+
     func reset() -> MainLoopStateMachine {
-        return OcrAccurateMainLoopStateMachine(maxErrorCorrection: maximumErrorCorrection)
+        let stateMachine = OcrAccurateMainLoopStateMachine(maxErrorCorrection: maximumErrorCorrection)
+        stateMachine.now = now
+        stateMachine.startTimeForCurrentState = now()
+        return stateMachine
     }
 }
@@ -24,6 +24,9 @@ struct NameWords {
         "mgy", "sign",
     ]
 
+    /// `blacklist` as a perfect hash table, so `OcrTextClassifier` can check words straight from UTF-8
+    static let blacklistWordSet = PerfectHashWordSet(blacklist)
+
     static func nonNameWordMatch(_ text: String) -> Bool {
         let lowerCase = text.lowercased()
         return blacklist.contains(lowerCase)
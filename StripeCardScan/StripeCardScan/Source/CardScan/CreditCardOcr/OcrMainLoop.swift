@@ -3,12 +3,24 @@
 /// system will push images and ROI rectangles into the main loop and two Analyzers, or OCR systems
 /// will consume the images.
 ///
-/// The producer, which pushes images will keep N (2 currently) images in the queue and when a new image
-/// comes in it will remove old images leaving the N most recent images. That way we can try to get more
-/// diversity in images by virtue of maximizing the time in between images that it reads.
+/// The producer, which pushes images will keep N (`imageQueueSize`, 2 by default) images in the `frames`
+/// ring buffer and when a new image comes in it will drop the oldest image leaving the N most recent images.
+/// That way we can try to get more diversity in images by virtue of maximizing the time in between images
+/// that it reads. Pushing an image never waits on the `mutexQueue`, so the capture thread can't get stuck
+/// behind analyzer bookkeeping.
 ///
 /// The consumers pull images from the queue and run the full OCR algorithm, including expiry extraction and
-/// full error correction on the combined results.
+/// full error correction on the combined results. When more than one consumer is idle, the `scheduler` picks
+/// which one gets the next image based on each analyzer's measured latency and hit rate, and it may pause
+/// an analyzer that rarely reads anything to save CPU and thermal budget.
+///
+/// Analyzers that can run their model over several frames at once, like `SSDCreditCardOcr`, say how many
+/// frames they want next with `preferredBatchSize`. When the model falls behind the camera and that many
+/// frames are waiting, the analyzer takes them all in one `recognizeCards` call, otherwise it takes the one
+/// frame that's there. The buffer always holds at least `maxBatchSize` frames for the largest batch.
+///
+/// Every analyzer shares the loop's `instrumentation`, which times each stage of a frame and counts the
+/// thermal state frames were analyzed at. After each frame the loop folds it into `scanStats`.
 ///
 /// In terms of iOS abstractions, we make heavy use of dispatch queues. We have a single `mutexQueue`
 /// that we use to mutate our shared state. This queue is a serial queue and our method for synchronizing
@@ -21,7 +33,7 @@
 ///
 /// ## Shared state
 /// All shared state updates need to happeon on the `mutexQueue` except for `machineLearningQueue`,
-/// which we set at the constructor and access it read only.
+/// which we set at the constructor and access it read only, and `frames`, which synchronizes itself.
 ///
 /// ## Delegate invocation
 /// All invocations of delegate methods need to happen on the main queue, and for each prediction there
@@ -95,9 +107,16 @@ class OcrMainLoop: MachineLearningLoop {
 
     weak var mainLoopDelegate: OcrMainLoopDelegate?
     var errorCorrection = ErrorCorrection(stateMachine: OcrMainLoopStateMachine())
-    var imageQueue: [ScannedCardImageData] = []
-    var imageQueueSize = 2
+    let frames = LatestFramesBuffer<ScannedCardImageData>(capacity: 2)
+    var imageQueueSize: Int {
+        get { frames.capacity }
+        set { frames.capacity = newValue }
+    }
     var analyzerQueue: [CreditCardOcrImplementation] = []
+    /// Every analyzer, idle or not, so that `userCancelled` can cancel the ones that are running
+    var analyzers: [CreditCardOcrImplementation] = []
+    let scheduler = AnalyzerScheduler()
+    let instrumentation = ScanInstrumentation()
     let mutexQueue = DispatchQueue(label: "OcrMainLoopMutex")
     var inBackground = false
     var machineLearningQueues: [DispatchQueue] = []
@@ -123,8 +142,11 @@ class OcrMainLoop: MachineLearningLoop {
     func setupMl(ocrImplementations: [CreditCardOcrImplementation]) {
         scanStats.model = "ssd+apple"
         for ocrImplementation in ocrImplementations {
+            ocrImplementation.instrumentation = instrumentation
             analyzerQueue.append(ocrImplementation)
         }
+        analyzers = ocrImplementations
+        imageQueueSize = max(imageQueueSize, ocrImplementations.map { $0.maxBatchSize }.max() ?? 1)
         registerAppNotifications()
     }
 
@@ -134,14 +156,18 @@ class OcrMainLoop: MachineLearningLoop {
         }
     }
 
-    static func warmUp() {
-        // TODO(stk): Implement this later
+    /// Loads the OCR and UX models in the background and runs a dummy inference through each of
+    /// them, so that the first scan doesn't pay for it. See `ModelWarmUp`.
+    static func warmUp(completion: ((ModelWarmUpTimings) -> Void)? = nil) {
+        ModelWarmUp.shared.warmUp(completion: completion)
     }
 
     // see the Correctness Criteria note in the comments above for why this is correct
     // Make sure you call this from the main dispatch queue
     func userCancelled() {
         userDidCancel = true
+        // stop any recognition that's in flight, cancelled analyzers don't go back on the queue
+        analyzers.forEach { $0.cancel() }
         mutexQueue.sync { [weak self] in
             guard let self = self else { return }
             self.scanStats.userCanceled = userDidCancel
@@ -154,17 +180,14 @@ class OcrMainLoop: MachineLearningLoop {
     }
 
     func push(imageData: ScannedCardImageData) {
-        mutexQueue.sync {
-            guard !inBackground else { return }
-            // only keep the latest images
-            imageQueue.insert(imageData, at: 0)
-            while imageQueue.count > imageQueueSize {
-                _ = imageQueue.popLast()
-            }
+        // the buffer is closed while we're in the background and only keeps the latest images
+        guard frames.push(imageData) else { return }
 
-            // if we have any analyzers waiting, fire them off now
-            guard let ocr = analyzerQueue.popLast() else { return }
-            analyzer(ocr: ocr)
+        // if we have any analyzers waiting, fire them off now
+        mutexQueue.async { [weak self] in
+            guard let self = self, !self.frames.isEmpty else { return }
+            guard let ocr = self.scheduler.nextAnalyzer(from: &self.analyzerQueue) else { return }
+            self.analyzer(ocr: ocr)
         }
     }
 
@@ -173,8 +196,8 @@ class OcrMainLoop: MachineLearningLoop {
             guard let self = self else { return }
             self.analyzerQueue.insert(ocr, at: 0)
             // only kick off the next analyzer if there is an image in the queue
-            if self.imageQueue.count > 0 {
-                guard let ocr = self.analyzerQueue.popLast() else { return }
+            if !self.frames.isEmpty {
+                guard let ocr = self.scheduler.nextAnalyzer(from: &self.analyzerQueue) else { return }
                 self.analyzer(ocr: ocr)
             }
         }
@@ -182,33 +205,90 @@ class OcrMainLoop: MachineLearningLoop {
 
     func analyzer(ocr: CreditCardOcrImplementation) {
         ocr.dispatchQueue.async { [weak self] in
-            var scannedCardImageData: ScannedCardImageData?
+            guard let self = self, !ocr.isCancelled else { return }
+
+            // grab an image and roi from the image queue. If the image queue is empty, which is also
+            // the case in the background, then add ourselves back to the analyzer queue
+            guard let imageData = self.frames.popOldest() else {
+                self.postAnalyzerToQueueAndRun(ocr: ocr)
+                return
+            }
 
-            // grab an image and roi from the image queue. If the image queue is empty then add ourselves
-            // back to the analyzer queue
-            self?.mutexQueue.sync {
-                guard !(self?.inBackground ?? false) else {
-                    self?.analyzerQueue.insert(ocr, at: 0)
-                    return
+            // run our ML model, add ourselves back to the analyzer queue unless we have a result
+            // and the result is finished. Implementations call back once they're done rather than
+            // blocking this queue while they wait on other work
+            let startTime = Date()
+            var batch = [imageData]
+            while batch.count < ocr.preferredBatchSize, let nextImageData = self.frames.popOldest() {
+                batch.append(nextImageData)
+            }
+            guard batch.count > 1 else {
+                ocr.recognizeCard(
+                    in: imageData.previewLayerImage,
+                    roiRectangle: imageData.previewLayerViewfinderRect
+                ) { [weak self] prediction in
+                    let latency = -startTime.timeIntervalSinceNow
+                    self?.instrumentation.record(.frame, duration: latency)
+                    self?.analyzerDidFinish(ocr: ocr, imageData: imageData, prediction: prediction, latency: latency)
                 }
-                guard let imageDataFromQueue = self?.imageQueue.popLast() else {
-                    self?.analyzerQueue.insert(ocr, at: 0)
-                    return
+                return
+            }
+
+            ocr.recognizeCards(
+                in: batch.map { (image: $0.previewLayerImage, roiRectangle: $0.previewLayerViewfinderRect) }
+            ) { [weak self] predictions in
+                // every frame in the batch gets its share of the time
+                let latency = -startTime.timeIntervalSinceNow / Double(batch.count)
+                for _ in batch {
+                    self?.instrumentation.record(.frame, duration: latency)
                 }
-                scannedCardImageData = imageDataFromQueue
+                self?.analyzerDidFinish(
+                    ocr: ocr,
+                    results: Array(zip(batch, predictions)),
+                    latency: latency
+                )
             }
+        }
+    }
 
-            guard let imageData = scannedCardImageData else { return }
+    func analyzerDidFinish(
+        ocr: CreditCardOcrImplementation,
+        imageData: ScannedCardImageData,
+        prediction: CreditCardOcrPrediction,
+        latency: TimeInterval
+    ) {
+        analyzerDidFinish(ocr: ocr, results: [(imageData, prediction)], latency: latency)
+    }
 
-            // run our ML model, add ourselves back to the analyzer queue unless we have a result
-            // and the result is finished
-            let prediction = ocr.recognizeCard(
-                in: imageData.previewLayerImage,
-                roiRectangle: imageData.previewLayerViewfinderRect
-            )
-            self?.mutexQueue.async {
-                guard let self = self else { return }
+    /// Handles the predictions from one `recognizeCard` or `recognizeCards` call in order, and puts the
+    /// analyzer back on the queue once unless one of them finished the scan
+    ///
+    /// - Parameter latency: How long the analyzer took per frame
+    func analyzerDidFinish(
+        ocr: CreditCardOcrImplementation,
+        results: [(ScannedCardImageData, CreditCardOcrPrediction)],
+        latency: TimeInterval
+    ) {
+        mutexQueue.async { [weak self] in
+            guard let self = self else { return }
+            // a cancelled analyzer's prediction may be empty, so don't count it or reschedule it
+            guard !ocr.isCancelled else { return }
+            for (_, prediction) in results {
                 self.scanStats.scans += 1
+                // a reused prediction didn't run the model, so it says nothing about the analyzer
+                if !prediction.isReused {
+                    self.scheduler.record(analyzer: ocr, latency: latency, prediction: prediction)
+                }
+                self.instrumentation.recordFrame()
+            }
+            self.scanStats.update(frameStatistics: self.frames.statistics)
+            self.scanStats.update(scheduler: self.scheduler)
+            self.scanStats.update(frameGates: self.analyzers.compactMap { $0.frameGateStatistics })
+            if self.scanStats.modelWarmUpTimings == nil {
+                self.scanStats.modelWarmUpTimings = ModelWarmUp.shared.timings
+            }
+            var isFinished = false
+            for (imageData, prediction) in results {
                 let delegate = self.mainLoopDelegate
                 DispatchQueue.main.async { [weak self] in
                     guard let self = self else { return }
@@ -219,16 +299,25 @@ class OcrMainLoop: MachineLearningLoop {
                         state: self.errorCorrection.stateMachine.loopState()
                     )
                 }
-                guard let result = self.combine(prediction: prediction), result.state == .finished
-                else {
-                    self.postAnalyzerToQueueAndRun(ocr: ocr)
-                    return
+                let result = self.instrumentation.measure(.errorCorrection) {
+                    self.combine(prediction: prediction)
+                }
+                if result?.state == .finished {
+                    isFinished = true
+                    break
                 }
             }
+            self.scanStats.update(instrumentation: self.instrumentation)
+            guard isFinished else {
+                self.postAnalyzerToQueueAndRun(ocr: ocr)
+                return
+            }
         }
     }
 
     func combine(prediction: CreditCardOcrPrediction) -> CreditCardOcrResult? {
+        // reused predictions still vote and advance the state machine: they're frames of the same card,
+        // and leaving them out holds off the result until enough frames are read again
         guard
             mainLoopDelegate?.shouldUsePrediction(
                 errorCorrectedNumber: errorCorrection.number,
@@ -279,9 +368,9 @@ class OcrMainLoop: MachineLearningLoop {
     @objc func willResignActive() {
         // make sure that no new images get pushed to our image buffer
         // and we clear out the image buffer
+        frames.close()
         mutexQueue.sync {
             self.inBackground = true
-            self.imageQueue = []
         }
     }
 
@@ -290,6 +379,7 @@ class OcrMainLoop: MachineLearningLoop {
             self.inBackground = false
             self.errorCorrection = self.errorCorrection.reset()
         }
+        frames.open()
     }
 
     func registerAppNotifications() {
@@ -0,0 +1,249 @@
+//
+//  OcrTextClassifier.swift
+//  StripeCardScan
+//
+//  Created by Stripe on 10/17/26.
+//
+
+import Foundation
+
+/// What one line of OCR text could be on a card, see `OcrTextClassifier`
+struct OcrTextClassification {
+    var pan: String?
+    var expiry: (month: String, year: String)?
+    var name: String?
+}
+
+/// Classifies a line of Apple OCR text as a card number, expiry or name candidate in a single pass
+/// over its UTF-8 bytes.
+///
+/// The answers are the same as `CreditCardOcrPrediction.pan`, `CreditCardOcrPrediction.likelyExpiry`
+/// and `AppleCreditCardOcr.likelyName`, but without compiling a regular expression, and without
+/// building any strings unless the text is a match. Those functions work on grapheme clusters, so
+/// text with non-ASCII characters, which Vision rarely returns for cards, is passed on to them.
+enum OcrTextClassifier {
+    static func classify(_ text: String) -> OcrTextClassification {
+        let utf8 = text.utf8
+        let nameWords = NameWords.blacklistWordSet
+
+        // card number: only digits and spaces, with a running Luhn sum for either parity of length
+        var isDigitsAndSpaces = true
+        var digitCount = 0
+        var luhnSumDoublingEven = 0
+        var luhnSumDoublingOdd = 0
+
+        // expiry: the last 7 bytes, newest in the low byte, and the line terminators seen
+        var tail: UInt64 = 0
+        var byteCount = 0
+        var lineTerminatorCount = 0
+
+        // name: the upper case words that aren't on the blacklist
+        var nameWordCount = 0
+        var wordStart = utf8.startIndex
+        var wordLength = 0
+        var wordIsUpperCase = true
+        var wordHash = nameWords.initialHash
+
+        func endWord(at end: String.UTF8View.Index) {
+            if wordLength > 0 && wordIsUpperCase
+                && (wordLength > nameWords.maxWordLength
+                    || !nameWords.contains(utf8[wordStart..<end], hash: wordHash))
+            {
+                nameWordCount += 1
+            }
+            wordLength = 0
+            wordIsUpperCase = true
+            wordHash = nameWords.initialHash
+        }
+
+        var index = utf8.startIndex
+        while index != utf8.endIndex {
+            let byte = utf8[index]
+            guard byte < 0x80 else {
+                return referenceClassification(text)
+            }
+
+            tail = (tail << 8) | UInt64(byte)
+            byteCount += 1
+            if byte >= 0x0A && byte <= 0x0D {
+                lineTerminatorCount += 1
+            }
+
+            if byte == space {
+                endWord(at: index)
+                wordStart = utf8.index(after: index)
+            } else {
+                if isDigit(byte) {
+                    let digit = Int(byte - zero)
+                    if digitCount % 2 == 0 {
+                        luhnSumDoublingEven += doubledLuhnDigit[digit]
+                        luhnSumDoublingOdd += digit
+                    } else {
+                        luhnSumDoublingEven += digit
+                        luhnSumDoublingOdd += doubledLuhnDigit[digit]
+                    }
+                    digitCount += 1
+                } else {
+                    isDigitsAndSpaces = false
+                }
+
+                wordLength += 1
+                wordIsUpperCase = wordIsUpperCase && byte >= 0x41 && byte <= 0x5A
+                if wordIsUpperCase && wordLength <= nameWords.maxWordLength {
+                    wordHash = PerfectHashWordSet.hash(wordHash, byte: byte)
+                }
+            }
+
+            utf8.formIndex(after: &index)
+        }
+        endWord(at: utf8.endIndex)
+
+        var classification = OcrTextClassification()
+
+        // Luhn doubles every second digit from the right, so which sum applies depends on the length
+        let luhnSum = digitCount % 2 == 0 ? luhnSumDoublingEven : luhnSumDoublingOdd
+        if isDigitsAndSpaces && luhnSum % 10 == 0 && panLengths.contains(digitCount) {
+            var number = ""
+            number.reserveCapacity(digitCount)
+            for byte in utf8 where byte != space {
+                number.unicodeScalars.append(Unicode.Scalar(byte))
+            }
+            if CreditCardUtils.isValidNumber(cardNumber: number) {
+                classification.pan = number
+            }
+        }
+
+        classification.expiry = expiry(
+            tail: tail,
+            byteCount: byteCount,
+            lineTerminatorCount: lineTerminatorCount
+        )
+
+        if nameWordCount >= 2 {
+            classification.name = name(in: text)
+        }
+
+        return classification
+    }
+
+    // MARK: - Expiry
+
+    /// Matches `^.*(0[1-9]|1[0-2])[./]([1-2][0-9])$` against the end of the text. Like
+    /// `NSRegularExpression`, `.` doesn't match line terminators and `$` also matches before a line
+    /// terminator that ends the text.
+    private static func expiry(
+        tail: UInt64,
+        byteCount: Int,
+        lineTerminatorCount: Int
+    ) -> (month: String, year: String)? {
+        let candidate: UInt64
+        switch lineTerminatorCount {
+        case 0 where byteCount >= 5:
+            candidate = tail
+        case 1 where byteCount >= 6 && isLineTerminator(UInt8(truncatingIfNeeded: tail)):
+            candidate = tail >> 8
+        case 2 where byteCount >= 7 && tail & 0xFFFF == 0x0D0A:
+            candidate = tail >> 16
+        default:
+            return nil
+        }
+
+        let month0 = UInt8(truncatingIfNeeded: candidate >> 32)
+        let month1 = UInt8(truncatingIfNeeded: candidate >> 24)
+        let separator = UInt8(truncatingIfNeeded: candidate >> 16)
+        let year0 = UInt8(truncatingIfNeeded: candidate >> 8)
+        let year1 = UInt8(truncatingIfNeeded: candidate)
+
+        let isMonth =
+            (month0 == zero && month1 >= zero + 1 && month1 <= zero + 9)
+            || (month0 == zero + 1 && month1 >= zero && month1 <= zero + 2)
+        let isSeparator = separator == 0x2E || separator == 0x2F
+        let isYear = (year0 == zero + 1 || year0 == zero + 2) && isDigit(year1)
+        guard isMonth && isSeparator && isYear else {
+            return nil
+        }
+
+        return (string(month0, month1), string(year0, year1))
+    }
+
+    // MARK: - Name
+
+    /// Joins the upper case words in `text` that aren't on the blacklist. Only called once the
+    /// classifying pass found at least two of them.
+    private static func name(in text: String) -> String {
+        let utf8 = text.utf8
+        let nameWords = NameWords.blacklistWordSet
+        var name = ""
+        name.reserveCapacity(utf8.count)
+
+        var wordStart = utf8.startIndex
+        var index = utf8.startIndex
+        while true {
+            let isEnd = index == utf8.endIndex
+            if isEnd || utf8[index] == space {
+                let word = utf8[wordStart..<index]
+                if !word.isEmpty && word.allSatisfy({ $0 >= 0x41 && $0 <= 0x5A })
+                    && (word.count > nameWords.maxWordLength || !nameWords.contains(word, hash: hash(word)))
+                {
+                    if !name.isEmpty {
+                        name.unicodeScalars.append(" ")
+                    }
+                    for byte in word {
+                        name.unicodeScalars.append(Unicode.Scalar(byte))
+                    }
+                }
+                guard !isEnd else { break }
+                wordStart = utf8.index(after: index)
+            }
+            utf8.formIndex(after: &index)
+        }
+
+        return name
+    }
+
+    private static func hash(_ word: Substring.UTF8View) -> UInt32 {
+        var hash = NameWords.blacklistWordSet.initialHash
+        for byte in word {
+            hash = PerfectHashWordSet.hash(hash, byte: byte)
+        }
+        return hash
+    }
+
+    // MARK: - Helpers
+
+    private static let space: UInt8 = 0x20
+    private static let zero: UInt8 = 0x30
+    /// A doubled digit's digit sum, indexed by the digit
+    private static let doubledLuhnDigit = [0, 2, 4, 6, 8, 1, 3, 5, 7, 9]
+    private static let panLengths: Set = [
+        CreditCardUtils.maxPanLength,
+        CreditCardUtils.maxPanLengthAmericanExpress,
+        CreditCardUtils.maxPanLengthDinersClub,
+    ]
+
+    @inline(__always)
+    private static func isDigit(_ byte: UInt8) -> Bool {
+        return byte >= zero && byte <= zero + 9
+    }
+
+    @inline(__always)
+    private static func isLineTerminator(_ byte: UInt8) -> Bool {
+        return byte >= 0x0A && byte <= 0x0D
+    }
+
+    private static func string(_ first: UInt8, _ second: UInt8) -> String {
+        var string = ""
+        string.unicodeScalars.append(Unicode.Scalar(first))
+        string.unicodeScalars.append(Unicode.Scalar(second))
+        return string
+    }
+
+    /// The functions this replaces, for text that isn't all ASCII
+    private static func referenceClassification(_ text: String) -> OcrTextClassification {
+        return OcrTextClassification(
+            pan: CreditCardOcrPrediction.pan(text),
+            expiry: CreditCardOcrPrediction.likelyExpiry(text).map { (month: $0.0, year: $0.1) },
+            name: AppleCreditCardOcr.likelyName(text)
+        )
+    }
+}
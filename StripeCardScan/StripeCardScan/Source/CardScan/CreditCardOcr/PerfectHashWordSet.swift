@@ -0,0 +1,124 @@
+//
+//  PerfectHashWordSet.swift
+//  StripeCardScan
+//
+//  Created by Stripe on 10/17/26.
+//
+
+import Foundation
+
+/// A fixed set of ASCII words that can be looked up case insensitively from UTF-8 bytes, without
+/// building a `String` for the word.
+///
+/// The table is built once with a hash seed chosen so that no two words land in the same slot, so a
+/// lookup is one hash, which callers can compute byte by byte as they scan, and at most one
+/// comparison.
+struct PerfectHashWordSet {
+    private let words: [[UInt8]]
+    /// Index into `words` for each slot, -1 for empty slots
+    private let slots: [Int]
+    private let mask: Int
+    private let seed: UInt32
+    /// No word in the set is longer than this, so longer words don't need a lookup
+    let maxWordLength: Int
+
+    init<Words: Sequence>(_ words: Words) where Words.Element == String {
+        let lowercased = Set(words.map { $0.lowercased() }).sorted().map { Array($0.utf8) }
+        let (slots, seed) = PerfectHashWordSet.buildSlots(for: lowercased)
+        self.words = lowercased
+        self.slots = slots
+        self.mask = slots.count - 1
+        self.seed = seed
+        self.maxWordLength = lowercased.map { $0.count }.max() ?? 0
+    }
+
+    var count: Int {
+        return words.count
+    }
+
+    // MARK: - Hashing
+
+    /// The hash of an empty word, feed it the word's bytes with `hash(_:byte:)`
+    var initialHash: UInt32 {
+        return PerfectHashWordSet.initialHash(seed: seed)
+    }
+
+    /// Adds one byte of a word to `hash`, ignoring ASCII case
+    @inline(__always)
+    static func hash(_ hash: UInt32, byte: UInt8) -> UInt32 {
+        return (hash ^ UInt32(lowercased(byte))) &* 16_777_619
+    }
+
+    // MARK: - Lookup
+
+    func contains(_ word: String) -> Bool {
+        var hash = initialHash
+        for byte in word.utf8 {
+            hash = PerfectHashWordSet.hash(hash, byte: byte)
+        }
+        return contains(word.utf8, hash: hash)
+    }
+
+    /// - Parameter hash: The hash of `word`'s bytes from `initialHash` and `hash(_:byte:)`
+    func contains<Bytes: Collection>(_ word: Bytes, hash: UInt32) -> Bool where Bytes.Element == UInt8 {
+        let index = slots[PerfectHashWordSet.slot(for: hash, mask: mask)]
+        guard index >= 0 else { return false }
+
+        let candidate = words[index]
+        guard candidate.count == word.count else { return false }
+        var candidateIndex = 0
+        for byte in word {
+            guard PerfectHashWordSet.lowercased(byte) == candidate[candidateIndex] else { return false }
+            candidateIndex += 1
+        }
+        return true
+    }
+
+    // MARK: - Building the table
+
+    /// Tries seeds until every word gets its own slot, doubling the table if none of them work
+    private static func buildSlots(for words: [[UInt8]]) -> ([Int], UInt32) {
+        var size = 8
+        while size < words.count * 2 {
+            size <<= 1
+        }
+
+        while true {
+            for seed in UInt32(0)..<1024 {
+                var slots = [Int](repeating: -1, count: size)
+                var collided = false
+                for (index, word) in words.enumerated() {
+                    var hash = initialHash(seed: seed)
+                    for byte in word {
+                        hash = self.hash(hash, byte: byte)
+                    }
+                    let slot = self.slot(for: hash, mask: size - 1)
+                    guard slots[slot] < 0 else {
+                        collided = true
+                        break
+                    }
+                    slots[slot] = index
+                }
+                if !collided {
+                    return (slots, seed)
+                }
+            }
+            size <<= 1
+        }
+    }
+
+    private static func initialHash(seed: UInt32) -> UInt32 {
+        // FNV-1a offset basis, perturbed by the seed
+        return 2_166_136_261 ^ (seed &* 0x9E37_79B9)
+    }
+
+    @inline(__always)
+    private static func slot(for hash: UInt32, mask: Int) -> Int {
+        return Int(truncatingIfNeeded: hash ^ (hash >> 16)) & mask
+    }
+
+    @inline(__always)
+    private static func lowercased(_ byte: UInt8) -> UInt8 {
+        return byte >= 0x41 && byte <= 0x5A ? byte | 0x20 : byte
+    }
+}
@@ -8,43 +8,135 @@ import UIKit
 
 class SSDCreditCardOcr: CreditCardOcrImplementation {
     let ocr: OcrDD
+    /// Skips running the model on frames without a card and on near duplicates of the last frame it ran on
+    let gate = FrameGate()
+    /// Decides whether `OcrMainLoop` should hand this analyzer one frame or several at a time
+    let batchingPolicy: SSDOcrBatchingPolicy
+    /// The number read from the last frame the model ran on, for frames that `gate` says are duplicates.
+    /// Predictions for those frames are marked `isReused` so that they aren't counted as new reads.
+    private var lastNumber: String?
+    private var lastNumberBoxes: [CGRect] = []
 
-    override init(
-        dispatchQueueLabel: String
+    override var instrumentation: ScanInstrumentation {
+        didSet { ocr.ssdOcr.instrumentation = instrumentation }
+    }
+
+    override var frameGateStatistics: FrameGateStatistics? {
+        return gate.statistics
+    }
+
+    override var maxBatchSize: Int {
+        return batchingPolicy.maxBatchSize
+    }
+
+    override var preferredBatchSize: Int {
+        return batchingPolicy.batchSize
+    }
+
+    init(
+        dispatchQueueLabel: String,
+        maxBatchSize: Int = 2
     ) {
         ocr = OcrDD()
+        batchingPolicy = SSDOcrBatchingPolicy(maxBatchSize: maxBatchSize)
         super.init(dispatchQueueLabel: dispatchQueueLabel)
+        ocr.ssdOcr.instrumentation = instrumentation
     }
 
     override func recognizeCard(
         in fullImage: CGImage,
         roiRectangle: CGRect
     ) -> CreditCardOcrPrediction {
+        return recognizeCards(in: [(image: fullImage, roiRectangle: roiRectangle)])[0]
+    }
 
-        guard
-            let (image, ocrRoiRectangle) = fullImage.croppedImageForSsd(roiRectangle: roiRectangle)
-        else {
-            return CreditCardOcrPrediction.emptyPrediction(cgImage: fullImage)
+    override func recognizeCards(
+        in frames: [(image: CGImage, roiRectangle: CGRect)],
+        completion: @escaping ([CreditCardOcrPrediction]) -> Void
+    ) {
+        completion(recognizeCards(in: frames))
+    }
+
+    /// Crops and gates every frame first, so that all of the frames worth analyzing go through the model
+    /// in one prediction
+    private func recognizeCards(
+        in frames: [(image: CGImage, roiRectangle: CGRect)]
+    ) -> [CreditCardOcrPrediction] {
+        let crops = frames.map { frame -> (image: CGImage, roiRectangle: CGRect, decision: FrameGateDecision)? in
+            guard !isCancelled,
+                let (image, ocrRoiRectangle) = frame.image.croppedImageForSsd(roiRectangle: frame.roiRectangle)
+            else {
+                return nil
+            }
+            let decision = instrumentation.measure(.gating) {
+                gate.decision(for: image, cardState: latestCardState)
+            }
+            return (image, ocrRoiRectangle, decision)
         }
 
-        let startTime = Date()
-        let number = ocr.perform(croppedCardImage: image)
-        let duration = -startTime.timeIntervalSinceNow
-        let numberBoxes = ocr.lastDetectedBoxes
-
-        self.computationTime += duration
-        self.frames += 1
-        return CreditCardOcrPrediction(
-            image: image,
-            ocrCroppingRectangle: ocrRoiRectangle,
-            number: number,
-            expiryMonth: nil,
-            expiryYear: nil,
-            name: nil,
-            computationTime: duration,
-            numberBoxes: numberBoxes,
-            expiryBoxes: nil,
-            nameBoxes: nil
-        )
+        let analyzedImages = crops.compactMap { crop in crop?.decision == .analyze ? crop?.image : nil }
+        var results: [(number: String?, boxes: [CGRect])] = []
+        var frameDuration = 0.0
+        if !analyzedImages.isEmpty {
+            let startTime = Date()
+            if analyzedImages.count == 1 {
+                let number = ocr.perform(croppedCardImage: analyzedImages[0])
+                results = [(number, ocr.lastDetectedBoxes)]
+            } else {
+                results = ocr.perform(croppedCardImages: analyzedImages)
+            }
+            let duration = -startTime.timeIntervalSinceNow
+            frameDuration = duration / Double(analyzedImages.count)
+
+            self.computationTime += duration
+            self.frames += analyzedImages.count
+            batchingPolicy.record(
+                frames: analyzedImages.count,
+                latency: duration,
+                foundCard: latestCardState?.hasCard() ?? results.contains { $0.number != nil }
+            )
+        }
+
+        var nextResult = results.makeIterator()
+        return zip(frames, crops).map { frame, crop in
+            guard let crop = crop else {
+                return CreditCardOcrPrediction.emptyPrediction(cgImage: frame.image)
+            }
+
+            let number: String?
+            let numberBoxes: [CGRect]
+            let duration: TimeInterval
+            switch crop.decision {
+            case .skipNoCard:
+                number = nil
+                numberBoxes = []
+                duration = 0.0
+            case .reuseLast:
+                number = lastNumber
+                numberBoxes = lastNumberBoxes
+                duration = 0.0
+            case .analyze:
+                let result = nextResult.next()
+                number = result?.number
+                numberBoxes = result?.boxes ?? []
+                duration = frameDuration
+                lastNumber = number
+                lastNumberBoxes = numberBoxes
+            }
+
+            return CreditCardOcrPrediction(
+                image: crop.image,
+                ocrCroppingRectangle: crop.roiRectangle,
+                number: number,
+                expiryMonth: nil,
+                expiryYear: nil,
+                name: nil,
+                computationTime: duration,
+                numberBoxes: numberBoxes,
+                expiryBoxes: nil,
+                nameBoxes: nil,
+                isReused: crop.decision == .reuseLast
+            )
+        }
     }
 }
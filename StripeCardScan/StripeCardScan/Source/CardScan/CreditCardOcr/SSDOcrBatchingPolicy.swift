@@ -0,0 +1,125 @@
+//
+//  SSDOcrBatchingPolicy.swift
+//  StripeCardScan
+//
+//  Created by Stripe on 10/17/26.
+//
+
+import Foundation
+
+/// Decides how many frames `SSDCreditCardOcr` runs through the model at once.
+///
+/// A batched prediction amortizes CoreML's per call overhead and keeps the Neural Engine or GPU busy, but
+/// whether that makes each frame cheaper depends on the device, and every frame in a batch waits for the
+/// whole batch. So the policy:
+/// - runs single frames for `latencySensitiveDuration` after a card appears, since the user is waiting on
+///   those first reads
+/// - otherwise measures the per frame latency of both modes and batches only while batching is faster,
+///   trying a batch again every `probeInterval` single frames in case that changed, e.g. as the device
+///   heats up
+///
+/// Batches are only as big as the frames that are waiting, so they only form when the model can't keep up
+/// with the camera. The policy isn't thread safe, `SSDCreditCardOcr` only uses it from its own queue.
+final class SSDOcrBatchingPolicy {
+    /// The most frames to run at once, 1 turns batching off
+    let maxBatchSize: Int
+    /// How long after a card appears to keep running single frames
+    let latencySensitiveDuration: TimeInterval
+    /// Weight of the newest measurement in the moving averages
+    let smoothing: Double
+    /// Measurements each mode needs before the policy trusts its average
+    let minimumSamples: Int
+    /// Single frames to run before trying a batch again, once batching measured slower
+    let probeInterval: Int
+
+    /// Moving average of the per frame latency of single frame predictions
+    private(set) var singleFrameLatency = 0.0
+    private(set) var singleFrameSamples = 0
+    /// Moving average of the per frame latency of batched predictions
+    private(set) var batchedFrameLatency = 0.0
+    private(set) var batchedSamples = 0
+
+    private var cardAppearedAt: Date?
+    private var cardLastSeenAt: Date?
+    private var singleFramesSinceBatch = 0
+    private let now: () -> Date
+
+    init(
+        maxBatchSize: Int = 2,
+        latencySensitiveDuration: TimeInterval = 1.0,
+        smoothing: Double = 0.2,
+        minimumSamples: Int = 5,
+        probeInterval: Int = 50,
+        now: @escaping () -> Date = { Date() }
+    ) {
+        self.maxBatchSize = max(maxBatchSize, 1)
+        self.latencySensitiveDuration = latencySensitiveDuration
+        self.smoothing = smoothing
+        self.minimumSamples = minimumSamples
+        self.probeInterval = probeInterval
+        self.now = now
+    }
+
+    /// How many frames to run through the model next
+    var batchSize: Int {
+        guard maxBatchSize > 1 else {
+            return 1
+        }
+
+        if let cardAppearedAt = cardAppearedAt,
+            now().timeIntervalSince(cardAppearedAt) < latencySensitiveDuration
+        {
+            return 1
+        }
+
+        // measure single frames first, then batches, so that there's something to compare
+        guard singleFrameSamples >= minimumSamples else {
+            return 1
+        }
+        guard batchedSamples >= minimumSamples else {
+            return maxBatchSize
+        }
+
+        if batchedFrameLatency < singleFrameLatency || singleFramesSinceBatch >= probeInterval {
+            return maxBatchSize
+        }
+        return 1
+    }
+
+    /// Records a prediction over `frames` frames that took `latency` in total
+    ///
+    /// - Parameter foundCard: Whether any of the frames had a card in them. A card that shows up after
+    ///   none was seen for `latencySensitiveDuration` counts as a new card.
+    func record(frames: Int, latency: TimeInterval, foundCard: Bool) {
+        guard frames > 0 else {
+            return
+        }
+
+        let frameLatency = latency / Double(frames)
+        if frames > 1 {
+            batchedFrameLatency = average(batchedFrameLatency, frameLatency, samples: batchedSamples)
+            batchedSamples += 1
+            singleFramesSinceBatch = 0
+        } else {
+            singleFrameLatency = average(singleFrameLatency, frameLatency, samples: singleFrameSamples)
+            singleFrameSamples += 1
+            singleFramesSinceBatch += 1
+        }
+
+        guard foundCard else {
+            return
+        }
+        let currentTime = now()
+        if cardLastSeenAt.map({ currentTime.timeIntervalSince($0) >= latencySensitiveDuration }) ?? true {
+            cardAppearedAt = currentTime
+        }
+        cardLastSeenAt = currentTime
+    }
+
+    private func average(_ average: Double, _ value: Double, samples: Int) -> Double {
+        guard samples > 0 else {
+            return value
+        }
+        return average + smoothing * (value - average)
+    }
+}
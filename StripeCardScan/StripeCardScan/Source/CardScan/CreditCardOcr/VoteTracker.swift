@@ -0,0 +1,107 @@
+//
+//  VoteTracker.swift
+//  StripeCardScan
+//
+//  Created by Stripe on 10/17/26.
+//
+
+import Foundation
+
+/// How far the leading candidate in a `VoteTracker` is ahead of the rest
+struct VoteConfidence: Equatable {
+    var leaderVotes = 0.0
+    var runnerUpVotes = 0.0
+    var totalVotes = 0.0
+
+    /// The leader's lead over the runner up as a fraction of all votes, from 0 (tied) to 1 (the
+    /// only candidate)
+    var margin: Double {
+        guard totalVotes > 0 else { return 0 }
+        return (leaderVotes - runnerUpVotes) / totalVotes
+    }
+}
+
+/// Counts votes for OCR candidates frame by frame and keeps the leader up to date as it goes, so
+/// finding the most voted candidate doesn't need a sort.
+///
+/// With a `decay` below 1, every vote is worth `1 / decay` times the previous one, which is the
+/// same as multiplying all older votes by `decay` on each frame. Because every candidate decays by
+/// the same factor the leader never changes from decay alone, so the tracker only has to rescale
+/// its counts once the weights get large instead of touching every candidate on every frame.
+///
+/// Ties go to the candidate that reached the count first.
+struct VoteTracker<Candidate: Hashable> {
+    /// Weight of older votes relative to the newest frame, in `(0, 1]`. 1 disables decay.
+    let decay: Double
+
+    private(set) var leader: Candidate?
+    private var votes: [Candidate: Double] = [:]
+    private var leaderVotes = 0.0
+    private var runnerUpVotes = 0.0
+    private var totalVotes = 0.0
+    private var weight = 1.0
+
+    init(
+        decay: Double = 1.0
+    ) {
+        self.decay = min(max(decay, .leastNonzeroMagnitude), 1.0)
+    }
+
+    /// The number of distinct candidates that got a vote
+    var count: Int {
+        return votes.count
+    }
+
+    var isEmpty: Bool {
+        return votes.isEmpty
+    }
+
+    /// Vote counts relative to the most recent frame, where one vote in that frame counts as 1
+    var confidence: VoteConfidence {
+        return VoteConfidence(
+            leaderVotes: leaderVotes / weight,
+            runnerUpVotes: runnerUpVotes / weight,
+            totalVotes: totalVotes / weight
+        )
+    }
+
+    /// The decayed votes for `candidate`, relative to the most recent frame
+    func votes(for candidate: Candidate) -> Double {
+        return (votes[candidate] ?? 0) / weight
+    }
+
+    /// Moves on to the next frame, decaying all of the votes so far
+    mutating func nextFrame() {
+        guard decay < 1.0 else { return }
+        weight /= decay
+        if weight > 1e100 {
+            rescale()
+        }
+    }
+
+    mutating func vote(for candidate: Candidate) {
+        let count = (votes[candidate] ?? 0) + weight
+        votes[candidate] = count
+        totalVotes += weight
+
+        if candidate == leader {
+            leaderVotes = count
+        } else if count > leaderVotes {
+            // votes only go up, so the old leader is now the runner up
+            runnerUpVotes = leaderVotes
+            leader = candidate
+            leaderVotes = count
+        } else if count > runnerUpVotes {
+            runnerUpVotes = count
+        }
+    }
+
+    private mutating func rescale() {
+        let scale = weight
+        votes = votes.mapValues { $0 / scale }
+        leaderVotes /= scale
+        runnerUpVotes /= scale
+        totalVotes /= scale
+        weight = 1.0
+    }
+}
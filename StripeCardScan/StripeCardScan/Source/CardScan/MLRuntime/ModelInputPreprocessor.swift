@@ -0,0 +1,110 @@
+//
+//  ModelInputPreprocessor.swift
+//  StripeCardScan
+//
+//  Created by Stripe on 10/17/26.
+//
+
+import Accelerate
+import CoreGraphics
+import CoreVideo
+import Foundation
+
+/// Turns a cropped camera frame into a model input with vImage, without going through `UIImage`.
+///
+/// `UIImage.pixelBuffer(width:height:)` creates a new pixel buffer and redraws the image through
+/// CoreGraphics for every frame. This instead converts the crop once into a reusable ARGB buffer
+/// and scales it straight into a buffer from a `PixelBufferPool`. Since `CGImage.cropping(to:)`
+/// only references the original frame, only the pixels inside the crop are ever read.
+///
+/// Instances keep scratch memory between frames and are not thread safe, so each analyzer owns its
+/// own preprocessor and only uses it from its own queue.
+final class ModelInputPreprocessor {
+    private var format = vImage_CGImageFormat(
+        bitsPerComponent: 8,
+        bitsPerPixel: 32,
+        colorSpace: nil,
+        bitmapInfo: CGBitmapInfo(rawValue: CGImageAlphaInfo.noneSkipFirst.rawValue),
+        version: 0,
+        decode: nil,
+        renderingIntent: .defaultIntent
+    )
+
+    private var source: UnsafeMutableRawPointer?
+    private var sourceCapacity = 0
+    private var temporary: UnsafeMutableRawPointer?
+    private var temporaryCapacity = 0
+
+    deinit {
+        source?.deallocate()
+        temporary?.deallocate()
+    }
+
+    /// Scales `image` to the size of `pool`'s buffers and returns it as a 32ARGB pixel buffer
+    func pixelBuffer(from image: CGImage, pool: PixelBufferPool) -> CVPixelBuffer? {
+        guard image.width > 0, image.height > 0,
+            let pixelBuffer = pool.makePixelBuffer()
+        else {
+            return nil
+        }
+
+        // convert the crop into our ARGB scratch buffer, reusing it if it's big enough
+        let sourceRowBytes = image.width * 4
+        let sourceBytes = sourceRowBytes * image.height
+        if sourceBytes > sourceCapacity {
+            source?.deallocate()
+            source = UnsafeMutableRawPointer.allocate(byteCount: sourceBytes, alignment: 16)
+            sourceCapacity = sourceBytes
+        }
+        var sourceBuffer = vImage_Buffer(
+            data: source,
+            height: vImagePixelCount(image.height),
+            width: vImagePixelCount(image.width),
+            rowBytes: sourceRowBytes
+        )
+        var error = vImageBuffer_InitWithCGImage(
+            &sourceBuffer,
+            &format,
+            nil,
+            image,
+            vImage_Flags(kvImageNoAllocate)
+        )
+        guard error == kvImageNoError else {
+            return nil
+        }
+
+        CVPixelBufferLockBaseAddress(pixelBuffer, CVPixelBufferLockFlags(rawValue: 0))
+        defer { CVPixelBufferUnlockBaseAddress(pixelBuffer, CVPixelBufferLockFlags(rawValue: 0)) }
+        var destinationBuffer = vImage_Buffer(
+            data: CVPixelBufferGetBaseAddress(pixelBuffer),
+            height: vImagePixelCount(CVPixelBufferGetHeight(pixelBuffer)),
+            width: vImagePixelCount(CVPixelBufferGetWidth(pixelBuffer)),
+            rowBytes: CVPixelBufferGetBytesPerRow(pixelBuffer)
+        )
+
+        // vImage would otherwise allocate its own temporary buffer on every call
+        let temporaryBytes = vImageScale_ARGB8888(
+            &sourceBuffer,
+            &destinationBuffer,
+            nil,
+            vImage_Flags(kvImageGetTempBufferSize)
+        )
+        if temporaryBytes > temporaryCapacity {
+            temporary?.deallocate()
+            temporary = UnsafeMutableRawPointer.allocate(byteCount: temporaryBytes, alignment: 16)
+            temporaryCapacity = temporaryBytes
+        }
+
+        error = vImageScale_ARGB8888(
+            &sourceBuffer,
+            &destinationBuffer,
+            temporary,
+            vImage_Flags(kvImageNoFlags)
+        )
+        guard error == kvImageNoError else {
+            return nil
+        }
+
+        return pixelBuffer
+    }
+}
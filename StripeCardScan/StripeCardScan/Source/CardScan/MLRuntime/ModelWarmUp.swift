@@ -0,0 +1,126 @@
+//
+//  ModelWarmUp.swift
+//  StripeCardScan
+//
+//  Created by Stripe on 10/17/26.
+//
+
+import CoreML
+import Foundation
+import UIKit
+
+/// How long each step of `ModelWarmUp` took, in seconds
+struct ModelWarmUpTimings {
+    /// Loading and compiling the models from the bundle
+    var ssdOcrLoad: TimeInterval = 0.0
+    var uxModelLoad: TimeInterval = 0.0
+    /// The first inference, which includes any lazy setup CoreML does on first use
+    var ssdOcrColdInference: TimeInterval = 0.0
+    var uxModelColdInference: TimeInterval = 0.0
+    /// A second inference, what a frame costs once the models are warm
+    var ssdOcrWarmInference: TimeInterval = 0.0
+    var uxModelWarmInference: TimeInterval = 0.0
+
+    func toDictionaryForAnalytics() -> [String: Any] {
+        return [
+            "ssd_ocr_load": ssdOcrLoad,
+            "ux_model_load": uxModelLoad,
+            "ssd_ocr_cold_inference": ssdOcrColdInference,
+            "ux_model_cold_inference": uxModelColdInference,
+            "ssd_ocr_warm_inference": ssdOcrWarmInference,
+            "ux_model_warm_inference": uxModelWarmInference,
+        ]
+    }
+}
+
+/// Loads the card scan models ahead of time so that the first frame of a scan doesn't pay for
+/// loading, compiling and initializing them.
+///
+/// Warming up happens once per process on a background queue. The loaded models are kept here and
+/// picked up by `SSDOcrDetect` and `UxAnalyzer` instead of loading their own copies.
+final class ModelWarmUp {
+    static let shared = ModelWarmUp()
+
+    @AtomicProperty private(set) var ssdOcrModel: SSDOcr?
+    @AtomicProperty private(set) var uxModel: UxModel?
+    /// `nil` until warming up finishes
+    @AtomicProperty private(set) var timings: ModelWarmUpTimings?
+
+    private let queue = DispatchQueue(label: "CardScan model warm up", qos: .utility)
+
+    /// Loads both models, primes the SSD prior table and the input pixel buffer pools, and runs two
+    /// dummy inferences per model.
+    /// Calling this again after the first time only reports the timings from the first time.
+    ///
+    /// - Parameter completion: Called on a background queue once the models are warm
+    func warmUp(completion: ((ModelWarmUpTimings) -> Void)? = nil) {
+        queue.async {
+            if let timings = self.timings {
+                completion?(timings)
+                return
+            }
+
+            var timings = ModelWarmUpTimings()
+            let preprocessor = ModelInputPreprocessor()
+            SSDOcrDetect.initializeModels()
+
+            var startTime = Date()
+            let ssdOcrModel = SSDOcrDetect.loadModelFromBundle()
+            timings.ssdOcrLoad = -startTime.timeIntervalSinceNow
+            self.ssdOcrModel = ssdOcrModel
+
+            startTime = Date()
+            let uxModel = UxAnalyzer.loadModelFromBundle()
+            timings.uxModelLoad = -startTime.timeIntervalSinceNow
+            self.uxModel = uxModel
+
+            // the dummy inputs come from the shared pools so that their first buffers are allocated
+            // before the first real frame
+            if let ssdOcrModel = ssdOcrModel,
+                let image = ModelWarmUp.blankImage(
+                    width: SSDOcrDetect.imageWidth,
+                    height: SSDOcrDetect.imageHeight
+                ).cgImage,
+                let pixelBuffer = preprocessor.pixelBuffer(from: image, pool: .ssdOcrInput)
+            {
+                let input = SSDOcrInput(_0: pixelBuffer)
+                timings.ssdOcrColdInference = ModelWarmUp.time { _ = try? ssdOcrModel.prediction(input: input) }
+                timings.ssdOcrWarmInference = ModelWarmUp.time { _ = try? ssdOcrModel.prediction(input: input) }
+            }
+
+            if let uxModel = uxModel,
+                let image = ModelWarmUp.blankImage(
+                    width: UxAnalyzer.imageSize,
+                    height: UxAnalyzer.imageSize
+                ).cgImage,
+                let pixelBuffer = preprocessor.pixelBuffer(from: image, pool: .uxModelInput)
+            {
+                timings.uxModelColdInference = ModelWarmUp.time { _ = try? uxModel.prediction(input1: pixelBuffer) }
+                timings.uxModelWarmInference = ModelWarmUp.time { _ = try? uxModel.prediction(input1: pixelBuffer) }
+            }
+
+            self.timings = timings
+            completion?(timings)
+        }
+    }
+
+    /// A white image to run dummy inferences on
+    static func blankImage(width: Int, height: Int) -> UIImage {
+        let format = UIGraphicsImageRendererFormat()
+        format.scale = 1.0
+        let renderer = UIGraphicsImageRenderer(
+            size: CGSize(width: width, height: height),
+            format: format
+        )
+        return renderer.image { context in
+            UIColor.white.setFill()
+            context.fill(CGRect(x: 0, y: 0, width: width, height: height))
+        }
+    }
+
+    private static func time(_ block: () -> Void) -> TimeInterval {
+        let startTime = Date()
+        block()
+        return -startTime.timeIntervalSinceNow
+    }
+}
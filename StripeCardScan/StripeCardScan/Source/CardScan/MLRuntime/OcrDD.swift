@@ -19,9 +19,21 @@ class OcrDD {
     }
 
     func perform(croppedCardImage: CGImage) -> String? {
-        let number = ssdOcr.predict(image: UIImage(cgImage: croppedCardImage))
+        let number = ssdOcr.predict(cgImage: croppedCardImage)
         self.lastDetectedBoxes = ssdOcr.lastDetectedBoxes
         return number
     }
 
+    /// Reads the frames in one batched prediction, or one frame at a time if the batch can't run
+    func perform(croppedCardImages: [CGImage]) -> [(number: String?, boxes: [CGRect])] {
+        let batchResults = croppedCardImages.count > 1 ? ssdOcr.predict(cgImages: croppedCardImages) : nil
+        let results =
+            batchResults
+            ?? croppedCardImages.map { image in
+                (number: ssdOcr.predict(cgImage: image), boxes: ssdOcr.lastDetectedBoxes)
+            }
+        self.lastDetectedBoxes = ssdOcr.lastDetectedBoxes
+        return results
+    }
+
 }
@@ -0,0 +1,72 @@
+//
+//  PixelBufferPool.swift
+//  StripeCardScan
+//
+//  Created by Stripe on 10/17/26.
+//
+
+import CoreVideo
+import Foundation
+
+/// A `CVPixelBufferPool` of fixed size 32ARGB buffers for model inputs.
+///
+/// Buffers are recycled once CoreML and the caller release them, so after the first few frames
+/// preparing a model input doesn't allocate. The buffers are IOSurface backed so that CoreML can
+/// hand them to the GPU or Neural Engine without copying. `CVPixelBufferPool` is thread safe, so the
+/// shared pools can be used from every analyzer queue.
+final class PixelBufferPool {
+    static let ssdOcrInput = PixelBufferPool(
+        width: SSDOcrDetect.imageWidth,
+        height: SSDOcrDetect.imageHeight
+    )
+    static let uxModelInput = PixelBufferPool(
+        width: UxAnalyzer.imageSize,
+        height: UxAnalyzer.imageSize
+    )
+
+    let width: Int
+    let height: Int
+    private let pool: CVPixelBufferPool?
+
+    init(
+        width: Int,
+        height: Int,
+        minimumBufferCount: Int = 3
+    ) {
+        self.width = width
+        self.height = height
+
+        let poolAttributes: [CFString: Any] = [
+            kCVPixelBufferPoolMinimumBufferCountKey: minimumBufferCount
+        ]
+        let pixelBufferAttributes: [CFString: Any] = [
+            kCVPixelBufferPixelFormatTypeKey: kCVPixelFormatType_32ARGB,
+            kCVPixelBufferWidthKey: width,
+            kCVPixelBufferHeightKey: height,
+            kCVPixelBufferCGImageCompatibilityKey: true,
+            kCVPixelBufferCGBitmapContextCompatibilityKey: true,
+            kCVPixelBufferIOSurfacePropertiesKey: [:] as [CFString: Any],
+        ]
+        var pool: CVPixelBufferPool?
+        CVPixelBufferPoolCreate(
+            kCFAllocatorDefault,
+            poolAttributes as CFDictionary,
+            pixelBufferAttributes as CFDictionary,
+            &pool
+        )
+        self.pool = pool
+    }
+
+    func makePixelBuffer() -> CVPixelBuffer? {
+        guard let pool = pool else {
+            return nil
+        }
+
+        var pixelBuffer: CVPixelBuffer?
+        let status = CVPixelBufferPoolCreatePixelBuffer(kCFAllocatorDefault, pool, &pixelBuffer)
+        guard status == kCVReturnSuccess else {
+            return nil
+        }
+        return pixelBuffer
+    }
+}
@@ -7,6 +7,15 @@ import Foundation
 /// that it uses are non-maximum suppression and depth first search on box
 /// sequences to find likely numbers. There are also a number of heuristics
 /// for filtering out unlikely sequences.
+///
+/// Each card layout is described by a `NumberLayout`. `numbers(for:)` searches
+/// for several layouts in one pass: the boxes go into a single occupancy bitset,
+/// each distinct combine step runs once and is shared by the layouts that use it,
+/// and the spacing heuristics prune the depth first search as lines are built
+/// rather than filtering complete lines afterwards. Adding a card layout only
+/// needs a new `NumberLayout`.
+///
+/// Like the original search, every list of lines starts with an empty line.
 struct PostDetectionAlgorithm {
     let kNumberWordCount = 4
     let kAmexWordCount = 5
@@ -16,6 +25,33 @@ struct PostDetectionAlgorithm {
     let kDeltaRowForHorizontalNumbers = 1
     let kDeltaColForVerticalNumbers = 1
 
+    /// A card number layout: which way the groups of digits run, how many groups there are, how
+    /// close boxes get combined before searching, and how evenly the groups must be spaced
+    struct NumberLayout {
+        enum Axis {
+            /// Groups left to right, e.g. a traditional 16 digit card
+            case horizontal
+            /// Groups top to bottom, e.g. Visa quick read
+            case vertical
+        }
+
+        enum Spacing {
+            /// The gaps between groups differ by at most `maxSpread`
+            case even(maxSpread: Int)
+            /// Every other gap is at least twice as wide as the one after it, like the 4 6 5
+            /// clusters on Amex cards where we find two boxes in each of the 6 and 5 clusters
+            case alternatingWideNarrow
+        }
+
+        let axis: Axis
+        let wordCount: Int
+        let combineDeltaRow: Int
+        let combineDeltaCol: Int
+        /// How far off of the line's axis the next group can be
+        let crossAxisTolerance: Int
+        let spacing: Spacing
+    }
+
     let sortedBoxes: [DetectedBox]
     let numRows: Int
     let numCols: Int
@@ -35,40 +71,49 @@ struct PostDetectionAlgorithm {
         self.numCols = (self.sortedBoxes.map { $0.col }.max() ?? 0) + 1
     }
 
-    /// Finds traditional numbers that are horizontal on a 16 digit card.
-    func horizontalNumbers() -> [[DetectedBox]] {
-        let boxes = self.combineCloseBoxes(
-            deltaRow: kDeltaRowForCombine,
-            deltaCol: kDeltaColForCombine
-        )
-        let lines = self.findHorizontalNumbers(words: boxes, numberOfBoxes: kNumberWordCount)
+    // MARK: - Layouts
 
-        // boxes should be roughly evenly spaced, reject any that aren't
-        return lines.filter { line in
-            let deltas = zip(line, line.dropFirst()).map { box, nextBox in nextBox.col - box.col }
-            let maxDelta = deltas.max() ?? 0
-            let minDelta = deltas.min() ?? 0
+    var horizontalLayout: NumberLayout {
+        return NumberLayout(
+            axis: .horizontal,
+            wordCount: kNumberWordCount,
+            combineDeltaRow: kDeltaRowForCombine,
+            combineDeltaCol: kDeltaColForCombine,
+            crossAxisTolerance: kDeltaRowForHorizontalNumbers,
+            spacing: .even(maxSpread: 2)
+        )
+    }
 
-            return (maxDelta - minDelta) <= 2
-        }
+    var verticalLayout: NumberLayout {
+        return NumberLayout(
+            axis: .vertical,
+            wordCount: kNumberWordCount,
+            combineDeltaRow: kDeltaRowForCombine,
+            combineDeltaCol: kDeltaColForCombine,
+            crossAxisTolerance: kDeltaColForVerticalNumbers,
+            spacing: .even(maxSpread: 2)
+        )
     }
 
-    /// Used for Visa quick read where the digits are in groups of four but organized veritcally
-    func verticalNumbers() -> [[DetectedBox]] {
-        let boxes = self.combineCloseBoxes(
-            deltaRow: kDeltaRowForCombine,
-            deltaCol: kDeltaColForCombine
+    var amexLayout: NumberLayout {
+        return NumberLayout(
+            axis: .horizontal,
+            wordCount: kAmexWordCount,
+            combineDeltaRow: kDeltaRowForCombine,
+            combineDeltaCol: 1,
+            crossAxisTolerance: kDeltaRowForHorizontalNumbers,
+            spacing: .alternatingWideNarrow
         )
-        let lines = self.findVerticalNumbers(words: boxes, numberOfBoxes: kNumberWordCount)
+    }
 
-        // boxes should be roughly evenly spaced, reject any that aren't
-        return lines.filter { line in
-            let deltas = zip(line, line.dropFirst()).map { box, nextBox in nextBox.row - box.row }
-            let maxDelta = deltas.max() ?? 0
-            let minDelta = deltas.min() ?? 0
+    /// Finds traditional numbers that are horizontal on a 16 digit card.
+    func horizontalNumbers() -> [[DetectedBox]] {
+        return numbers(for: [horizontalLayout])[0]
+    }
 
-            return (maxDelta - minDelta) <= 2
-        }
+    /// Used for Visa quick read where the digits are in groups of four but organized veritcally
+    func verticalNumbers() -> [[DetectedBox]] {
+        return numbers(for: [verticalLayout])[0]
     }
 
     /// Finds 15 digit horizontal Amex card numbers.
@@ -77,145 +122,231 @@ struct PostDetectionAlgorithm {
     /// digits, but we did design it to detect the groups of four within the clusters of 5 and 6.
     /// Thus, our goal with Amex is to find enough boxes of 4 to cover all of the amex digits.
     func amexNumbers() -> [[DetectedBox]] {
-        let boxes = self.combineCloseBoxes(deltaRow: kDeltaRowForCombine, deltaCol: 1)
-        let lines = self.findHorizontalNumbers(words: boxes, numberOfBoxes: kAmexWordCount)
+        return numbers(for: [amexLayout])[0]
+    }
 
-        return lines.filter { line in
-            let colDeltas = zip(line, line.dropFirst()).map { box, nextBox in nextBox.col - box.col
-            }
+    /// Finds horizontal, vertical and Amex numbers in one pass
+    func allNumbers() -> (horizontal: [[DetectedBox]], vertical: [[DetectedBox]], amex: [[DetectedBox]]) {
+        let lines = numbers(for: [horizontalLayout, verticalLayout, amexLayout])
+        return (lines[0], lines[1], lines[2])
+    }
+
+    /// Finds the lines of boxes for each layout, in the same order as `layouts`
+    func numbers(for layouts: [NumberLayout]) -> [[[DetectedBox]]] {
+        let occupancy = OccupancyGrid(boxes: sortedBoxes, numRows: numRows, numCols: numCols)
+        var combinedWords: [CombineKey: [DetectedBox]] = [:]
+        var searchGraphs: [SearchKey: SearchGraph] = [:]
+
+        return layouts.map { layout -> [[DetectedBox]] in
+            let combineKey = CombineKey(deltaRow: layout.combineDeltaRow, deltaCol: layout.combineDeltaCol)
+            let searchKey = SearchKey(
+                combine: combineKey,
+                axis: layout.axis,
+                crossAxisTolerance: layout.crossAxisTolerance
+            )
 
-            // we have roughly evenly spaced clusters. A single box of four, a cluster of 6 and then
-            // a cluster of 5. We try to recognize the first and last few digits of the 5 and 6
-            // cluster, and the 5 and 6 cluster are roughly evenly spaced but the boxes within
-            // are close
-            let evenColDeltas = colDeltas.enumerated().filter { $0.0 % 2 == 0 }.map { $0.1 }
-            let oddColDeltas = colDeltas.enumerated().filter { $0.0 % 2 == 1 }.map { $0.1 }
-            let evenOddDeltas = zip(evenColDeltas, oddColDeltas).map { even, odd in
-                Double(even) / Double(odd)
+            if searchGraphs[searchKey] == nil {
+                if combinedWords[combineKey] == nil {
+                    combinedWords[combineKey] = combineCloseBoxes(occupancy: occupancy, key: combineKey)
+                }
+                searchGraphs[searchKey] = SearchGraph(
+                    words: combinedWords[combineKey] ?? [],
+                    axis: layout.axis,
+                    tolerance: layout.crossAxisTolerance
+                )
             }
+            let graph = searchGraphs[searchKey]!
 
-            return evenOddDeltas.reduce(true) { $0 && $1 >= 2.0 }
+            return graph.lines(wordCount: layout.wordCount, spacing: layout.spacing)
         }
     }
 
+    // MARK: - Combining close boxes
+
+    private struct CombineKey: Hashable {
+        let deltaRow: Int
+        let deltaCol: Int
+    }
+
     /// Combine close boxes favoring high confidence boxes.
     func combineCloseBoxes(deltaRow: Int, deltaCol: Int) -> [DetectedBox] {
-        var cardGrid: [[Bool]] = Array(
-            repeating: Array(repeating: false, count: self.numCols),
-            count: self.numRows
+        return combineCloseBoxes(
+            occupancy: OccupancyGrid(boxes: sortedBoxes, numRows: numRows, numCols: numCols),
+            key: CombineKey(deltaRow: deltaRow, deltaCol: deltaCol)
         )
+    }
 
-        for box in self.sortedBoxes {
-            cardGrid[box.row][box.col] = true
-        }
+    private func combineCloseBoxes(occupancy: OccupancyGrid, key: CombineKey) -> [DetectedBox] {
+        var grid = occupancy
 
         // since the boxes are sorted by confidence, go through them in order to
         // result in only high confidence boxes winning. There are corner cases
         // where this will leave extra boxes, but that's ok because we don't
         // need to be perfect here
-        for box in self.sortedBoxes {
-            if cardGrid[box.row][box.col] == false {
-                continue
-            }
-            for row in (box.row - deltaRow)...(box.row + deltaRow) {
-                for col in (box.col - deltaCol)...(box.col + deltaCol) {
-                    if row >= 0 && row < numRows && col >= 0 && col < numCols {
-                        cardGrid[row][col] = false
-                    }
-                }
-            }
+        for box in sortedBoxes where grid.contains(row: box.row, col: box.col) {
+            grid.clear(
+                rows: max(box.row - key.deltaRow, 0)...min(box.row + key.deltaRow, numRows - 1),
+                cols: max(box.col - key.deltaCol, 0)...min(box.col + key.deltaCol, numCols - 1)
+            )
             // add this box back
-            cardGrid[box.row][box.col] = true
+            grid.insert(row: box.row, col: box.col)
         }
 
-        return self.sortedBoxes.filter { cardGrid[$0.row][$0.col] }
+        return sortedBoxes.filter { grid.contains(row: $0.row, col: $0.col) }
     }
 
-    /// Find all boxes that form a sequence of four boxes.
-    ///
-    /// Does a depth first search on all boxes to find all boxes that form
-    /// a line with four boxes. The predicate dictates which boxes are added
-    /// so we have a separate prediate for horizontal vs vertical numbers.
-    func findNumbers(
-        currentLine: [DetectedBox],
-        words: [DetectedBox],
-        predicate: ((DetectedBox, DetectedBox) -> Bool),
-        numberOfBoxes: Int,
-        lines: inout [[DetectedBox]]
-    ) {
+    // MARK: - Searching for lines
 
-        if currentLine.count == numberOfBoxes {
-            lines.append(currentLine)
-            return
-        }
+    private struct SearchKey: Hashable {
+        let combine: CombineKey
+        let axis: NumberLayout.Axis
+        let crossAxisTolerance: Int
+    }
 
-        if words.count == 0 {
-            return
-        }
+    /// The words sorted along an axis, with the words that can follow each one in a line worked
+    /// out once and shared by every search over them
+    private struct SearchGraph {
+        let sortedWords: [DetectedBox]
+        /// Position of each word along the axis
+        let positions: [Int]
+        /// Indices of the later words that can follow each word
+        let successors: [[Int]]
+
+        init(
+            words: [DetectedBox],
+            axis: NumberLayout.Axis,
+            tolerance: Int
+        ) {
+            let sortedWords: [DetectedBox]
+            let positions: [Int]
+            let crossPositions: [Int]
+            switch axis {
+            case .horizontal:
+                sortedWords = words.sorted { $0.col < $1.col }
+                positions = sortedWords.map { $0.col }
+                crossPositions = sortedWords.map { $0.row }
+            case .vertical:
+                sortedWords = words.sorted { $0.row < $1.row }
+                positions = sortedWords.map { $0.row }
+                crossPositions = sortedWords.map { $0.col }
+            }
 
-        guard let currentWord = currentLine.last else {
-            return
+            self.sortedWords = sortedWords
+            self.positions = positions
+            self.successors = sortedWords.indices.map { current in
+                (current + 1..<sortedWords.count).filter { next in
+                    positions[next] > positions[current]
+                        && abs(crossPositions[next] - crossPositions[current]) <= tolerance
+                }
+            }
         }
 
-        for (idx, word) in words.enumerated() {
-            if predicate(currentWord, word) {
-                findNumbers(
-                    currentLine: (currentLine + [word]),
-                    words: words.dropFirst(idx + 1).map { $0 },
-                    predicate: predicate,
-                    numberOfBoxes: numberOfBoxes,
+        /// Depth first search for every line of `wordCount` words, in the order the original
+        /// search found them
+        func lines(wordCount: Int, spacing: NumberLayout.Spacing) -> [[DetectedBox]] {
+            var lines: [[DetectedBox]] = [[]]
+            var path: [Int] = []
+            path.reserveCapacity(wordCount)
+            for start in sortedWords.indices {
+                path.append(start)
+                extend(
+                    &path,
+                    wordCount: wordCount,
+                    spacing: spacing,
+                    minDelta: .max,
+                    maxDelta: .min,
+                    lastDelta: 0,
                     lines: &lines
                 )
+                path.removeLast()
             }
+            return lines
         }
-    }
 
-    func verticalAddBoxPredicate(_ currentWord: DetectedBox, _ nextWord: DetectedBox) -> Bool {
-        let deltaCol = kDeltaColForVerticalNumbers
-        return nextWord.row > currentWord.row && nextWord.col >= (currentWord.col - deltaCol)
-            && nextWord.col <= (currentWord.col + deltaCol)
-    }
+        private func extend(
+            _ path: inout [Int],
+            wordCount: Int,
+            spacing: NumberLayout.Spacing,
+            minDelta: Int,
+            maxDelta: Int,
+            lastDelta: Int,
+            lines: inout [[DetectedBox]]
+        ) {
+            if path.count == wordCount {
+                lines.append(path.map { sortedWords[$0] })
+                return
+            }
 
-    func horizontalAddBoxPredicate(_ currentWord: DetectedBox, _ nextWord: DetectedBox) -> Bool {
-        let deltaRow = kDeltaRowForHorizontalNumbers
-        return nextWord.col > currentWord.col && nextWord.row >= (currentWord.row - deltaRow)
-            && nextWord.row <= (currentWord.row + deltaRow)
+            let current = path[path.count - 1]
+            for next in successors[current] {
+                let delta = positions[next] - positions[current]
+                let newMinDelta = min(minDelta, delta)
+                let newMaxDelta = max(maxDelta, delta)
+
+                // prune lines that can't meet the spacing heuristic however they continue
+                switch spacing {
+                case .even(let maxSpread):
+                    if newMaxDelta - newMinDelta > maxSpread { continue }
+                case .alternatingWideNarrow:
+                    // this is the gap at index path.count - 1, odd gaps are compared to the one before
+                    if path.count % 2 == 0 && lastDelta < 2 * delta { continue }
+                }
+
+                path.append(next)
+                extend(
+                    &path,
+                    wordCount: wordCount,
+                    spacing: spacing,
+                    minDelta: newMinDelta,
+                    maxDelta: newMaxDelta,
+                    lastDelta: delta,
+                    lines: &lines
+                )
+                path.removeLast()
+            }
+        }
     }
+}
 
-    // Note: this is simple but inefficient. Since we're dealing with small
-    // lists (eg 20 items) it should be fine
-    func findHorizontalNumbers(words: [DetectedBox], numberOfBoxes: Int) -> [[DetectedBox]] {
-        let sortedWords = words.sorted { $0.col < $1.col }
-        var lines: [[DetectedBox]] = [[]]
+/// Which cells of the row/col grid have a box, one bit per cell
+private struct OccupancyGrid {
+    private var bits: [UInt64]
+    private let numCols: Int
 
-        for (idx, word) in sortedWords.enumerated() {
-            findNumbers(
-                currentLine: [word],
-                words: sortedWords.dropFirst(idx + 1).map { $0 },
-                predicate: horizontalAddBoxPredicate,
-                numberOfBoxes: numberOfBoxes,
-                lines: &lines
-            )
+    init(
+        boxes: [DetectedBox],
+        numRows: Int,
+        numCols: Int
+    ) {
+        self.numCols = numCols
+        self.bits = [UInt64](repeating: 0, count: (numRows * numCols + 63) / 64)
+        for box in boxes {
+            insert(row: box.row, col: box.col)
         }
+    }
 
-        return lines
+    func contains(row: Int, col: Int) -> Bool {
+        let index = row * numCols + col
+        return bits[index >> 6] & (1 << UInt64(index & 63)) != 0
     }
 
-    func findVerticalNumbers(words: [DetectedBox], numberOfBoxes: Int) -> [[DetectedBox]] {
-        let sortedWords = words.sorted { $0.row < $1.row }
-        var lines: [[DetectedBox]] = [[]]
+    mutating func insert(row: Int, col: Int) {
+        let index = row * numCols + col
+        bits[index >> 6] |= 1 << UInt64(index & 63)
+    }
 
-        for (idx, word) in sortedWords.enumerated() {
-            findNumbers(
-                currentLine: [word],
-                words: sortedWords.dropFirst(idx + 1).map { $0 },
-                predicate: verticalAddBoxPredicate,
-                numberOfBoxes: numberOfBoxes,
-                lines: &lines
-            )
+    /// Clears the cells in a rectangle, a run of bits at a time for each row
+    mutating func clear(rows: ClosedRange<Int>, cols: ClosedRange<Int>) {
+        for row in rows {
+            var index = row * numCols + cols.lowerBound
+            let end = row * numCols + cols.upperBound + 1
+            while index < end {
+                let bitOffset = index & 63
+                let count = min(64 - bitOffset, end - index)
+                let mask = count == 64 ? UInt64.max : ((1 << UInt64(count)) - 1) << UInt64(bitOffset)
+                bits[index >> 6] &= ~mask
+                index += count
+            }
         }
-
-        return lines
     }
-
 }
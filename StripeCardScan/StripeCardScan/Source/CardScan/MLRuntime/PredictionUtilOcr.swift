@@ -6,6 +6,7 @@
 //
 
 import Foundation
+@_spi(STP) import StripeCore
 
 struct PredictionUtilOcr {
 
@@ -16,10 +17,7 @@ struct PredictionUtilOcr {
     func predictionUtil(
         scores: [[Float]],
         boxes: [[Float]],
-        probThreshold: Float,
-        iouThreshold: Float,
-        candidateSize: Int,
-        topK: Int
+        probThreshold: Float
     ) -> Result {
         var pickedBoxes = [[Float]]()
         var pickedLabels = [Int]()
@@ -45,8 +43,8 @@ struct PredictionUtilOcr {
                 probs: probs,
                 probThreshold: probThreshold,
                 sigma: SSDOcrDetect.sigma,
-                topK: topK,
-                candidateSize: candidateSize
+                topK: 0,
+                candidateSize: 0
             )
 
             for idx in 0..<_pickedScores.count {
@@ -65,4 +63,54 @@ struct PredictionUtilOcr {
 
     }
 
+    /// Same as `predictionUtil(scores:boxes:...)` but reads the surviving anchors directly out of
+    /// a decoded `SSDOcrDecodeBuffer` and runs Soft-NMS in place on a reusable engine instead of
+    /// rebuilding nested arrays every iteration.
+    func predictionUtil(
+        decoded: SSDOcrDecodeBuffer,
+        probThreshold: Float,
+        engine: NonMaxSuppressionEngine
+    ) -> Result {
+        var result: Result = Result()
+
+        for classIndex in 0..<decoded.numClasses {
+            engine.removeAll()
+            for rowIndex in 0..<decoded.count {
+                let score = decoded.score(at: rowIndex, classIndex: classIndex)
+                if score > probThreshold {
+                    engine.append(
+                        xMin: decoded.xMin[rowIndex],
+                        yMin: decoded.yMin[rowIndex],
+                        xMax: decoded.xMax[rowIndex],
+                        yMax: decoded.yMax[rowIndex],
+                        score: score
+                    )
+                }
+            }
+
+            if engine.count == 0 {
+                continue
+            }
+
+            let pickedIndices = engine.softNMS(
+                decay: .gaussian(sigma: SSDOcrDetect.sigma),
+                scoreThreshold: probThreshold,
+                maxOutputs: 0
+            )
+
+            for (idx, pickedIndex) in pickedIndices.enumerated() {
+                result.pickedBoxProbs.append(engine.selectedScores[idx])
+                result.pickedBoxes.append([
+                    engine.xMin[pickedIndex],
+                    engine.yMin[pickedIndex],
+                    engine.xMax[pickedIndex],
+                    engine.yMax[pickedIndex],
+                ])
+                result.pickedLabels.append((classIndex + 1) % 10)
+            }
+        }
+
+        return result
+    }
+
 }
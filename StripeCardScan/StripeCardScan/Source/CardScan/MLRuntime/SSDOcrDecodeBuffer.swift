@@ -0,0 +1,162 @@
+//
+//  SSDOcrDecodeBuffer.swift
+//  StripeCardScan
+//
+//  Created by Stripe on 10/17/26.
+//
+
+import Accelerate
+import Foundation
+
+/// Structure-of-arrays storage for the SSD OCR anchors that survive the model's `filter` output.
+///
+/// The buffer is allocated once for the full anchor count and then reused for every frame, so
+/// decoding a frame only overwrites the rows that survive filtering and never touches the heap.
+/// Each surviving anchor `i` lives at index `i` of every column, and its class scores are stored
+/// row major at `scores[i * numClasses ..< (i + 1) * numClasses]`.
+///
+/// Instances are not thread safe, each `SSDOcrDetect` owns its own buffer and only uses it from the
+/// analyzer queue that runs its predictions.
+final class SSDOcrDecodeBuffer {
+    private(set) var capacity: Int
+    private(set) var numClasses: Int
+
+    /// The number of anchors that survived filtering for the current frame
+    var count = 0
+
+    /// Index of each surviving anchor into the prior table
+    var anchorIndices: [Int]
+    /// Class scores, `numClasses` per surviving anchor
+    var scores: [Float]
+
+    /// Raw location offsets as produced by the model, in center form
+    var locationX: [Float]
+    var locationY: [Float]
+    var locationWidth: [Float]
+    var locationHeight: [Float]
+
+    /// The prior for each surviving anchor, gathered from `SSDOcrPriorTable`
+    var priorCenterX: [Float]
+    var priorCenterY: [Float]
+    var priorWidth: [Float]
+    var priorHeight: [Float]
+
+    /// Decoded boxes in center form
+    var centerX: [Float]
+    var centerY: [Float]
+    var width: [Float]
+    var height: [Float]
+
+    /// Decoded boxes in corner form, normalized to the model's input size
+    var xMin: [Float]
+    var yMin: [Float]
+    var xMax: [Float]
+    var yMax: [Float]
+
+    init(
+        capacity: Int,
+        numClasses: Int
+    ) {
+        self.capacity = capacity
+        self.numClasses = numClasses
+        self.anchorIndices = [Int](repeating: 0, count: capacity)
+        self.scores = [Float](repeating: 0.0, count: capacity * numClasses)
+        self.locationX = [Float](repeating: 0.0, count: capacity)
+        self.locationY = [Float](repeating: 0.0, count: capacity)
+        self.locationWidth = [Float](repeating: 0.0, count: capacity)
+        self.locationHeight = [Float](repeating: 0.0, count: capacity)
+        self.priorCenterX = [Float](repeating: 0.0, count: capacity)
+        self.priorCenterY = [Float](repeating: 0.0, count: capacity)
+        self.priorWidth = [Float](repeating: 0.0, count: capacity)
+        self.priorHeight = [Float](repeating: 0.0, count: capacity)
+        self.centerX = [Float](repeating: 0.0, count: capacity)
+        self.centerY = [Float](repeating: 0.0, count: capacity)
+        self.width = [Float](repeating: 0.0, count: capacity)
+        self.height = [Float](repeating: 0.0, count: capacity)
+        self.xMin = [Float](repeating: 0.0, count: capacity)
+        self.yMin = [Float](repeating: 0.0, count: capacity)
+        self.xMax = [Float](repeating: 0.0, count: capacity)
+        self.yMax = [Float](repeating: 0.0, count: capacity)
+    }
+
+    /// Makes sure the buffer can hold a frame with the given shape. This only allocates if the
+    /// shape differs from the last frame, which in practice means once per buffer.
+    func reserve(capacity: Int, numClasses: Int) {
+        count = 0
+        guard capacity != self.capacity || numClasses != self.numClasses else {
+            return
+        }
+
+        self.capacity = capacity
+        self.numClasses = numClasses
+        anchorIndices = [Int](repeating: 0, count: capacity)
+        scores = [Float](repeating: 0.0, count: capacity * numClasses)
+        locationX = [Float](repeating: 0.0, count: capacity)
+        locationY = [Float](repeating: 0.0, count: capacity)
+        locationWidth = [Float](repeating: 0.0, count: capacity)
+        locationHeight = [Float](repeating: 0.0, count: capacity)
+        priorCenterX = [Float](repeating: 0.0, count: capacity)
+        priorCenterY = [Float](repeating: 0.0, count: capacity)
+        priorWidth = [Float](repeating: 0.0, count: capacity)
+        priorHeight = [Float](repeating: 0.0, count: capacity)
+        centerX = [Float](repeating: 0.0, count: capacity)
+        centerY = [Float](repeating: 0.0, count: capacity)
+        width = [Float](repeating: 0.0, count: capacity)
+        height = [Float](repeating: 0.0, count: capacity)
+        xMin = [Float](repeating: 0.0, count: capacity)
+        yMin = [Float](repeating: 0.0, count: capacity)
+        xMax = [Float](repeating: 0.0, count: capacity)
+        yMax = [Float](repeating: 0.0, count: capacity)
+    }
+
+    /// Converts the surviving raw locations into corner form boxes using the SSD prior for each
+    /// anchor, the same math as `convertLocationsToBoxes` followed by `centerFormToCornerForm` but
+    /// run as a handful of vector operations over every surviving anchor at once.
+    ///
+    /// The corner columns double as scratch space until the final step overwrites them.
+    func decodeBoxes(
+        centerVariance: Float,
+        sizeVariance: Float
+    ) {
+        guard count > 0 else {
+            return
+        }
+
+        let length = vDSP_Length(count)
+        var expCount = Int32(count)
+        var centerVariance = centerVariance
+        var sizeVariance = sizeVariance
+        var half: Float = 0.5
+        var negativeHalf: Float = -0.5
+
+        // center = location * centerVariance * priorSize + priorCenter
+        vDSP_vsmul(locationX, 1, &centerVariance, &xMin, 1, length)
+        vDSP_vma(xMin, 1, priorWidth, 1, priorCenterX, 1, &centerX, 1, length)
+        vDSP_vsmul(locationY, 1, &centerVariance, &yMin, 1, length)
+        vDSP_vma(yMin, 1, priorHeight, 1, priorCenterY, 1, &centerY, 1, length)
+
+        // size = exp(location * sizeVariance) * priorSize
+        vDSP_vsmul(locationWidth, 1, &sizeVariance, &xMin, 1, length)
+        vvexpf(&xMax, xMin, &expCount)
+        vDSP_vmul(xMax, 1, priorWidth, 1, &width, 1, length)
+        vDSP_vsmul(locationHeight, 1, &sizeVariance, &yMin, 1, length)
+        vvexpf(&yMax, yMin, &expCount)
+        vDSP_vmul(yMax, 1, priorHeight, 1, &height, 1, length)
+
+        // corner = center -/+ size / 2
+        vDSP_vsma(width, 1, &negativeHalf, centerX, 1, &xMin, 1, length)
+        vDSP_vsma(width, 1, &half, centerX, 1, &xMax, 1, length)
+        vDSP_vsma(height, 1, &negativeHalf, centerY, 1, &yMin, 1, length)
+        vDSP_vsma(height, 1, &half, centerY, 1, &yMax, 1, length)
+    }
+
+    /// The class score for the surviving anchor at `index`
+    func score(at index: Int, classIndex: Int) -> Float {
+        return scores[index * numClasses + classIndex]
+    }
+
+    /// The corner form box for the surviving anchor at `index`
+    func box(at index: Int) -> [Float] {
+        return [xMin[index], yMin[index], xMax[index], yMax[index]]
+    }
+}
@@ -6,58 +6,54 @@
 //
 
 import CoreGraphics
+import CoreML
 import Foundation
+@_spi(STP) import StripeCore
 import UIKit
 
 /// Documentation for SSD OCR
 
 @_spi(STP) public class SSDOcrDetect {
     @AtomicProperty var ssdOcrModel: SSDOcr?
-    static var priors: [CGRect]?
 
     static var ssdOcrResource = "SSDOcr"
     static let ssdOcrExtension = "mlmodelc"
 
     // SSD Model parameters
     static let sigma: Float = 0.5
-    let ssdOcrImageWidth = 600
-    let ssdOcrImageHeight = 375
+    static let imageWidth = 600
+    static let imageHeight = 375
+    let ssdOcrImageWidth = SSDOcrDetect.imageWidth
+    let ssdOcrImageHeight = SSDOcrDetect.imageHeight
     let probThreshold: Float = 0.45
     let filterThreshold: Float = 0.39
-    let iouThreshold: Float = 0.5
     let centerVariance: Float = 0.1
     let sizeVariance: Float = 0.2
-    let candidateSize = 200
-    let topK = 20
+
+    // Reused across frames so that decoding the model output doesn't allocate
+    let decodeBuffer = SSDOcrDecodeBuffer(capacity: 3420, numClasses: 10)
+    let nmsEngine = NonMaxSuppressionEngine(capacity: 3420)
+    let preprocessor = ModelInputPreprocessor()
+    /// Options for single frame predictions. Where the OS supports it they carry preallocated output
+    /// arrays, so CoreML writes every frame's scores and boxes into the same memory. Built once the model
+    /// has loaded.
+    private var singleFrameOptions: MLPredictionOptions?
+    /// Options for batched predictions, CoreML allocates the outputs of a batch itself
+    private let batchOptions = MLPredictionOptions()
 
     // Statistics about last prediction
     var lastDetectedBoxes: [CGRect] = []
+    var instrumentation = ScanInstrumentation()
     static var hasPrintedInitError = false
 
     func warmUp() {
         SSDOcrDetect.initializeModels()
-        UIGraphicsBeginImageContext(
-            CGSize(
-                width: ssdOcrImageWidth,
-                height: ssdOcrImageHeight
-            )
-        )
-        UIColor.white.setFill()
-        UIRectFill(
-            CGRect(
-                x: 0,
-                y: 0,
-                width: ssdOcrImageWidth,
-                height: ssdOcrImageHeight
-            )
-        )
-        let newImage = UIGraphicsGetImageFromCurrentImageContext()
-        UIGraphicsEndImageContext()
+        let newImage = ModelWarmUp.blankImage(width: ssdOcrImageWidth, height: ssdOcrImageHeight)
 
         guard let ssdOcrModel = ssdOcrModel else {
             return
         }
-        if let pixelBuffer = newImage?.pixelBuffer(
+        if let pixelBuffer = newImage.pixelBuffer(
             width: ssdOcrImageWidth,
             height: ssdOcrImageHeight
         ) {
@@ -80,20 +76,22 @@ import UIKit
     }
 
     init() {
-        if SSDOcrDetect.priors == nil {
-            SSDOcrDetect.priors = OcrPriorsGen.combinePriors()
-        }
-
+        SSDOcrDetect.initializeModels()
         loadModel()
     }
 
+    /// Builds the shared prior table ahead of the first prediction
     static func initializeModels() {
-        if SSDOcrDetect.priors == nil {
-            SSDOcrDetect.priors = OcrPriorsGen.combinePriors()
-        }
+        _ = SSDOcrPriorTable.shared
     }
 
     private func loadModel() {
+        // reuse the model from `ModelWarmUp` if the app prewarmed it
+        if let model = ModelWarmUp.shared.ssdOcrModel {
+            ssdOcrModel = model
+            return
+        }
+
         guard
             let ssdOcrUrl = StripeCardScanBundleLocator.resourcesBundle.url(
                 forResource: SSDOcrDetect.ssdOcrResource,
@@ -114,35 +112,52 @@ import UIKit
     }
 
     func detectOcrObjects(prediction: SSDOcrOutput, image: UIImage) -> String? {
-        var DetectedOcrBoxes = DetectedAllOcrBoxes()
+        return detectOcrObjects(prediction: prediction, imageSize: image.size)
+    }
 
-        var (scores, boxes, filterArray) = prediction.getScores(filterThreshold: filterThreshold)
-        let regularBoxes = prediction.convertLocationsToBoxes(
-            locations: boxes,
-            priors: SSDOcrDetect.priors ?? OcrPriorsGen.combinePriors(),
-            centerVariance: centerVariance,
-            sizeVariance: sizeVariance
-        )
-        let cornerFormBoxes = prediction.centerFormToCornerForm(regularBoxes: regularBoxes)
+    func detectOcrObjects(prediction: SSDOcrOutput, imageSize: CGSize) -> String? {
+        // a frame without digits mustn't report the boxes of the frame before it
+        lastDetectedBoxes = []
+        let detectedOcrBoxes: DetectedAllOcrBoxes? = instrumentation.measure(.nms) {
+            guard decode(prediction: prediction) else {
+                return nil
+            }
+            return suppressDigits(imageSize: imageSize)
+        }
+        guard let detectedOcrBoxes = detectedOcrBoxes else {
+            return nil
+        }
+
+        return instrumentation.measure(.digitGrouping) {
+            readNumber(from: detectedOcrBoxes)
+        }
+    }
+
+    // MARK: - Post-processing stages
+    // `detectOcrObjects` runs these in order. They are separate so that replays of recorded model
+    // output can time each one.
 
-        (scores, boxes) = prediction.filterScoresAndBoxes(
-            scores: scores,
-            boxes: cornerFormBoxes,
-            filterArray: filterArray,
-            filterThreshold: filterThreshold
+    /// Decodes the anchors that pass the model's filter into `decodeBuffer`
+    ///
+    /// - Returns: `false` if no anchor survived
+    func decode(prediction: SSDOcrOutput) -> Bool {
+        prediction.decode(
+            filterThreshold: filterThreshold,
+            centerVariance: centerVariance,
+            sizeVariance: sizeVariance,
+            into: decodeBuffer
         )
+        return decodeBuffer.count > 0
+    }
 
-        if scores.isEmpty || boxes.isEmpty {
-            return nil
-        }
+    /// Runs soft-NMS over the decoded anchors and returns the digit boxes in image coordinates
+    func suppressDigits(imageSize: CGSize) -> DetectedAllOcrBoxes {
+        var DetectedOcrBoxes = DetectedAllOcrBoxes()
 
         let result: Result = PredictionUtilOcr().predictionUtil(
-            scores: scores,
-            boxes: boxes,
+            decoded: decodeBuffer,
             probThreshold: probThreshold,
-            iouThreshold: iouThreshold,
-            candidateSize: candidateSize,
-            topK: topK
+            engine: nmsEngine
         )
 
         for idx in 0..<result.pickedBoxes.count {
@@ -154,11 +169,16 @@ import UIKit
                     YMin: Double(result.pickedBoxes[idx][1]),
                     XMax: Double(result.pickedBoxes[idx][2]),
                     YMax: Double(result.pickedBoxes[idx][3]),
-                    imageSize: image.size
+                    imageSize: imageSize
                 )
             )
         }
 
+        return DetectedOcrBoxes
+    }
+
+    /// Groups the digit boxes into a card number and updates `lastDetectedBoxes`
+    func readNumber(from DetectedOcrBoxes: DetectedAllOcrBoxes) -> String? {
         if !DetectedOcrBoxes.allBoxes.isEmpty {
             self.lastDetectedBoxes = DetectedOcrBoxes.getBoundingBoxesOfDigits()
         }
@@ -177,12 +197,9 @@ import UIKit
             self.lastDetectedBoxes = boxes
             return number
         }
-
     }
 
     func predict(image: UIImage) -> String? {
-
-        SSDOcrDetect.initializeModels()
         guard
             let pixelBuffer = image.pixelBuffer(
                 width: ssdOcrImageWidth,
@@ -204,4 +221,111 @@ import UIKit
         }
         return self.detectOcrObjects(prediction: prediction, image: image)
     }
+
+    /// Runs the model on a cropped frame, scaling it into a pooled pixel buffer with vImage
+    func predict(cgImage: CGImage) -> String? {
+        lastDetectedBoxes = []
+        guard let ocrDetectModel = ssdOcrModel,
+            let pixelBuffer = instrumentation.measure(.imageConversion, {
+                preprocessor.pixelBuffer(from: cgImage, pool: .ssdOcrInput)
+            })
+        else {
+            return nil
+        }
+
+        let input = SSDOcrInput(_0: pixelBuffer)
+
+        guard
+            let prediction = instrumentation.measure(.ocrInference, {
+                predictSingleFrame(input: input, model: ocrDetectModel)
+            })
+        else {
+            return nil
+        }
+        return self.detectOcrObjects(
+            prediction: prediction,
+            imageSize: CGSize(width: cgImage.width, height: cgImage.height)
+        )
+    }
+
+    /// Runs the model on several cropped frames in one batched prediction and reads a number from each.
+    ///
+    /// The outputs are decoded one after the other through the same prior table, decode buffer and NMS
+    /// engine as `predict(cgImage:)`.
+    ///
+    /// - Returns: The number and digit boxes for each image, in order, or `nil` if the batch couldn't run
+    func predict(cgImages: [CGImage]) -> [(number: String?, boxes: [CGRect])]? {
+        guard let ocrDetectModel = ssdOcrModel else {
+            return nil
+        }
+
+        var inputs: [SSDOcrInput] = []
+        inputs.reserveCapacity(cgImages.count)
+        for cgImage in cgImages {
+            guard
+                let pixelBuffer = instrumentation.measure(.imageConversion, {
+                    preprocessor.pixelBuffer(from: cgImage, pool: .ssdOcrInput)
+                })
+            else {
+                return nil
+            }
+            inputs.append(SSDOcrInput(_0: pixelBuffer))
+        }
+
+        guard
+            let predictions = instrumentation.measure(.batchedOcrInference, {
+                try? ocrDetectModel.predictions(inputs: inputs, options: batchOptions)
+            }),
+            predictions.count == cgImages.count
+        else {
+            return nil
+        }
+
+        return zip(predictions, cgImages).map { prediction, cgImage in
+            let number = detectOcrObjects(
+                prediction: prediction,
+                imageSize: CGSize(width: cgImage.width, height: cgImage.height)
+            )
+            return (number, lastDetectedBoxes)
+        }
+    }
+
+    private func predictSingleFrame(input: SSDOcrInput, model: SSDOcr) -> SSDOcrOutput? {
+        let options = singleFrameOptions ?? SSDOcrDetect.makeSingleFrameOptions(for: model.model)
+        singleFrameOptions = options
+        do {
+            return try model.prediction(input: input, options: options)
+        } catch {
+            // retry without our output arrays, and only stop offering them if CoreML turned them down.
+            // Errors that the retry hits too aren't about the arrays, so later frames still use them.
+            let fallbackOptions = MLPredictionOptions()
+            guard let prediction = try? model.prediction(input: input, options: fallbackOptions) else {
+                return nil
+            }
+            singleFrameOptions = fallbackOptions
+            return prediction
+        }
+    }
+
+    /// Preallocates an array for each of the model's outputs. Decoding copies what it needs out of the
+    /// outputs before the next prediction, so every prediction can reuse them.
+    static func makeSingleFrameOptions(for model: MLModel) -> MLPredictionOptions {
+        let options = MLPredictionOptions()
+        guard #available(iOS 16.0, *) else {
+            return options
+        }
+
+        var outputBackings: [String: Any] = [:]
+        for (name, description) in model.modelDescription.outputDescriptionsByName {
+            guard let constraint = description.multiArrayConstraint,
+                !constraint.shape.isEmpty,
+                let array = try? MLMultiArray(shape: constraint.shape, dataType: constraint.dataType)
+            else {
+                return options
+            }
+            outputBackings[name] = array
+        }
+        options.outputBackings = outputBackings
+        return options
+    }
 }
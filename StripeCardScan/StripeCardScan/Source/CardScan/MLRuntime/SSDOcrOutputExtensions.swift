@@ -10,6 +10,71 @@ import Foundation
 
 extension SSDOcrOutput {
 
+    /// Reads the model outputs straight from their `MLMultiArray` storage and copies only the
+    /// anchors whose `filter` output is above `filterThreshold` into `buffer`, then decodes their
+    /// boxes into corner form.
+    ///
+    /// This replaces `getScores`, `convertLocationsToBoxes`, `centerFormToCornerForm` and
+    /// `filterScoresAndBoxes`, which materialize and copy every anchor before any are discarded.
+    func decode(
+        filterThreshold: Float,
+        priors: SSDOcrPriorTable = .shared,
+        centerVariance: Float,
+        sizeVariance: Float,
+        into buffer: SSDOcrDecodeBuffer
+    ) {
+        let numOfAnchors = self.scores.shape[3].intValue
+        let numOfClasses = self.scores.shape[4].intValue
+        buffer.reserve(capacity: numOfAnchors, numClasses: numOfClasses)
+
+        guard self.boxes.shape[4].intValue == 4, priors.count >= numOfAnchors else {
+            return
+        }
+
+        let pointerScores = UnsafePointer<Float>(OpaquePointer(self.scores.dataPointer))
+        let pointerBoxes = UnsafePointer<Float>(OpaquePointer(self.boxes.dataPointer))
+        let pointerFilter = UnsafePointer<Float>(OpaquePointer(self.filter.dataPointer))
+
+        let scoresRowStride = self.scores.strides[3].intValue
+        let scoresColStride = self.scores.strides[4].intValue
+        let boxesRowStride = self.boxes.strides[3].intValue
+        let boxesColStride = self.boxes.strides[4].intValue
+        let filterRowStride = self.filter.strides[3].intValue
+
+        var count = 0
+        for anchor in 0..<numOfAnchors where pointerFilter[anchor * filterRowStride] > filterThreshold {
+            buffer.anchorIndices[count] = anchor
+
+            let scoresOffset = anchor * scoresRowStride
+            let bufferOffset = count * numOfClasses
+            for classIndex in 0..<numOfClasses {
+                buffer.scores[bufferOffset + classIndex] =
+                    pointerScores[scoresOffset + classIndex * scoresColStride]
+            }
+
+            let boxesOffset = anchor * boxesRowStride
+            buffer.locationX[count] = pointerBoxes[boxesOffset]
+            buffer.locationY[count] = pointerBoxes[boxesOffset + boxesColStride]
+            buffer.locationWidth[count] = pointerBoxes[boxesOffset + 2 * boxesColStride]
+            buffer.locationHeight[count] = pointerBoxes[boxesOffset + 3 * boxesColStride]
+
+            buffer.priorCenterX[count] = priors.centerX[anchor]
+            buffer.priorCenterY[count] = priors.centerY[anchor]
+            buffer.priorWidth[count] = priors.width[anchor]
+            buffer.priorHeight[count] = priors.height[anchor]
+
+            count += 1
+        }
+        buffer.count = count
+
+        buffer.decodeBoxes(
+            centerVariance: centerVariance,
+            sizeVariance: sizeVariance
+        )
+    }
+
+    /// The original nested array decode path. Production code uses `decode(filterThreshold:...)`,
+    /// this is kept as the reference implementation for tests and benchmarks.
     func getScores(filterThreshold: Float) -> ([[Float]], [[Float]], [Float]) {
         let pointerScores = UnsafeMutablePointer<Float>(OpaquePointer(self.scores.dataPointer))
         let pointerBoxes = UnsafeMutablePointer<Float>(OpaquePointer(self.boxes.dataPointer))
@@ -0,0 +1,37 @@
+//
+//  SSDOcrPriorTable.swift
+//  StripeCardScan
+//
+//  Created by Stripe on 10/17/26.
+//
+
+import CoreGraphics
+import Foundation
+
+/// The SSD OCR priors in center form, stored as one `Float` column per coordinate.
+///
+/// The priors only depend on the constants in `OcrPriorsGen`, so the table is built once on first
+/// use and then shared read-only by every `SSDOcrDetect`. Swift initializes static properties
+/// exactly once, so analyzer queues can race to use `shared` without any extra locking.
+struct SSDOcrPriorTable {
+    static let shared = SSDOcrPriorTable(priors: OcrPriorsGen.combinePriors())
+
+    let centerX: [Float]
+    let centerY: [Float]
+    let width: [Float]
+    let height: [Float]
+
+    var count: Int {
+        return centerX.count
+    }
+
+    /// Note: `OcrPriorsGen` stores the center of each prior in the rectangle's origin
+    init(
+        priors: [CGRect]
+    ) {
+        self.centerX = priors.map { Float($0.minX) }
+        self.centerY = priors.map { Float($0.minY) }
+        self.width = priors.map { Float($0.width) }
+        self.height = priors.map { Float($0.height) }
+    }
+}
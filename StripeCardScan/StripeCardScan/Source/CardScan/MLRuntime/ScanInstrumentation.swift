@@ -0,0 +1,224 @@
+//
+//  ScanInstrumentation.swift
+//  StripeCardScan
+//
+//  Created by Stripe on 10/17/26.
+//
+
+import Foundation
+import os
+
+/// A step of processing a frame that `ScanInstrumentation` times
+enum ScanStage: Int, CaseIterable {
+    /// An analyzer's whole `recognizeCard` call, as `OcrMainLoop` sees it
+    case frame
+    /// Deciding with `FrameGate` whether to run SSD OCR on the frame
+    case gating
+    /// Cropping and scaling a frame into a model's input pixel buffer
+    case imageConversion
+    /// The SSD OCR model prediction
+    case ocrInference
+    /// One SSD OCR prediction over a batch of frames
+    case batchedOcrInference
+    /// The UX model prediction
+    case uxInference
+    /// The Vision text recognition request
+    case appleOcr
+    /// Decoding the SSD OCR output and running soft-NMS over it
+    case nms
+    /// Grouping the SSD OCR digit boxes into a card number
+    case digitGrouping
+    /// Adding a prediction to `ErrorCorrection`
+    case errorCorrection
+
+    var analyticsName: String {
+        switch self {
+        case .frame: return "frame"
+        case .gating: return "gating"
+        case .imageConversion: return "image_conversion"
+        case .ocrInference: return "ocr_inference"
+        case .batchedOcrInference: return "batched_ocr_inference"
+        case .uxInference: return "ux_inference"
+        case .appleOcr: return "apple_ocr"
+        case .nms: return "nms"
+        case .digitGrouping: return "digit_grouping"
+        case .errorCorrection: return "error_correction"
+        }
+    }
+
+    /// Signpost interval names have to be static strings
+    var signpostName: StaticString {
+        switch self {
+        case .frame: return "Frame"
+        case .gating: return "Gating"
+        case .imageConversion: return "Image conversion"
+        case .ocrInference: return "OCR inference"
+        case .batchedOcrInference: return "Batched OCR inference"
+        case .uxInference: return "UX inference"
+        case .appleOcr: return "Apple OCR"
+        case .nms: return "NMS"
+        case .digitGrouping: return "Digit grouping"
+        case .errorCorrection: return "Error correction"
+        }
+    }
+}
+
+/// A fixed size histogram of durations.
+///
+/// Bucket 0 counts durations under 1ms, bucket `i` counts durations in [2^(i-1), 2^i) ms and the last
+/// bucket counts everything from 1024ms up, so recording a duration never allocates.
+struct LatencyHistogram: Equatable {
+    static let bucketCount = 12
+
+    private(set) var buckets = [Int](repeating: 0, count: LatencyHistogram.bucketCount)
+    private(set) var count = 0
+    private(set) var totalDuration: TimeInterval = 0.0
+    private(set) var maxDuration: TimeInterval = 0.0
+
+    mutating func record(_ duration: TimeInterval) {
+        let milliseconds = Int(max(duration, 0.0) * 1000.0)
+        let bucket = milliseconds == 0 ? 0 : Int.bitWidth - milliseconds.leadingZeroBitCount
+        buckets[min(bucket, LatencyHistogram.bucketCount - 1)] += 1
+        count += 1
+        totalDuration += duration
+        maxDuration = max(maxDuration, duration)
+    }
+
+    var meanDuration: TimeInterval {
+        return count > 0 ? totalDuration / Double(count) : 0.0
+    }
+
+    /// The upper bound of the bucket that holds the `percentile`th duration, or the longest duration
+    /// if that's lower. `percentile` is between 0 and 1.
+    func duration(atPercentile percentile: Double) -> TimeInterval {
+        guard count > 0 else { return 0.0 }
+        let rank = max(Int((percentile * Double(count)).rounded(.up)), 1)
+        var seen = 0
+        for (bucket, bucketCount) in buckets.enumerated() {
+            seen += bucketCount
+            if seen >= rank {
+                return min(Double(1 << bucket) / 1000.0, maxDuration)
+            }
+        }
+        return maxDuration
+    }
+
+    func toDictionaryForAnalytics() -> [String: Any] {
+        return [
+            "count": count,
+            "mean": meanDuration,
+            "p50": duration(atPercentile: 0.5),
+            "p90": duration(atPercentile: 0.9),
+            "max": maxDuration,
+            "buckets": buckets,
+        ]
+    }
+}
+
+/// A snapshot of what `ScanInstrumentation` measured
+struct ScanInstrumentationSummary: Equatable {
+    /// One histogram per `ScanStage`, indexed by the stage's raw value
+    var stageLatencies = [LatencyHistogram](repeating: LatencyHistogram(), count: ScanStage.allCases.count)
+    /// Frames analyzed at each `ProcessInfo.ThermalState`, indexed by the state's raw value
+    var thermalStateFrames = [Int](repeating: 0, count: 4)
+
+    func latency(of stage: ScanStage) -> LatencyHistogram {
+        return stageLatencies[stage.rawValue]
+    }
+
+    func frames(at thermalState: ProcessInfo.ThermalState) -> Int {
+        return thermalStateFrames[min(thermalState.rawValue, thermalStateFrames.count - 1)]
+    }
+
+    /// The hottest state any frame was analyzed at
+    var maxThermalState: ProcessInfo.ThermalState {
+        let hottest = thermalStateFrames.lastIndex { $0 > 0 } ?? 0
+        return ProcessInfo.ThermalState(rawValue: hottest) ?? .nominal
+    }
+
+    func toDictionaryForAnalytics() -> [String: Any] {
+        var stages: [String: Any] = [:]
+        for stage in ScanStage.allCases where latency(of: stage).count > 0 {
+            stages[stage.analyticsName] = latency(of: stage).toDictionaryForAnalytics()
+        }
+        return [
+            "stage_latencies": stages,
+            "thermal_state_frames": thermalStateFrames,
+            "max_thermal_state": maxThermalState.analyticsName,
+        ]
+    }
+}
+
+/// Times the stages of the scanning pipeline and counts the thermal state of each analyzed frame.
+///
+/// Each measurement is a signpost interval, so the stages show up in the Points of Interest
+/// instrument, and also goes into a fixed size `LatencyHistogram` per stage. `OcrMainLoop` folds the
+/// histograms into `ScanStats` after each frame, and they're uploaded with the rest of the scan stats,
+/// so the overhead per measurement is two clock reads and a short unfair lock.
+///
+/// Analyzers measure on their own queues, so every method is thread safe.
+final class ScanInstrumentation {
+    private static let signposter = OSSignposter(
+        subsystem: "com.stripe.stripe-cardscan",
+        category: .pointsOfInterest
+    )
+
+    private var summary = ScanInstrumentationSummary()
+
+    // Allocated up front rather than lazily so that the first measurements can't race to create it
+    private let lock: os_unfair_lock_t
+
+    init() {
+        self.lock = os_unfair_lock_t.allocate(capacity: 1)
+        self.lock.initialize(to: os_unfair_lock_s())
+    }
+
+    deinit {
+        lock.deallocate()
+    }
+
+    /// Runs `work`, timing it as `stage`
+    @discardableResult
+    func measure<T>(_ stage: ScanStage, _ work: () throws -> T) rethrows -> T {
+        let signpostState = ScanInstrumentation.signposter.beginInterval(stage.signpostName)
+        let startTime = DispatchTime.now().uptimeNanoseconds
+        defer {
+            let duration = Double(DispatchTime.now().uptimeNanoseconds - startTime) / 1_000_000_000.0
+            ScanInstrumentation.signposter.endInterval(stage.signpostName, signpostState)
+            record(stage, duration: duration)
+        }
+        return try work()
+    }
+
+    /// Records a duration measured elsewhere, e.g. for work that finishes in a completion handler
+    func record(_ stage: ScanStage, duration: TimeInterval) {
+        os_unfair_lock_lock(lock)
+        summary.stageLatencies[stage.rawValue].record(duration)
+        os_unfair_lock_unlock(lock)
+    }
+
+    /// Counts a frame analyzed at `thermalState`
+    func recordFrame(thermalState: ProcessInfo.ThermalState = ProcessInfo.processInfo.thermalState) {
+        os_unfair_lock_lock(lock)
+        summary.thermalStateFrames[min(thermalState.rawValue, summary.thermalStateFrames.count - 1)] += 1
+        os_unfair_lock_unlock(lock)
+    }
+
+    func snapshot() -> ScanInstrumentationSummary {
+        os_unfair_lock_lock(lock)
+        defer { os_unfair_lock_unlock(lock) }
+        return summary
+    }
+}
+
+extension ProcessInfo.ThermalState {
+    var analyticsName: String {
+        switch self {
+        case .nominal: return "nominal"
+        case .fair: return "fair"
+        case .serious: return "serious"
+        case .critical: return "critical"
+        @unknown default: return "unknown"
+        }
+    }
+}
@@ -9,6 +9,9 @@ import Accelerate
 import Foundation
 
 struct SoftNMS {
+    /// The original array based Soft-NMS. Production code uses
+    /// `NonMaxSuppressionEngine.softNMS`, which produces identical results in place, this is kept
+    /// as the reference implementation for tests.
     static func softNMS(
         subsetBoxes: [[Float]],
         probs: [Float],
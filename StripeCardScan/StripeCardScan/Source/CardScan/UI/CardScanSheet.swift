@@ -26,6 +26,14 @@ public class CardScanSheet {
 
     public init() {}
 
+    /// Loads the card scanning models in the background so that the first scan starts faster.
+    ///
+    /// Call this early, e.g. when your app launches or when the customer reaches your checkout
+    /// screen. Calling it more than once is harmless.
+    public static func prewarm() {
+        OcrMainLoop.warmUp()
+    }
+
     /// Presents a sheet for a customer to scan their card
     /// - Parameter presentingViewController: The view controller to present a card scan sheet
     /// - Parameter completion: Called with the result of the scan after the card scan sheet is dismissed
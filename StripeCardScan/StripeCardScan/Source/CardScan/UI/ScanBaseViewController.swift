@@ -179,6 +179,7 @@ class ScanBaseViewController: UIViewController, AVCaptureVideoDataOutputSampleBu
             return
         }
         ocrMainLoop.userCancelled()
+        ScanAnalyticsManager.shared.logPerformanceInfo(with: .init(scanStats: ocrMainLoop.scanStats))
     }
 
     func setupMask() {
@@ -476,6 +477,7 @@ class ScanBaseViewController: UIViewController, AVCaptureVideoDataOutputSampleBu
         ScanAnalyticsManager.shared.logMainLoopImageProcessedRepeatingTask(
             .init(executions: self.getScanStats().scans)
         )
+        ScanAnalyticsManager.shared.logPerformanceInfo(with: .init(scanStats: self.getScanStats()))
         ScanAnalyticsManager.shared.logScanActivityTaskFromStartTime(event: .cardScanned)
 
         ScanBaseViewController.machineLearningQueue.async {
@@ -528,7 +530,9 @@ class ScanBaseViewController: UIViewController, AVCaptureVideoDataOutputSampleBu
         default: isFlashForcedOn = false
         }
 
-        if let number = prediction.number {
+        // frames that reuse an earlier frame's number weren't read by OCR, so they're only kept
+        // for what the UX model saw
+        if let number = prediction.number, !prediction.isReused {
             if !firstPanObserved {
                 ScanAnalyticsManager.shared.logScanActivityTaskFromStartTime(event: .ocrPanObserved)
                 firstPanObserved = true
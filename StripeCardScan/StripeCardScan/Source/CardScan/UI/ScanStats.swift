@@ -30,6 +30,27 @@ struct ScanStats {
     var cardsDetected = 0
     var permissionGranted: Bool?
     var userCanceled: Bool = false
+    /// Frames the capture thread replaced with a newer frame before any analyzer read them
+    var framesDropped = 0
+    /// Frames an analyzer took from the frame buffer
+    var framesConsumed = 0
+    /// Frames that were waiting in the frame buffer when it was flushed, e.g. on backgrounding
+    var framesStale = 0
+    /// The policy `AnalyzerScheduler` used for the most recent frame
+    var analyzerSchedulingPolicy: String?
+    /// How many times the scheduler paused a low-yield analyzer
+    var analyzerPauses = 0
+    /// Set if the app prewarmed the models before this scan
+    var modelWarmUpTimings: ModelWarmUpTimings?
+    /// The most bytes the verification frames took up at once, as encoded frames or images waiting to be encoded
+    var peakRetainedFrameBytes = 0
+    /// Encoded verification frames kept when the scan completed
+    var retainedFrames = 0
+    /// How long each stage of the frames took, and how hot the device was while analyzing them
+    var instrumentation = ScanInstrumentationSummary()
+    /// Frames the analyzers' `FrameGate`s ran OCR on, skipped because there was no card, or answered
+    /// with the last result because nothing had changed
+    var frameGate = FrameGateStatistics()
 
     init() {
         var systemInfo = utsname()
@@ -63,9 +84,43 @@ struct ScanStats {
                 ?? "not_determined",
             "device_type": self.deviceType ?? "",
             "user_canceled": self.userCanceled,
+            "frames_dropped": self.framesDropped,
+            "frames_consumed": self.framesConsumed,
+            "frames_stale": self.framesStale,
+            "analyzer_scheduling_policy": self.analyzerSchedulingPolicy ?? "unknown",
+            "analyzer_pauses": self.analyzerPauses,
+            "model_warm_up": self.modelWarmUpTimings?.toDictionaryForAnalytics() ?? [:],
+            "peak_retained_frame_bytes": self.peakRetainedFrameBytes,
+            "retained_frames": self.retainedFrames,
+            "instrumentation": self.instrumentation.toDictionaryForAnalytics(),
+            "frame_gate": self.frameGate.toDictionaryForAnalytics(),
         ]
     }
 
+    mutating func update(frameStatistics: LatestFramesStatistics) {
+        self.framesDropped = frameStatistics.dropped
+        self.framesConsumed = frameStatistics.consumed
+        self.framesStale = frameStatistics.stale
+    }
+
+    mutating func update(scheduler: AnalyzerScheduler) {
+        self.analyzerSchedulingPolicy = scheduler.policy.rawValue
+        self.analyzerPauses = scheduler.pauseCount
+    }
+
+    mutating func update(frameGates: [FrameGateStatistics]) {
+        self.frameGate = frameGates.reduce(FrameGateStatistics(), +)
+    }
+
+    mutating func update(instrumentation: ScanInstrumentation) {
+        self.instrumentation = instrumentation.snapshot()
+    }
+
+    mutating func update(frameRetention: FrameRetentionStore) {
+        self.peakRetainedFrameBytes = frameRetention.peakBytes
+        self.retainedFrames = frameRetention.retainedFrameCount
+    }
+
     func duration() -> Double {
         guard let endTime = self.endTime else {
             return 0.0
@@ -39,5 +39,79 @@ extension ScanAnalyticsPayload {
         let imageCompressionQuality: Double
         /// Byte count of the image payload after it has been compressed and b64 encoded
         let imagePayloadSize: Int
+        /// The most bytes the verification frames took up at once while they were encoded
+        let peakRetainedFrameBytes: Int
+        /// Encoded verification frames kept when the scan completed
+        let retainedFrames: Int
+    }
+
+    /// How long each stage of the scan's frames took and how hot the device got while scanning
+    struct PerformanceInfo: Encodable, Equatable {
+        struct StageLatency: Encodable, Equatable {
+            let stage: String
+            let count: Int
+            let meanMs: Int
+            let p50Ms: Int
+            let p90Ms: Int
+            let maxMs: Int
+            /// Counts per `LatencyHistogram` bucket, from under 1ms up to 1024ms and over
+            let histogram: [Int]
+        }
+
+        let framesConsumed: Int
+        let framesDropped: Int
+        /// Frames that `FrameGate` answered with the previous OCR result
+        let framesReusedLast: Int
+        /// Frames that `FrameGate` didn't run OCR on because the UX model found no card
+        let framesSkippedNoCard: Int
+        let maxThermalState: String
+        /// Only the stages that ran at least once
+        let stageLatencies: [StageLatency]
+        /// Frames analyzed at the nominal, fair, serious and critical thermal states
+        let thermalStateFrames: [Int]
+
+        init(
+            scanStats: ScanStats
+        ) {
+            let summary = scanStats.instrumentation
+            self.framesConsumed = scanStats.framesConsumed
+            self.framesDropped = scanStats.framesDropped
+            self.framesReusedLast = scanStats.frameGate.reusedLast
+            self.framesSkippedNoCard = scanStats.frameGate.skippedNoCard
+            self.maxThermalState = summary.maxThermalState.analyticsName
+            self.stageLatencies = ScanStage.allCases.compactMap { stage in
+                let latency = summary.latency(of: stage)
+                guard latency.count > 0 else { return nil }
+                return StageLatency(
+                    stage: stage.analyticsName,
+                    count: latency.count,
+                    meanMs: latency.meanDuration.milliseconds,
+                    p50Ms: latency.duration(atPercentile: 0.5).milliseconds,
+                    p90Ms: latency.duration(atPercentile: 0.9).milliseconds,
+                    maxMs: latency.maxDuration.milliseconds,
+                    histogram: latency.buckets
+                )
+            }
+            self.thermalStateFrames = summary.thermalStateFrames
+        }
+    }
+}
+
+extension ScanAnalyticsPayload.PayloadInfo {
+    /// Describes the verification payload made from the frames kept during the scan
+    init(
+        retainedFrames: [RetainedFrame],
+        scanStats: ScanStats
+    ) {
+        // Use the image metadata from the most recent frame
+        let imageMetadata = retainedFrames.last?.imageMetadata
+        self.init(
+            imageCompressionType: imageMetadata?.compressionType.rawValue ?? "unknown",
+            imageCompressionQuality: imageMetadata?.compressionQuality ?? 0.0,
+            // The compressed and b64 encoded image sizes in bytes
+            imagePayloadSize: retainedFrames.reduce(0) { $0 + $1.byteCount },
+            peakRetainedFrameBytes: scanStats.peakRetainedFrameBytes,
+            retainedFrames: scanStats.retainedFrames
+        )
     }
 }
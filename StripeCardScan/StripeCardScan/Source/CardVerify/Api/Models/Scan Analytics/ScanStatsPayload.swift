@@ -22,6 +22,8 @@ struct ScanAnalyticsPayload: Encodable {
     let instanceId: String = UUID().uuidString
     let payloadInfo: PayloadInfo?
     let payloadVersion = "2"
+    /// Set once the main loop has analyzed frames
+    var performanceInfo: PerformanceInfo?
     /// API  requirement but have no purpose
     let scanId: String = UUID().uuidString
     let scanStats: ScanStatsTasks
@@ -0,0 +1,85 @@
+//
+//  VerificationFramesMultipartBody.swift
+//  StripeCardScan
+//
+//  Created by Stripe on 10/17/26.
+//
+
+import Foundation
+@_spi(STP) import StripeCore
+
+/// The multipart/form-data body of a `verify_frames` request, which sends each frame's image as
+/// binary rather than base64 inside of a JSON string inside of a form field.
+///
+/// Frames are appended one at a time, and each image is copied straight into the body, so the body
+/// is the only other copy of the image data in memory. The fields are named the way the form
+/// encoded request would name them if `verification_frames_data` were a list rather than a string:
+///
+///     client_secret
+///     verification_frames_data[0][image_data]                   (image/jpeg or image/heic)
+///     verification_frames_data[0][viewfinder_margins][left]
+///     verification_frames_data[0][viewfinder_margins][upper]
+///     verification_frames_data[0][viewfinder_margins][right]
+///     verification_frames_data[0][viewfinder_margins][lower]
+///     verification_frames_data[1][image_data]
+///     ...
+struct VerificationFramesMultipartBody {
+    let boundary: String
+    private var data = Data()
+    private(set) var frameCount = 0
+
+    init(
+        clientSecret: String,
+        boundary: String = STPMultipartFormDataEncoder.generateBoundary()
+    ) {
+        self.boundary = boundary
+        appendField(name: "client_secret", value: clientSecret)
+    }
+
+    /// Appends the frame's image and viewfinder margins
+    mutating func append(_ frame: VerificationFramesData) {
+        let prefix = "verification_frames_data[\(frameCount)]"
+        frameCount += 1
+
+        if let imageData = frame.imageData {
+            let (fileExtension, contentType) = VerificationFramesMultipartBody.imageType(of: imageData)
+            let imagePart = STPMultipartFormDataPart()
+            imagePart.name = "\(prefix)[image_data]"
+            imagePart.filename = "frame_\(frameCount - 1).\(fileExtension)"
+            imagePart.contentType = contentType
+            imagePart.data = imageData
+            data.reserveCapacity(data.count + imageData.count + 1024)
+            STPMultipartFormDataEncoder.append(imagePart, to: &data, boundary: boundary)
+        }
+
+        let margins = frame.viewfinderMargins
+        appendField(name: "\(prefix)[viewfinder_margins][left]", value: String(margins.left))
+        appendField(name: "\(prefix)[viewfinder_margins][upper]", value: String(margins.upper))
+        appendField(name: "\(prefix)[viewfinder_margins][right]", value: String(margins.right))
+        appendField(name: "\(prefix)[viewfinder_margins][lower]", value: String(margins.lower))
+    }
+
+    /// Ends the body. Nothing can be appended after this.
+    mutating func finish() -> Data {
+        STPMultipartFormDataEncoder.appendClosingBoundary(to: &data, boundary: boundary)
+        return data
+    }
+
+    // MARK: - Helpers
+
+    private mutating func appendField(name: String, value: String) {
+        let part = STPMultipartFormDataPart()
+        part.name = name
+        part.data = Data(value.utf8)
+        STPMultipartFormDataEncoder.append(part, to: &data, boundary: boundary)
+    }
+
+    /// The file extension and content type of an encoded image, from its first bytes
+    static func imageType(of imageData: Data) -> (String, String) {
+        // HEIC files start with an ISO base media `ftyp` box, JPEGs with a start of image marker
+        if imageData.count >= 12, imageData.dropFirst(4).prefix(4).elementsEqual("ftyp".utf8) {
+            return ("heic", "image/heic")
+        }
+        return ("jpg", "image/jpeg")
+    }
+}
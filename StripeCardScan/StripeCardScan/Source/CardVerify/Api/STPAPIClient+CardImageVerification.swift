@@ -31,8 +31,17 @@ extension STPAPIClient {
     func submitVerificationFrames(
         cardImageVerificationId: String,
         cardImageVerificationSecret: String,
-        verificationFramesData: [VerificationFramesData]
+        verificationFramesData: [VerificationFramesData],
+        uploadMode: CardImageVerificationSheet.VerificationFramesUploadMode = .formEncoded
     ) -> Promise<EmptyResponse> {
+        if uploadMode == .multipart {
+            return submitVerificationFramesAsMultipartForm(
+                cardImageVerificationId: cardImageVerificationId,
+                cardImageVerificationSecret: cardImageVerificationSecret,
+                verificationFramesData: verificationFramesData
+            )
+        }
+
         do {
             /// TODO: Replace this with writing the JSON to a string instead of a data
             /// Encode the array of verification frames data into JSON
@@ -61,6 +70,21 @@ extension STPAPIClient {
         }
     }
 
+    /// Submits the verification frames with each image as a binary part of a multipart/form-data body
+    func submitVerificationFramesAsMultipartForm(
+        cardImageVerificationId: String,
+        cardImageVerificationSecret: String,
+        verificationFramesData: [VerificationFramesData]
+    ) -> Promise<EmptyResponse> {
+        var body = VerificationFramesMultipartBody(clientSecret: cardImageVerificationSecret)
+        for frame in verificationFramesData {
+            body.append(frame)
+        }
+        let boundary = body.boundary
+        let endpoint = APIEndpoints.submitVerificationFrames(id: cardImageVerificationId)
+        return self.postMultipartForm(resource: endpoint, body: body.finish(), boundary: boundary)
+    }
+
     /// Request used to upload analytics of a card scanning session
     /// This will be a fire-and-forget request
     @discardableResult
@@ -113,7 +113,8 @@ extension CardImageVerificationController: VerifyViewControllerDelegate {
         configuration.apiClient.submitVerificationFrames(
             cardImageVerificationId: intent.id,
             cardImageVerificationSecret: intent.clientSecret,
-            verificationFramesData: verificationFramesData
+            verificationFramesData: verificationFramesData,
+            uploadMode: configuration.verificationFramesUploadMode
         ).observe { [weak self] result in
             switch result {
             case .success:
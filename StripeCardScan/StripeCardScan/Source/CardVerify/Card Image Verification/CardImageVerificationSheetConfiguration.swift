@@ -19,9 +19,22 @@ extension CardImageVerificationSheet {
         /// only be used with guidance from Stripe support.
         @_spi(STP) public var strictModeFrames: StrictModeFrameCount = .none
 
+        /// How the scanned frames are sent to Stripe. This is an `experimental` feature that
+        /// should only be used with guidance from Stripe support.
+        @_spi(STP) public var verificationFramesUploadMode: VerificationFramesUploadMode = .formEncoded
+
         public init() {}
     }
 
+    /// Enum describing how the scanned frames are sent to Stripe. This is an `experimental`
+    /// feature that should only be used with guidance from Stripe support.
+    @_spi(STP) public enum VerificationFramesUploadMode: Equatable {
+        /// The frames are base64 encoded into a JSON string, which is sent as a form field
+        case formEncoded
+        /// Each frame's image is sent as its own binary part of a multipart/form-data body
+        case multipart
+    }
+
     /// Enum describing the amount of frames that must have a centered, focused card before the
     /// scan is allowed to terminate. This is an `experimental` feature that should
     /// only be used with guidance from Stripe support.
@@ -10,6 +10,7 @@ import Foundation
 import UIKit
 
 typealias PayloadInfo = ScanAnalyticsPayload.PayloadInfo
+typealias PerformanceInfo = ScanAnalyticsPayload.PerformanceInfo
 
 /// Manager used to aggregate scan analytics
 class ScanAnalyticsManager {
@@ -21,6 +22,7 @@ class ScanAnalyticsManager {
     private var startTime: Date?
     private var nonRepeatingTaskManager = NonRepeatingTasksManager()
     private var payloadInfo: PayloadInfo?
+    private var performanceInfo: PerformanceInfo?
     private var repeatingTaskManager = RepeatingTasksManager()
 
     init() {}
@@ -58,6 +60,7 @@ class ScanAnalyticsManager {
                     ScanAnalyticsPayload(
                         configuration: configuration,
                         payloadInfo: self.payloadInfo,
+                        performanceInfo: self.performanceInfo,
                         scanStats: scanStatsTasks
                     )
                 )
@@ -127,6 +130,13 @@ class ScanAnalyticsManager {
         }
     }
 
+    /// Keep track of the stage latencies and thermal state from the main loop's scan stats
+    func logPerformanceInfo(with performanceInfo: PerformanceInfo) {
+        mutexQueue.async { [weak self] in
+            self?.performanceInfo = performanceInfo
+        }
+    }
+
     /// Keep  track of the start time and duration of the completion loop
     func trackCompletionLoopDuration(task: TrackableTask) {
         mutexQueue.async { [weak self] in
@@ -154,6 +164,7 @@ class ScanAnalyticsManager {
             self?.startTime = nil
             self?.nonRepeatingTaskManager = NonRepeatingTasksManager()
             self?.payloadInfo = nil
+            self?.performanceInfo = nil
             self?.repeatingTaskManager = RepeatingTasksManager()
         }
     }
@@ -6,8 +6,10 @@
 //
 
 import Foundation
+import ImageIO
 @_spi(STP) import StripeCore
 import UIKit
+import UniformTypeIdentifiers
 
 /// Image configurations used for verification flow
 typealias ImageConfig = CardImageVerificationAcceptedImageConfigs
@@ -48,14 +50,11 @@ extension ScannedCardImageData {
         )
     }
 
-    /// Converts a CGImage into a base64 encoded string of a jpeg image
+    /// Encodes the CGImage in the first supported format the server accepts, falling back to jpeg
     private func toExpectedImageFormat(
         image: CGImage,
         imageConfig: ImageConfig
     ) -> CardImageVerificationImageMetadata {
-        /// Convert CGImage to UIImage
-        let uiImage = UIImage(cgImage: image)
-
         /// TODO(jaimepark): Resize with aspect ratio maintained if image is bigger than 1080 x 1920
 
         for format in imageConfig.preferredFormats ?? [] {
@@ -64,7 +63,7 @@ extension ScannedCardImageData {
             }
 
             let compressedImage = compressedImageForFormat(
-                image: uiImage,
+                image: image,
                 format: format,
                 imageConfig: imageConfig
             )
@@ -73,7 +72,7 @@ extension ScannedCardImageData {
             }
         }
 
-        return compressedImageForFormat(image: uiImage, format: .jpeg, imageConfig: imageConfig)
+        return compressedImageForFormat(image: image, format: .jpeg, imageConfig: imageConfig)
     }
 
     /// Converts the view finder CGRect into a ViewFinderMargins object
@@ -95,43 +94,46 @@ extension ScannedCardImageData {
     }
 
     private func compressedImageForFormat(
-        image: UIImage,
+        image: CGImage,
         format: CardImageVerificationFormat,
         imageConfig: ImageConfig
     ) -> CardImageVerificationImageMetadata {
         let imageSettings = imageConfig.imageSettings(format: format)
         let compressionRatio = imageSettings.compressionRatio ?? 1
-        var result: CardImageVerificationImageMetadata =
-            .init(
-                imageData: Data(),
-                imageSize: .zero,
-                compressionType: format,
-                compressionQuality: compressionRatio
-            )
+        let imageData: Data?
 
         switch format {
         case .heic:
-            let imageDataAndSize = image.heicDataAndDimensions(compressionQuality: compressionRatio)
-
-            result = .init(
-                imageData: imageDataAndSize.imageData,
-                imageSize: imageDataAndSize.imageSize,
-                compressionType: format,
-                compressionQuality: compressionRatio
-            )
+            imageData = encode(image: image, type: .heic, compressionQuality: compressionRatio)
         case .jpeg:
-            let imageDataAndSize = image.jpegDataAndDimensions(compressionQuality: compressionRatio)
-
-            result = .init(
-                imageData: imageDataAndSize.imageData,
-                imageSize: imageDataAndSize.imageSize,
-                compressionType: format,
-                compressionQuality: compressionRatio
-            )
+            imageData = encode(image: image, type: .jpeg, compressionQuality: compressionRatio)
         case .webp, .unparsable:
             assertionFailure("Unsupported format requested for image.")
+            imageData = nil
         }
 
-        return result
+        return .init(
+            imageData: imageData ?? Data(),
+            imageSize: imageData == nil ? .zero : CGSize(width: image.width, height: image.height),
+            compressionType: format,
+            compressionQuality: compressionRatio
+        )
+    }
+
+    /// Encodes the image with ImageIO, without wrapping it in a `UIImage` first. Safe to call from
+    /// several threads at once.
+    private func encode(image: CGImage, type: UTType, compressionQuality: Double) -> Data? {
+        guard let data = CFDataCreateMutable(nil, 0),
+            let destination = CGImageDestinationCreateWithData(data, type.identifier as CFString, 1, nil)
+        else {
+            return nil
+        }
+
+        let properties = [kCGImageDestinationLossyCompressionQuality: compressionQuality] as CFDictionary
+        CGImageDestinationAddImage(destination, image, properties)
+        guard CGImageDestinationFinalize(destination) else {
+            return nil
+        }
+        return data as Data
     }
 }
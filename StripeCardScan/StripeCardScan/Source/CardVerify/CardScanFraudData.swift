@@ -12,11 +12,15 @@
 /// OCR, but for UX we might get a few older frames because our logic for starting non number side card scans requires a few
 /// consecutive frames where the UX model detects a card.
 ///
+/// Frames are kept in a `FrameRetentionStore`, which ranks them by the priority above and then by recency. Accepted
+/// frames are encoded concurrently on `encodingQueue` right away, and the encoded frames are kept within
+/// `kFrameByteBudget` bytes, so that completing the scan only waits for the encodes still in flight.
+///
 /// # Correctness
 ///
 /// This interface is thread safe, but all shared state access needs to happen in the `mutexQueue`. The mutexQueue
 /// enforces ordering constraints and will process frames in the correct order as defined by the `ScanEvents` calling
-/// sequence.
+/// sequence. Encoding happens on the `encodingQueue`, which hands the encoded frames back to the `mutexQueue`.
 ///
 
 import CoreGraphics
@@ -24,18 +28,42 @@ import UIKit
 
 class CardScanFraudData: ScanEvents {
     let mutexQueue = DispatchQueue(label: "Completion loop mutex queue")
+    let encodingQueue = DispatchQueue(
+        label: "Completion loop encoding queue",
+        qos: .utility,
+        attributes: .concurrent
+    )
 
     var last4: String?
     var hasModelBeenCalled = false
-    var framesWithCards: [ScannedCardImageData] = []
-    var framesWithCardsAndOcr: [ScannedCardImageData] = []
-    var ocrOnlyFrames: [ScannedCardImageData] = []
-    var framesWithFlashCardsAndOcr: [ScannedCardImageData] = []
-    var framesWithFlashAndCards: [ScannedCardImageData] = []
-    var framesWithFlashAndOcr: [ScannedCardImageData] = []
     let kMaxScans = 5
     let kMaxFlashScans = 3
+    /// The most bytes of encoded frames to keep, a few times what `kMaxScans + kMaxFlashScans` frames usually take
+    let kFrameByteBudget = 4 * 1024 * 1024
     var requireOcrBeforeCapturingUxOnlyFrames = true
+    /// The image format to encode frames to as they're accepted
+    var acceptedImageConfigs: CardImageVerificationAcceptedImageConfigs?
+
+    /// Frames encoded at once, leaving a core for the scan itself. The retention store only starts as
+    /// many of them as the images being encoded leave room for in `kEncodingByteBudget`.
+    let kMaxConcurrentEncodes = max(ProcessInfo.processInfo.activeProcessorCount - 1, 1)
+    /// The most bytes of full resolution images to encode at once, room for three 1080p BGRA frames
+    let kEncodingByteBudget = 3 * 1920 * 1080 * 4
+
+    lazy var retentionStore = FrameRetentionStore(
+        byteBudget: kFrameByteBudget,
+        maxFrames: kMaxScans,
+        maxFlashFrames: kMaxFlashScans,
+        maxConcurrentEncodes: kMaxConcurrentEncodes,
+        encodingByteBudget: kEncodingByteBudget
+    )
+    /// Whether any frames where OCR read the number have been accepted
+    var hasOcrFrames = false
+    /// How long encoding the accepted frames took altogether
+    var encodingDuration: TimeInterval = 0
+    var encodingStartTime: Date?
+    /// Set once the scan is complete, and called once the last accepted frame is encoded
+    private var encodingCompletion: (() -> Void)?
 
     var debugRetainImages = false
     // Note: Only access these arrays on the main loop
@@ -57,17 +85,9 @@ class CardScanFraudData: ScanEvents {
 
             let hasCard = centeredCardState?.hasCard() ?? false
 
-            let ocrFrameCount = self.framesWithCardsAndOcr.count + self.ocrOnlyFrames.count
-
-            if hasCard && (ocrFrameCount > 0 || !self.requireOcrBeforeCapturingUxOnlyFrames) {
-                if flashForcedOn {
-                    self.framesWithFlashAndCards.append(imageData)
-                } else {
-                    self.framesWithCards.append(imageData)
-                }
+            if hasCard && (self.hasOcrFrames || !self.requireOcrBeforeCapturingUxOnlyFrames) {
+                self.retainFrame(imageData: imageData, category: .card, flashForcedOn: flashForcedOn)
             }
-
-            self.balanceFrames()
         }
     }
 
@@ -86,84 +106,75 @@ class CardScanFraudData: ScanEvents {
             let hasCard = centeredCardState?.hasCard() ?? false
             let scannedLastFour = String(number.suffix(4))
 
-            /// This method is used to put the frame data in it's appropriate list given the `flashForcedOn` and `hasCard` flag,
-            /// This method should be called on when we know that we want to keep the frame.
-            func appendFrameData(flashForcedOn: Bool, hasCard: Bool) {
-                if flashForcedOn {
-                    if hasCard {
-                        self.framesWithFlashCardsAndOcr.append(imageData)
-                    } else {
-                        self.framesWithFlashAndOcr.append(imageData)
-                    }
-                } else if hasCard {
-                    self.framesWithCardsAndOcr.append(imageData)
-                } else {
-                    self.ocrOnlyFrames.append(imageData)
-                }
-            }
-
             // Check if we have a card set to be challenged
-            if let challengedLast4 = self.last4 {
-                guard challengedLast4 == scannedLastFour else {
-                    // The set card to be challenged doesn't match the scanned card.
-                    // Don't use this frame at all.
-                    return
-                }
-
-                // Given that the challenged card matches the frame's pan + last, put frame in appropriate list
-                appendFrameData(flashForcedOn: flashForcedOn, hasCard: hasCard)
-
-            } else {
-                // If we don't have a card set to be challenged just add frameData
-                appendFrameData(flashForcedOn: flashForcedOn, hasCard: hasCard)
+            if let challengedLast4 = self.last4, challengedLast4 != scannedLastFour {
+                // The set card to be challenged doesn't match the scanned card.
+                // Don't use this frame at all.
+                return
             }
 
-            self.balanceFrames()
+            self.hasOcrFrames = true
+            self.retainFrame(
+                imageData: imageData,
+                category: hasCard ? .cardAndOcr : .ocrOnly,
+                flashForcedOn: flashForcedOn
+            )
         }
     }
 
-    private func balanceFrames() {
-        self.framesWithCardsAndOcr = Array(self.framesWithCardsAndOcr.suffix(kMaxScans))
-
-        // make sure that we have a total of kMaxScans across OCR+UX, UX, and OCR frames giving priority to OCR+UX
-        let framesWithCardsToHold =
-            [kMaxScans - self.framesWithCardsAndOcr.count, 0].max() ?? kMaxScans
-        self.framesWithCards = Array(self.framesWithCards.suffix(framesWithCardsToHold))
-
-        let ocrFramesToHold =
-            [kMaxScans - self.framesWithCardsAndOcr.count - self.framesWithCards.count, 0].max()
-            ?? kMaxScans
-        self.ocrOnlyFrames = Array(self.ocrOnlyFrames.suffix(ocrFramesToHold))
-
-        // separately, keep kMaxFlashScans number of frames with the flash on
-        self.framesWithFlashCardsAndOcr = Array(
-            self.framesWithFlashCardsAndOcr.suffix(kMaxFlashScans)
-        )
-
-        let framesWithFlashCardsToHold =
-            [kMaxFlashScans - self.framesWithFlashCardsAndOcr.count, 0].max() ?? kMaxFlashScans
-        self.framesWithFlashAndCards = Array(
-            self.framesWithFlashAndCards.suffix(framesWithFlashCardsToHold)
-        )
-
-        let ocrFlashFramesToHold =
-            [
-                kMaxFlashScans - self.framesWithFlashCardsAndOcr.count
-                    - self.framesWithFlashAndCards.count, 0,
-            ].max() ?? kMaxFlashScans
-        self.framesWithFlashAndOcr = Array(self.framesWithFlashAndOcr.suffix(ocrFlashFramesToHold))
+    // MARK: - Retaining frames
+
+    /// Offers the frame to the retention store, and starts encoding it if the store kept it
+    private func retainFrame(
+        imageData: ScannedCardImageData,
+        category: FrameRetentionStore.Category,
+        flashForcedOn: Bool
+    ) {
+        if retentionStore.offer(imageData, category: category, flashForcedOn: flashForcedOn) {
+            encodeNextFrame()
+        }
     }
 
-    func onResultReady(scannedCardImagesData: [ScannedCardImageData]) {
+    /// Starts encoding the frame waiting in the retention store if an encoder is free, or calls
+    /// `encodingCompletion` once every frame is encoded
+    private func encodeNextFrame() {
+        guard let next = retentionStore.nextFrameToEncode() else {
+            if !retentionStore.isEncoding, !retentionStore.hasWaitingFrame,
+                let completion = encodingCompletion
+            {
+                encodingCompletion = nil
+                completion()
+            }
+            return
+        }
+
+        let imageConfig = acceptedImageConfigs
+        encodingStartTime = encodingStartTime ?? Date()
+        encodingQueue.async {
+            let startTime = Date()
+            let (verificationFramesData, imageMetadata) = next.imageData.toVerificationFramesData(
+                imageConfig: imageConfig
+            )
+            let frame =
+                imageMetadata.imageData.isEmpty
+                ? nil
+                : RetainedFrame(verificationFramesData: verificationFramesData, imageMetadata: imageMetadata)
+            let duration = -startTime.timeIntervalSinceNow
+
+            self.mutexQueue.async {
+                self.encodingDuration += duration
+                self.retentionStore.finishEncoding(sequence: next.sequence, frame: frame)
+                self.encodeNextFrame()
+            }
+        }
+    }
+
+    func onResultReady(retainedFrames: [RetainedFrame], scanStats: ScanStats) {
         // TODO: Run verification pipeline and report back
     }
 
-    func getCompletionLoopFrames() -> [ScannedCardImageData] {
-        let completionLoopFrames =
-            self.framesWithFlashAndOcr + self.framesWithFlashAndCards
-            + self.framesWithFlashCardsAndOcr + self.ocrOnlyFrames + self.framesWithCards
-            + self.framesWithCardsAndOcr
-        return Array(completionLoopFrames.suffix(kMaxScans + kMaxFlashScans))
+    func getCompletionLoopFrames() -> [RetainedFrame] {
+        return retentionStore.retainedFrames
     }
 
     func onScanComplete(scanStats: ScanStats) {
@@ -173,8 +184,14 @@ class CardScanFraudData: ScanEvents {
             }
             self.hasModelBeenCalled = true
 
-            let completionLoopFrames = self.getCompletionLoopFrames()
-            self.onResultReady(scannedCardImagesData: completionLoopFrames)
+            // wait for the frames that were accepted before the scan completed
+            self.encodingCompletion = {
+                var scanStats = scanStats
+                scanStats.update(frameRetention: self.retentionStore)
+                let completionLoopFrames = self.getCompletionLoopFrames()
+                self.onResultReady(retainedFrames: completionLoopFrames, scanStats: scanStats)
+            }
+            self.encodeNextFrame()
         }
     }
 }
@@ -10,8 +10,6 @@ class CardVerifyFraudData: CardScanFraudData {
     var verificationFrameDataResults: [VerificationFramesData]?
     var resultCallbacks: [((_ response: [VerificationFramesData]) -> Void)] = []
 
-    var acceptedImageConfigs: CardImageVerificationAcceptedImageConfigs?
-
     static let maxCompletionLoopFrames = 5
 
     init(
@@ -23,34 +21,20 @@ class CardVerifyFraudData: CardScanFraudData {
         self.acceptedImageConfigs = acceptedImageConfigs
     }
 
-    override func onResultReady(scannedCardImagesData: [ScannedCardImageData]) {
-        DispatchQueue.main.async {
-            let imageCompressionTask = TrackableTask()
-            let processedVerificationFrames = scannedCardImagesData.compactMap {
-                $0.toVerificationFramesData(imageConfig: self.acceptedImageConfigs)
-            }
-            imageCompressionTask.trackResult(
-                processedVerificationFrames.count > 0 ? .success : .failure
-            )
+    override func onResultReady(retainedFrames: [RetainedFrame], scanStats: ScanStats) {
+        /// Frames were encoded as they were accepted, so report the time spent encoding them
+        let imageCompressionTask = TrackableTask(startTime: encodingStartTime ?? Date())
+        imageCompressionTask.trackResult(retainedFrames.count > 0 ? .success : .failure)
+        imageCompressionTask.duration = encodingDuration
+        let payloadInfo = PayloadInfo(retainedFrames: retainedFrames, scanStats: scanStats)
 
-            let verificationFramesData = processedVerificationFrames.compactMap { $0.0 }
-            /// Use the image metadata from the most recent frame
-            let verificationImageMetadata = processedVerificationFrames.compactMap { $0.1 }.last
-
-            /// Calculate the compressed and b64 encoded image sizes in bytes
-            let totalImagePayloadSizeInBytes = verificationFramesData.compactMap { $0.imageData }
-                .reduce(0) { $0 + $1.count }
+        DispatchQueue.main.async {
+            let verificationFramesData = retainedFrames.map { $0.verificationFramesData }
 
-            /// Log the verification payload info + image compression duration
+            /// Log the verification payload info, including how many bytes the frames took up while
+            /// they were kept, and the image compression duration
             ScanAnalyticsManager.shared.trackImageCompressionDuration(task: imageCompressionTask)
-            ScanAnalyticsManager.shared.logPayloadInfo(
-                with: .init(
-                    imageCompressionType: verificationImageMetadata?.compressionType.rawValue
-                        ?? "unknown",
-                    imageCompressionQuality: verificationImageMetadata?.compressionQuality ?? 0.0,
-                    imagePayloadSize: totalImagePayloadSizeInBytes
-                )
-            )
+            ScanAnalyticsManager.shared.logPayloadInfo(with: payloadInfo)
 
             self.verificationFrameDataResults = verificationFramesData
 
@@ -30,6 +30,10 @@ class CardVerifyStateMachine: OcrMainLoopStateMachine, CardVerifyStateMachinePro
     let ocrDelayForCardStateDurationSeconds = 2.0
     let ocrIncorrectDurationSeconds = 2.0
     let ocrForceFlashDurationSeconds = 1.5
+    /// When the error corrected number is clearly ahead of any other reading, ocr&card finishes sooner
+    let ocrAndCardClearLeaderDurationSeconds = 0.75
+    let clearLeaderMargin = 0.8
+    let clearLeaderMinimumVotes = 5.0
 
     init(
         requiredLastFour: String? = nil,
@@ -76,12 +80,18 @@ class CardVerifyStateMachine: OcrMainLoopStateMachine, CardVerifyStateMachinePro
             requiredBin == nil || String(prediction.number?.prefix(6) ?? "") == requiredBin
         let frameOcrMatchesRequired = frameOcrMatchesRequiredBin && frameOcrMatchesRequiredLastFour
         let frameHasCard = prediction.centeredCardState?.hasCard() ?? false
-        let secondsInState = -startTimeForCurrentState.timeIntervalSinceNow
+        let secondsInState = secondsInCurrentState
 
         if frameHasCard && frameOcrMatchesRequired {
             visibleMatchingCardCount += 1
         }
 
+        // only finish early if it can't send us back to the initial state for missing strict mode frames
+        let hasClearLeader =
+            numberConfidence.leaderVotes >= clearLeaderMinimumVotes
+            && numberConfidence.margin >= clearLeaderMargin
+            && visibleMatchingCardCount >= strictModeFramesCount.totalFrameCount
+
         switch (self.state, secondsInState, frameHasOcr, frameHasCard, frameOcrMatchesRequired) {
         // MARK: Initial State
         case (.initial, _, true, true, true):
@@ -114,6 +124,9 @@ class CardVerifyStateMachine: OcrMainLoopStateMachine, CardVerifyStateMachinePro
             return .ocrDelayForCard
 
         // MARK: OCR and Card State
+        case (.ocrAndCard, self.ocrAndCardClearLeaderDurationSeconds..., _, _, _) where hasClearLeader:
+            // the number has settled, no need to wait out the full error correction window
+            return determineFinishedState()
         case (.ocrAndCard, self.ocrAndCardStateDurationSeconds..., _, _, _):
             return determineFinishedState()
 
@@ -148,11 +161,14 @@ class CardVerifyStateMachine: OcrMainLoopStateMachine, CardVerifyStateMachinePro
     }
 
     override func reset() -> MainLoopStateMachine {
-        return CardVerifyStateMachine(
+        let stateMachine = CardVerifyStateMachine(
             requiredLastFour: requiredLastFour,
             requiredBin: requiredBin,
             strictModeFramesCount: strictModeFramesCount
         )
+        stateMachine.now = now
+        stateMachine.startTimeForCurrentState = now()
+        return stateMachine
     }
 }
 
@@ -225,7 +241,7 @@ class CardVerifyAccurateStateMachine: OcrMainLoopStateMachine, CardVerifyStateMa
         let frameOcrMatchesRequired = frameOcrMatchesRequiredBin && frameOcrMatchesRequiredLastFour
         let frameHasCard = prediction.centeredCardState?.hasCard() ?? false
         let hasNameAndExpiry = hasNamePrediction && hasExpiryPrediction
-        let secondsInState = -startTimeForCurrentState.timeIntervalSinceNow
+        let secondsInState = secondsInCurrentState
 
         if frameHasCard && frameOcrMatchesRequired {
             visibleMatchingCardCount += 1
@@ -315,11 +331,14 @@ class CardVerifyAccurateStateMachine: OcrMainLoopStateMachine, CardVerifyStateMa
     }
 
     override func reset() -> MainLoopStateMachine {
-        return CardVerifyAccurateStateMachine(
+        let stateMachine = CardVerifyAccurateStateMachine(
             requiredLastFour: requiredLastFour,
             requiredBin: requiredBin,
             maxNameExpiryDurationSeconds: nameExpiryDurationSeconds,
             strictModeFramesCount: strictModeFramesCount
         )
+        stateMachine.now = now
+        stateMachine.startTimeForCurrentState = now()
+        return stateMachine
     }
 }
@@ -0,0 +1,283 @@
+//
+//  FrameRetentionStore.swift
+//  StripeCardScan
+//
+//  Created by Stripe on 10/17/26.
+//
+
+import CoreGraphics
+import Foundation
+
+/// A frame kept for verification, already encoded in the format the server accepts
+struct RetainedFrame {
+    let verificationFramesData: VerificationFramesData
+    let imageMetadata: CardImageVerificationImageMetadata
+
+    /// The size of the encoded image, which is all that the store keeps for the frame
+    var byteCount: Int {
+        return verificationFramesData.imageData?.count ?? 0
+    }
+}
+
+/// Decides which of the frames accepted during a scan to keep for verification, and holds them
+/// encoded rather than as full resolution images.
+///
+/// Frames are ranked by a `Score`: first by what the models saw in the frame, then by how recent it
+/// is. The store keeps the best `maxFrames` frames captured without the flash and the best
+/// `maxFlashFrames` frames captured with it, which are the same frames that the old per-category
+/// arrays kept. On top of that, the encoded frames never take up more than `byteBudget` bytes; when
+/// they would, the lowest scoring encoded frames are dropped.
+///
+/// Up to `maxConcurrentEncodes` frames are encoded at once. The full resolution images being encoded
+/// are much larger than the encoded frames, so they're held to their own `encodingByteBudget`, and
+/// another encode only starts if its image fits in what's left of it. One encode can always run, so
+/// that a frame larger than the budget still gets encoded. Besides the frames being encoded, only the
+/// best frame of each pool waiting for an encoder is held as an image. A better frame replaces the
+/// waiting one of its pool, so slow encoders drop frames rather than queueing them, and flash frames
+/// never wait behind or get replaced by frames captured without the flash.
+///
+/// # Correctness
+///
+/// The store isn't thread safe. `CardScanFraudData` only uses it on its `mutexQueue`, and only
+/// encodes frames off of that queue.
+final class FrameRetentionStore {
+    /// What the models found in a frame, in increasing order of how useful it is for verification
+    enum Category: Int, Comparable {
+        /// OCR read the number, but the UX model didn't find a card
+        case ocrOnly
+        /// The UX model found a card, but OCR didn't read the number
+        case card
+        /// The UX model found a card and OCR read the number
+        case cardAndOcr
+
+        static func < (lhs: Category, rhs: Category) -> Bool {
+            return lhs.rawValue < rhs.rawValue
+        }
+    }
+
+    struct Score: Comparable {
+        let category: Category
+        /// The order the frame was offered in, so newer frames win ties
+        let sequence: Int
+
+        static func < (lhs: Score, rhs: Score) -> Bool {
+            return (lhs.category, lhs.sequence) < (rhs.category, rhs.sequence)
+        }
+    }
+
+    private enum State {
+        case waiting(ScannedCardImageData)
+        case encoding
+        case encoded(RetainedFrame)
+    }
+
+    private struct Entry {
+        let score: Score
+        let flashForcedOn: Bool
+        let imageByteCount: Int
+        var state: State
+
+        var isWaiting: Bool {
+            if case .waiting = state { return true }
+            return false
+        }
+
+        var isEncoding: Bool {
+            if case .encoding = state { return true }
+            return false
+        }
+
+        var encodedFrame: RetainedFrame? {
+            if case .encoded(let frame) = state { return frame }
+            return nil
+        }
+    }
+
+    let byteBudget: Int
+    let encodingByteBudget: Int
+    let maxFrames: Int
+    let maxFlashFrames: Int
+    let maxConcurrentEncodes: Int
+
+    private var entries: [Entry] = []
+    private var nextSequence = 0
+    /// Image bytes of frames that were being encoded when they were dropped, until they finish
+    private var droppedEncodingBytes: [Int: Int] = [:]
+
+    /// Bytes of the encoded frames currently kept
+    private(set) var retainedBytes = 0
+    /// Bytes held while the frames being encoded and the frame waiting for them are still images
+    private(set) var imageBytes = 0
+    /// Bytes of the images being encoded, including frames dropped while they were being encoded
+    private(set) var encodingBytes = 0
+    /// The most bytes held at once, counting both encoded frames and images
+    private(set) var peakBytes = 0
+    /// The most bytes of images being encoded at once
+    private(set) var peakEncodingBytes = 0
+
+    init(
+        byteBudget: Int,
+        maxFrames: Int,
+        maxFlashFrames: Int,
+        maxConcurrentEncodes: Int = 1,
+        encodingByteBudget: Int = .max
+    ) {
+        self.byteBudget = byteBudget
+        self.encodingByteBudget = encodingByteBudget
+        self.maxFrames = maxFrames
+        self.maxFlashFrames = maxFlashFrames
+        self.maxConcurrentEncodes = max(maxConcurrentEncodes, 1)
+    }
+
+    // MARK: - Accepting frames
+
+    /// Offers a frame to the store, which keeps it if it scores high enough.
+    ///
+    /// - Returns: Whether the frame is now waiting to be encoded
+    @discardableResult
+    func offer(
+        _ imageData: ScannedCardImageData,
+        category: Category,
+        flashForcedOn: Bool
+    ) -> Bool {
+        let score = Score(category: category, sequence: nextSequence)
+        nextSequence += 1
+
+        // make room in the frame's pool by dropping its worst frame, if this one is better
+        var dropped: [Int] = []
+        let limit = flashForcedOn ? maxFlashFrames : maxFrames
+        let pool = entries.indices.filter { entries[$0].flashForcedOn == flashForcedOn }
+        if pool.count >= limit {
+            guard let worst = pool.min(by: { entries[$0].score < entries[$1].score }),
+                entries[worst].score < score
+            else {
+                return false
+            }
+            dropped.append(worst)
+        }
+
+        // and only keep the pool's best frame waiting to be encoded
+        if let waiting = pool.first(where: { entries[$0].isWaiting }), !dropped.contains(waiting) {
+            guard entries[waiting].score < score else { return false }
+            dropped.append(waiting)
+        }
+
+        for index in dropped.sorted(by: >) {
+            remove(at: index)
+        }
+
+        let image = imageData.previewLayerImage
+        let entry = Entry(
+            score: score,
+            flashForcedOn: flashForcedOn,
+            imageByteCount: image.bytesPerRow * image.height,
+            state: .waiting(imageData)
+        )
+        entries.append(entry)
+        imageBytes += entry.imageByteCount
+        updatePeak()
+        return true
+    }
+
+    // MARK: - Encoding
+
+    /// Frames handed out by `nextFrameToEncode()` that haven't finished, including dropped ones
+    var encodingCount: Int {
+        return entries.filter { $0.isEncoding }.count + droppedEncodingBytes.count
+    }
+
+    var isEncoding: Bool {
+        return encodingCount > 0
+    }
+
+    var hasWaitingFrame: Bool {
+        return entries.contains { $0.isWaiting }
+    }
+
+    /// Hands over the oldest waiting frame for encoding, unless `maxConcurrentEncodes` frames are already
+    /// being encoded or its image doesn't fit in what's left of `encodingByteBudget`
+    func nextFrameToEncode() -> (sequence: Int, imageData: ScannedCardImageData)? {
+        guard encodingCount < maxConcurrentEncodes, let index = entries.firstIndex(where: { $0.isWaiting }),
+            case .waiting(let imageData) = entries[index].state
+        else {
+            return nil
+        }
+
+        // the first encode always starts, otherwise frames larger than the budget would never be encoded
+        let imageByteCount = entries[index].imageByteCount
+        guard encodingCount == 0 || encodingBytes + imageByteCount <= encodingByteBudget else {
+            return nil
+        }
+
+        entries[index].state = .encoding
+        encodingBytes += imageByteCount
+        updatePeak()
+        return (entries[index].score.sequence, imageData)
+    }
+
+    /// Stores the encoded frame, or forgets the frame if it couldn't be encoded or was dropped while
+    /// it was being encoded
+    func finishEncoding(sequence: Int, frame: RetainedFrame?) {
+        if let droppedBytes = droppedEncodingBytes.removeValue(forKey: sequence) {
+            imageBytes -= droppedBytes
+            encodingBytes -= droppedBytes
+            return
+        }
+        guard let index = entries.firstIndex(where: { $0.score.sequence == sequence }) else { return }
+        imageBytes -= entries[index].imageByteCount
+        encodingBytes -= entries[index].imageByteCount
+        guard let frame = frame else {
+            entries.remove(at: index)
+            return
+        }
+
+        entries[index].state = .encoded(frame)
+        retainedBytes += frame.byteCount
+        updatePeak()
+        enforceByteBudget()
+    }
+
+    // MARK: - Retained frames
+
+    /// The encoded frames, flash frames first, then from least to most useful and oldest to newest
+    var retainedFrames: [RetainedFrame] {
+        return
+            entries
+            .sorted { ($0.flashForcedOn ? 0 : 1, $0.score) < ($1.flashForcedOn ? 0 : 1, $1.score) }
+            .compactMap { $0.encodedFrame }
+    }
+
+    var retainedFrameCount: Int {
+        return entries.filter { $0.encodedFrame != nil }.count
+    }
+
+    // MARK: - Helpers
+
+    private func remove(at index: Int) {
+        let entry = entries.remove(at: index)
+        switch entry.state {
+        case .waiting:
+            imageBytes -= entry.imageByteCount
+        case .encoding:
+            // the encoder still holds the image, so keep counting it until the encoder is done
+            droppedEncodingBytes[entry.score.sequence] = entry.imageByteCount
+        case .encoded(let frame):
+            retainedBytes -= frame.byteCount
+        }
+    }
+
+    /// Drops the lowest scoring encoded frames until they fit in the budget
+    private func enforceByteBudget() {
+        while retainedBytes > byteBudget,
+            let worst = entries.indices.filter({ entries[$0].encodedFrame != nil })
+                .min(by: { entries[$0].score < entries[$1].score })
+        {
+            remove(at: worst)
+        }
+    }
+
+    private func updatePeak() {
+        peakBytes = max(peakBytes, retainedBytes + imageBytes)
+        peakEncodingBytes = max(peakEncodingBytes, encodingBytes)
+    }
+}
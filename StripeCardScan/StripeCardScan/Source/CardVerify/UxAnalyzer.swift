@@ -9,14 +9,24 @@ import UIKit
 
     static let uxResource = "UxModel"
     static let uxExtension = "mlmodelc"
+    static let imageSize = 224
 
     let ocr: CreditCardOcrImplementation
+    let preprocessor = ModelInputPreprocessor()
+
+    override var instrumentation: ScanInstrumentation {
+        didSet { ocr.instrumentation = instrumentation }
+    }
+
+    override var frameGateStatistics: FrameGateStatistics? {
+        return ocr.frameGateStatistics
+    }
 
     init(
         with ocr: CreditCardOcrImplementation
     ) {
         self.ocr = ocr
-        uxModel = UxAnalyzer.loadModelFromBundle()
+        uxModel = ModelWarmUp.shared.uxModel ?? UxAnalyzer.loadModelFromBundle()
         super.init(dispatchQueue: ocr.dispatchQueue)
     }
 
@@ -41,29 +51,64 @@ import UIKit
         in fullImage: CGImage,
         roiRectangle: CGRect
     ) -> CreditCardOcrPrediction {
-        guard let imageForUxModel = fullImage.squareImageForUxModel(roiRectangle: roiRectangle),
-            let uxModelPixelBuf = UIImage(cgImage: imageForUxModel).pixelBuffer(
-                width: 224,
-                height: 224
-            )
-        else {
-            return CreditCardOcrPrediction.emptyPrediction(cgImage: fullImage)
-        }
-
-        // we already have parallel inference at the analyzer level so no need to run this prediction
-        // in parallel with the OCR prediction. Plus, this is iOS so the uxmodel prediction will be fast
-        guard let uxModel = uxModel,
-            let prediction = try? uxModel.prediction(input1: uxModelPixelBuf)
-        else {
+        guard let prediction = uxPrediction(in: fullImage, roiRectangle: roiRectangle) else {
             return CreditCardOcrPrediction.emptyPrediction(cgImage: fullImage)
         }
 
+        ocr.latestCardState = prediction.cardCenteredState()
         return ocr.recognizeCard(in: fullImage, roiRectangle: roiRectangle).with(
             uxPrediction: prediction
         )
     }
 
+    /// Passes the frame on to `ocr`'s completion handler version so that an OCR implementation that
+    /// waits on other work doesn't block this analyzer's queue
+    override func recognizeCard(
+        in fullImage: CGImage,
+        roiRectangle: CGRect,
+        completion: @escaping (CreditCardOcrPrediction) -> Void
+    ) {
+        guard let prediction = uxPrediction(in: fullImage, roiRectangle: roiRectangle) else {
+            completion(CreditCardOcrPrediction.emptyPrediction(cgImage: fullImage))
+            return
+        }
+
+        ocr.latestCardState = prediction.cardCenteredState()
+        ocr.recognizeCard(in: fullImage, roiRectangle: roiRectangle) { ocrPrediction in
+            completion(ocrPrediction.with(uxPrediction: prediction))
+        }
+    }
+
+    override func cancel() {
+        super.cancel()
+        ocr.cancel()
+    }
+
+    private func uxPrediction(in fullImage: CGImage, roiRectangle: CGRect) -> UxModelOutput? {
+        guard !isCancelled,
+            let uxModelPixelBuf = instrumentation.measure(.imageConversion, {
+                fullImage.squareImageForUxModel(roiRectangle: roiRectangle).flatMap {
+                    preprocessor.pixelBuffer(from: $0, pool: .uxModelInput)
+                }
+            })
+        else {
+            return nil
+        }
+
+        // we already have parallel inference at the analyzer level so no need to run this prediction
+        // in parallel with the OCR prediction. Plus, this is iOS so the uxmodel prediction will be fast
+        return instrumentation.measure(.uxInference) {
+            try? uxModel?.prediction(input1: uxModelPixelBuf)
+        }
+    }
+
     private func loadModel() {
+        // reuse the model from `ModelWarmUp` if the app prewarmed it
+        if let model = ModelWarmUp.shared.uxModel {
+            uxModel = model
+            return
+        }
+
         guard
             let uxModelUrl = StripeCardScanBundleLocator.resourcesBundle.url(
                 forResource: UxAnalyzer.uxResource,
@@ -27,9 +27,12 @@ struct ImageHelpers {
         return (image, roiRectangle)
     }
 
-    static func createBlankCGImage() -> CGImage {
-        let rect = CGRect(origin: .zero, size: CGSize(width: 1, height: 1))
-        UIGraphicsBeginImageContextWithOptions(rect.size, false, 0.0)
+    static func createBlankCGImage(
+        size: CGSize = CGSize(width: 1, height: 1),
+        scale: CGFloat = 0.0
+    ) -> CGImage {
+        let rect = CGRect(origin: .zero, size: size)
+        UIGraphicsBeginImageContextWithOptions(rect.size, false, scale)
         UIColor.black.setFill()
         UIRectFill(rect)
         let image = UIGraphicsGetImageFromCurrentImageContext()
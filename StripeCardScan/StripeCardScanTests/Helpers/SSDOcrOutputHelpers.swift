@@ -0,0 +1,36 @@
+//
+//  SSDOcrOutputHelpers.swift
+//  StripeCardScanTests
+//
+//  Created by Stripe on 10/17/26.
+//
+
+import CoreML
+import UIKit
+
+@testable@_spi(STP) import StripeCardScan
+
+struct SSDOcrOutputHelpers {
+    /// Runs the SSD OCR model once on the synthetic test image and returns its raw output so that
+    /// post-processing can be exercised and benchmarked without running the model again.
+    static func recordedOutput() -> SSDOcrOutput? {
+        let (image, roiRectangle) = ImageHelpers.getTestImageAndRoiRectangle()
+        let configuration = MLModelConfiguration()
+        configuration.computeUnits = .cpuOnly
+
+        guard
+            let cgImage = image.cgImage,
+            let (croppedImage, _) = cgImage.croppedImageForSsd(roiRectangle: roiRectangle),
+            let pixelBuffer = UIImage(cgImage: croppedImage).pixelBuffer(width: 600, height: 375),
+            let url = StripeCardScanBundleLocator.resourcesBundle.url(
+                forResource: SSDOcrDetect.ssdOcrResource,
+                withExtension: SSDOcrDetect.ssdOcrExtension
+            ),
+            let model = try? SSDOcr(contentsOf: url, configuration: configuration)
+        else {
+            return nil
+        }
+
+        return try? model.prediction(input: SSDOcrInput(_0: pixelBuffer))
+    }
+}
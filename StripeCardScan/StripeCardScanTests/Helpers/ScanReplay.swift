@@ -0,0 +1,317 @@
+//
+//  ScanReplay.swift
+//  StripeCardScanTests
+//
+//  Created by Stripe on 10/17/26.
+//
+
+import CoreML
+import UIKit
+
+@testable@_spi(STP) import StripeCardScan
+
+/// The raw SSD OCR output of every frame of a scan, so that everything after the model can be
+/// replayed offline and deterministically.
+///
+/// On disk a recording is a directory with a `recording.json` manifest and, for every frame, three
+/// files with the `scores`, `boxes` and `filter` tensors as contiguous little endian Float32s.
+struct ScanRecording {
+    struct Frame {
+        /// Seconds since the first frame of the scan
+        let timestamp: TimeInterval
+        let output: SSDOcrOutput
+        let imageSize: CGSize
+        let centeredCardState: CenteredCardState?
+    }
+
+    enum RecordingError: Error {
+        case unexpectedTensorSize(String)
+        case unknownCardState(String)
+    }
+
+    static let manifestFileName = "recording.json"
+    static let anchors = 3420
+    static let scoresClasses = 10
+    static let boxesCoordinates = 4
+
+    /// The card number the scan is expected to read, `nil` if unknown
+    let expectedNumber: String?
+    let frames: [Frame]
+
+    /// Records `output` as every frame of a scan at `framesPerSecond`
+    static func repeating(
+        _ output: SSDOcrOutput,
+        frameCount: Int,
+        framesPerSecond: Double = 30.0,
+        imageSize: CGSize = CGSize(width: SSDOcrDetect.imageWidth, height: SSDOcrDetect.imageHeight),
+        centeredCardState: CenteredCardState? = .numberSide,
+        expectedNumber: String?
+    ) -> ScanRecording {
+        let frames = (0..<frameCount).map { index in
+            Frame(
+                timestamp: Double(index) / framesPerSecond,
+                output: output,
+                imageSize: imageSize,
+                centeredCardState: centeredCardState
+            )
+        }
+        return ScanRecording(expectedNumber: expectedNumber, frames: frames)
+    }
+
+    // MARK: - Reading and writing
+
+    private struct Manifest: Codable {
+        struct Frame: Codable {
+            let timestamp: TimeInterval
+            let tensors: String
+            let imageWidth: Double
+            let imageHeight: Double
+            let centeredCardState: String?
+        }
+
+        let expectedNumber: String?
+        let frames: [Frame]
+    }
+
+    static func load(from directory: URL) throws -> ScanRecording {
+        let decoder = JSONDecoder()
+        decoder.keyDecodingStrategy = .convertFromSnakeCase
+        let manifest = try decoder.decode(
+            Manifest.self,
+            from: Data(contentsOf: directory.appendingPathComponent(manifestFileName))
+        )
+
+        let frames = try manifest.frames.map { frame -> Frame in
+            let tensors = directory.appendingPathComponent(frame.tensors)
+            let output = SSDOcrOutput(
+                scores: try readTensor(tensors.appendingPathExtension("scores"), columns: scoresClasses),
+                boxes: try readTensor(tensors.appendingPathExtension("boxes"), columns: boxesCoordinates),
+                filter: try readTensor(tensors.appendingPathExtension("filter"), columns: 1)
+            )
+            return Frame(
+                timestamp: frame.timestamp,
+                output: output,
+                imageSize: CGSize(width: frame.imageWidth, height: frame.imageHeight),
+                centeredCardState: try frame.centeredCardState.map(cardState(named:))
+            )
+        }
+        return ScanRecording(expectedNumber: manifest.expectedNumber, frames: frames)
+    }
+
+    func write(to directory: URL) throws {
+        try FileManager.default.createDirectory(at: directory, withIntermediateDirectories: true)
+
+        var manifestFrames: [Manifest.Frame] = []
+        for (index, frame) in frames.enumerated() {
+            let name = String(format: "frame_%04d", index)
+            let tensors = directory.appendingPathComponent(name)
+            try ScanRecording.writeTensor(frame.output.scores, to: tensors.appendingPathExtension("scores"))
+            try ScanRecording.writeTensor(frame.output.boxes, to: tensors.appendingPathExtension("boxes"))
+            try ScanRecording.writeTensor(frame.output.filter, to: tensors.appendingPathExtension("filter"))
+            manifestFrames.append(
+                Manifest.Frame(
+                    timestamp: frame.timestamp,
+                    tensors: name,
+                    imageWidth: Double(frame.imageSize.width),
+                    imageHeight: Double(frame.imageSize.height),
+                    centeredCardState: frame.centeredCardState.map(ScanRecording.name(of:))
+                )
+            )
+        }
+
+        let encoder = JSONEncoder()
+        encoder.keyEncodingStrategy = .convertToSnakeCase
+        encoder.outputFormatting = [.prettyPrinted, .sortedKeys]
+        try encoder.encode(Manifest(expectedNumber: expectedNumber, frames: manifestFrames))
+            .write(to: directory.appendingPathComponent(ScanRecording.manifestFileName))
+    }
+
+    /// Reads an (1, 1, 1, anchors, columns) Float32 tensor
+    private static func readTensor(_ url: URL, columns: Int) throws -> MLMultiArray {
+        let data = try Data(contentsOf: url)
+        let count = anchors * columns
+        guard data.count == count * MemoryLayout<Float32>.size else {
+            throw RecordingError.unexpectedTensorSize(url.lastPathComponent)
+        }
+
+        let array = try MLMultiArray(
+            shape: [1, 1, 1, NSNumber(value: anchors), NSNumber(value: columns)],
+            dataType: .float32
+        )
+        let pointer = array.dataPointer.bindMemory(to: Float32.self, capacity: count)
+        data.withUnsafeBytes { bytes in
+            for index in 0..<count {
+                pointer[index] = Float32(
+                    bitPattern: UInt32(littleEndian: bytes.load(fromByteOffset: index * 4, as: UInt32.self))
+                )
+            }
+        }
+        return array
+    }
+
+    /// Writes the last two dimensions of `array` contiguously, model outputs can be padded
+    private static func writeTensor(_ array: MLMultiArray, to url: URL) throws {
+        let rows = array.shape[3].intValue
+        let columns = array.shape[4].intValue
+        let rowStride = array.strides[3].intValue
+        let columnStride = array.strides[4].intValue
+        let pointer = array.dataPointer.bindMemory(to: Float32.self, capacity: rows * rowStride)
+
+        var data = Data(capacity: rows * columns * MemoryLayout<Float32>.size)
+        for row in 0..<rows {
+            for column in 0..<columns {
+                var bits = pointer[row * rowStride + column * columnStride].bitPattern.littleEndian
+                withUnsafeBytes(of: &bits) { data.append(contentsOf: $0) }
+            }
+        }
+        try data.write(to: url)
+    }
+
+    private static func name(of state: CenteredCardState) -> String {
+        switch state {
+        case .numberSide: return "number_side"
+        case .nonNumberSide: return "non_number_side"
+        case .noCard: return "no_card"
+        }
+    }
+
+    private static func cardState(named name: String) throws -> CenteredCardState {
+        switch name {
+        case "number_side": return .numberSide
+        case "non_number_side": return .nonNumberSide
+        case "no_card": return .noCard
+        default: throw RecordingError.unknownCardState(name)
+        }
+    }
+}
+
+/// Replays a `ScanRecording` through SSD OCR post-processing, error correction and a state machine,
+/// on a virtual clock driven by the recorded timestamps.
+///
+/// Replays don't depend on how fast the machine running them is: state durations come from the
+/// recording, so the same recording always finishes on the same frame with the same number.
+struct ScanReplay {
+    /// Wall clock latencies of one stage, in seconds
+    struct StageLatencies {
+        private(set) var samples: [TimeInterval] = []
+
+        mutating func append(_ sample: TimeInterval) {
+            samples.append(sample)
+        }
+
+        /// Nearest rank percentile, `percentile` between 0 and 100
+        func percentile(_ percentile: Double) -> TimeInterval {
+            guard !samples.isEmpty else { return 0 }
+            let sorted = samples.sorted()
+            let rank = Int((percentile / 100.0 * Double(sorted.count)).rounded(.up))
+            return sorted[min(max(rank, 1), sorted.count) - 1]
+        }
+
+        var summary: String {
+            return String(
+                format: "p50 %.3fms p90 %.3fms p99 %.3fms",
+                percentile(50) * 1000,
+                percentile(90) * 1000,
+                percentile(99) * 1000
+            )
+        }
+    }
+
+    struct Report {
+        var decode = StageLatencies()
+        var suppressDigits = StageLatencies()
+        var readNumber = StageLatencies()
+        var errorCorrection = StageLatencies()
+
+        /// The number read from each frame, before error correction
+        var frameNumbers: [String?] = []
+        var finalState: MainLoopState = .initial
+        var finalNumber: String?
+        /// Virtual seconds from the first frame until the state machine finished, `nil` if it didn't
+        var timeToFinish: TimeInterval?
+        var expectedNumber: String?
+
+        /// `nil` if the recording doesn't know the expected number
+        var isCorrect: Bool? {
+            return expectedNumber.map { $0 == finalNumber }
+        }
+
+        var summary: String {
+            return """
+                decode: \(decode.summary)
+                suppress digits: \(suppressDigits.summary)
+                read number: \(readNumber.summary)
+                error correction: \(errorCorrection.summary)
+                final state: \(finalState), time to finish: \(timeToFinish.map { "\($0)s" } ?? "-")
+                correct: \(isCorrect.map { "\($0)" } ?? "unknown")
+                """
+        }
+    }
+
+    let recording: ScanRecording
+
+    /// - Parameter stateMachine: A fresh state machine, its clock is replaced by the virtual clock
+    func run(
+        stateMachine: OcrMainLoopStateMachine = OcrMainLoopStateMachine(),
+        voteDecay: Double = 1.0
+    ) -> Report {
+        let startDate = Date(timeIntervalSinceReferenceDate: 0)
+        var virtualNow = startDate
+        stateMachine.now = { virtualNow }
+        stateMachine.startTimeForCurrentState = startDate
+
+        let ssdOcrDetect = SSDOcrDetect()
+        let errorCorrection = ErrorCorrection(stateMachine: stateMachine, voteDecay: voteDecay)
+        let image = ImageHelpers.createBlankCGImage()
+
+        var report = Report()
+        report.expectedNumber = recording.expectedNumber
+        report.frameNumbers.reserveCapacity(recording.frames.count)
+
+        for frame in recording.frames {
+            virtualNow = startDate.addingTimeInterval(frame.timestamp)
+
+            var number: String?
+            var startTime = Date()
+            let decoded = ssdOcrDetect.decode(prediction: frame.output)
+            report.decode.append(-startTime.timeIntervalSinceNow)
+            if decoded {
+                startTime = Date()
+                let boxes = ssdOcrDetect.suppressDigits(imageSize: frame.imageSize)
+                report.suppressDigits.append(-startTime.timeIntervalSinceNow)
+
+                startTime = Date()
+                number = ssdOcrDetect.readNumber(from: boxes)
+                report.readNumber.append(-startTime.timeIntervalSinceNow)
+            }
+            report.frameNumbers.append(number)
+
+            let prediction = CreditCardOcrPrediction(
+                image: image,
+                ocrCroppingRectangle: CGRect(origin: .zero, size: frame.imageSize),
+                number: number,
+                expiryMonth: nil,
+                expiryYear: nil,
+                name: nil,
+                computationTime: 0.0,
+                numberBoxes: number.map { _ in ssdOcrDetect.lastDetectedBoxes },
+                expiryBoxes: nil,
+                nameBoxes: nil,
+                centeredCardState: frame.centeredCardState
+            )
+
+            startTime = Date()
+            _ = errorCorrection.add(prediction: prediction)
+            report.errorCorrection.append(-startTime.timeIntervalSinceNow)
+
+            report.finalState = stateMachine.loopState()
+            report.finalNumber = errorCorrection.number
+            if report.finalState == .finished {
+                report.timeToFinish = frame.timestamp
+                break
+            }
+        }
+
+        return report
+    }
+}
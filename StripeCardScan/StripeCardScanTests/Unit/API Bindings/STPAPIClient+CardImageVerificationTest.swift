@@ -10,7 +10,7 @@ import OHHTTPStubsSwift
 import StripeCoreTestUtils
 import XCTest
 
-@testable import StripeCardScan
+@testable@_spi(STP) import StripeCardScan
 @testable@_spi(STP) import StripeCore
 
 class STPAPIClient_CardImageVerificationTest: APIStubbedTestCase {
@@ -290,6 +290,114 @@ class STPAPIClient_CardImageVerificationTest: APIStubbedTestCase {
         wait(for: [exp], timeout: 1)
     }
 
+    /// The following test is mocking a flow where the collected verification frames are submitted as a multipart form
+    /// It will check the following:
+    /// 1. The request URL has been constructed properly: /v1/card_image_verifications/:id/verify_frames
+    /// 2. The request body is multipart/form-data, with each image as a binary part rather than base64
+    /// 3. The response from request is empty
+    func testSubmitVerificationFrames_Multipart() throws {
+        let jpegData = Data([0xFF, 0xD8, 0xFF, 0xE0]) + Data(repeating: 0x80, count: 1_000)
+        let verificationFramesData = [
+            VerificationFramesData(
+                imageData: jpegData,
+                viewfinderMargins: ViewFinderMargins(left: 1, upper: 2, right: 3, lower: 4)
+            ),
+            VerificationFramesData(
+                imageData: jpegData,
+                viewfinderMargins: ViewFinderMargins(left: 5, upper: 6, right: 7, lower: 8)
+            ),
+        ]
+
+        let mockResponse = "{}".data(using: .utf8)!
+
+        // Stub the request to submit verify frames
+        stub { request in
+            guard let httpBody = request.ohhttpStubs_httpBody,
+                let contentType = request.value(forHTTPHeaderField: "Content-Type")
+            else {
+                XCTFail("Expected an httpBody and Content-Type but found none")
+                return false
+            }
+
+            XCTAssertEqual(
+                request.url?.absoluteString.contains(
+                    "v1/card_image_verifications/\(CIVIntentMockData.id)/verify_frames"
+                ),
+                true
+            )
+            XCTAssertTrue(contentType.hasPrefix("multipart/form-data; boundary="))
+            XCTAssertEqual(request.value(forHTTPHeaderField: "Content-Length"), String(httpBody.count))
+
+            /// Rebuild the body with the request's boundary, which is random
+            let boundary = String(contentType.dropFirst("multipart/form-data; boundary=".count))
+            var expectedBody = VerificationFramesMultipartBody(
+                clientSecret: CIVIntentMockData.clientSecret,
+                boundary: boundary
+            )
+            verificationFramesData.forEach { expectedBody.append($0) }
+            XCTAssertEqual(httpBody, expectedBody.finish())
+
+            /// The images are sent as is, so the body is barely bigger than them
+            XCTAssertNotNil(httpBody.range(of: jpegData))
+            XCTAssertLessThan(httpBody.count, 2 * jpegData.count + 2_000)
+            XCTAssertEqual(request.httpMethod, "POST")
+
+            return true
+        } response: { _ in
+            return HTTPStubsResponse(data: mockResponse, statusCode: 200, headers: nil)
+        }
+
+        let exp = expectation(description: "Request completed")
+
+        /// Make request to submit verification frames
+        let apiClient = stubbedAPIClient()
+        let promise = apiClient.submitVerificationFrames(
+            cardImageVerificationId: CIVIntentMockData.id,
+            cardImageVerificationSecret: CIVIntentMockData.clientSecret,
+            verificationFramesData: verificationFramesData,
+            uploadMode: .multipart
+        )
+
+        promise.observe { result in
+            switch result {
+            /// The successful response is an empty struct
+            case .success:
+                XCTAssert(true, "A response has been returned")
+            case .failure(let error):
+                XCTFail("Request returned error \(error)")
+            }
+            exp.fulfill()
+        }
+
+        wait(for: [exp], timeout: 1)
+    }
+
+    func testVerificationFramesMultipartBody() {
+        var body = VerificationFramesMultipartBody(clientSecret: "secret", boundary: "boundary")
+        body.append(
+            VerificationFramesData(
+                imageData: Data([0, 0, 0, 24]) + Data("ftypheic".utf8),
+                viewfinderMargins: ViewFinderMargins(left: 1, upper: 2, right: 3, lower: 4)
+            )
+        )
+        let text = String(decoding: body.finish(), as: UTF8.self)
+
+        XCTAssertTrue(
+            text.hasPrefix("--boundary\r\nContent-Disposition: form-data; name=\"client_secret\"\r\n\r\nsecret\r\n")
+        )
+        XCTAssertTrue(
+            text.contains(
+                "Content-Disposition: form-data; name=\"verification_frames_data[0][image_data]\"; "
+                    + "filename=\"frame_0.heic\"\r\nContent-Type: image/heic\r\n"
+            )
+        )
+        XCTAssertTrue(
+            text.contains("name=\"verification_frames_data[0][viewfinder_margins][lower]\"\r\n\r\n4\r\n")
+        )
+        XCTAssertTrue(text.hasSuffix("--boundary--\r\n"))
+        XCTAssertEqual(body.frameCount, 1)
+    }
+
     /// The following test is mocking a flow where the collected scan analytics are uploaded to the server
     /// It will check the following
     /// 1. The request URL has been constructed properly: /v1/card_image_verifications/:id/scan_stats
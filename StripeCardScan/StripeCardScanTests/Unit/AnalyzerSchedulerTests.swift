@@ -0,0 +1,135 @@
+//
+//  AnalyzerSchedulerTests.swift
+//  StripeCardScanTests
+//
+//  Created by Stripe on 10/17/26.
+//
+
+import XCTest
+
+@testable@_spi(STP) import StripeCardScan
+
+class AnalyzerSchedulerTests: XCTestCase {
+
+    var currentTime = Date(timeIntervalSince1970: 0)
+    var thermalState = ProcessInfo.ThermalState.nominal
+
+    var fast: CreditCardOcrImplementation!
+    var slow: CreditCardOcrImplementation!
+    var scheduler: AnalyzerScheduler!
+
+    override func setUp() {
+        super.setUp()
+        fast = CreditCardOcrImplementation(dispatchQueueLabel: "fast")
+        slow = CreditCardOcrImplementation(dispatchQueueLabel: "slow")
+        scheduler = AnalyzerScheduler(
+            minimumSamples: 3,
+            basePauseDuration: 1.0,
+            now: { [unowned self] in self.currentTime },
+            thermalState: { [unowned self] in self.thermalState }
+        )
+    }
+
+    func testTakesAnalyzersInIdleOrderUntilMeasured() {
+        var idle: [CreditCardOcrImplementation] = [fast, slow]
+
+        XCTAssertTrue(scheduler.nextAnalyzer(from: &idle) === slow)
+        XCTAssertEqual(scheduler.policy, .roundRobin)
+        XCTAssertTrue(scheduler.nextAnalyzer(from: &idle) === fast)
+        XCTAssertNil(scheduler.nextAnalyzer(from: &idle))
+    }
+
+    func testPrefersAnalyzerWithBestYield() {
+        for _ in 0..<3 {
+            scheduler.record(analyzer: fast, latency: 0.05, hit: true)
+            scheduler.record(analyzer: slow, latency: 0.5, hit: true)
+        }
+
+        var idle: [CreditCardOcrImplementation] = [fast, slow]
+        XCTAssertTrue(scheduler.nextAnalyzer(from: &idle) === fast)
+        XCTAssertEqual(scheduler.policy, .yieldWeighted)
+        XCTAssertEqual(idle.count, 1)
+    }
+
+    func testMovingAveragesFollowMeasurements() {
+        scheduler.record(analyzer: fast, latency: 1.0, hit: true)
+        scheduler.record(analyzer: fast, latency: 2.0, hit: false)
+
+        let stats = scheduler.stats(for: fast)
+        XCTAssertEqual(stats.latency, 1.2, accuracy: 1e-9)
+        XCTAssertEqual(stats.hitRate, 0.8, accuracy: 1e-9)
+        XCTAssertEqual(stats.samples, 2)
+    }
+
+    func testPausesLowYieldAnalyzerUntilPauseExpires() {
+        for _ in 0..<3 {
+            scheduler.record(analyzer: fast, latency: 0.05, hit: true)
+            scheduler.record(analyzer: slow, latency: 0.5, hit: false)
+        }
+        XCTAssertEqual(scheduler.pauseCount, 1)
+
+        var idle: [CreditCardOcrImplementation] = [slow]
+        XCTAssertNil(scheduler.nextAnalyzer(from: &idle))
+        XCTAssertEqual(scheduler.policy, .throttled)
+
+        currentTime = currentTime.addingTimeInterval(1.5)
+        XCTAssertTrue(scheduler.nextAnalyzer(from: &idle) === slow)
+    }
+
+    func testPausesLongerWhenDeviceIsHot() {
+        thermalState = .serious
+        for _ in 0..<3 {
+            scheduler.record(analyzer: fast, latency: 0.05, hit: true)
+            scheduler.record(analyzer: slow, latency: 0.5, hit: false)
+        }
+
+        var idle: [CreditCardOcrImplementation] = [slow]
+        currentTime = currentTime.addingTimeInterval(1.5)
+        XCTAssertNil(scheduler.nextAnalyzer(from: &idle))
+        currentTime = currentTime.addingTimeInterval(3.0)
+        XCTAssertTrue(scheduler.nextAnalyzer(from: &idle) === slow)
+    }
+
+    // Apple's OCR often misses the number, but it's the only analyzer that reads expiries and names
+    func testDoesNotPauseAnalyzerThatOnlyReadsExpiry() {
+        let image = ImageHelpers.createBlankCGImage()
+        let numberPrediction = prediction(image: image, number: "4242424242424242", expiryMonth: nil)
+        let expiryPrediction = prediction(image: image, number: nil, expiryMonth: "12")
+
+        for _ in 0..<10 {
+            scheduler.record(analyzer: fast, latency: 0.05, prediction: numberPrediction)
+            scheduler.record(analyzer: slow, latency: 0.5, prediction: expiryPrediction)
+        }
+
+        XCTAssertEqual(scheduler.pauseCount, 0)
+        XCTAssertEqual(scheduler.stats(for: slow).hitRate, 1.0, accuracy: 1e-9)
+        var idle: [CreditCardOcrImplementation] = [slow]
+        XCTAssertTrue(scheduler.nextAnalyzer(from: &idle) === slow)
+    }
+
+    func testNeverPausesEveryAnalyzer() {
+        for _ in 0..<3 {
+            scheduler.record(analyzer: fast, latency: 0.05, hit: false)
+            scheduler.record(analyzer: slow, latency: 0.5, hit: false)
+        }
+
+        XCTAssertEqual(scheduler.pauseCount, 0)
+    }
+
+    // MARK: - Helpers
+
+    func prediction(image: CGImage, number: String?, expiryMonth: String?) -> CreditCardOcrPrediction {
+        return CreditCardOcrPrediction(
+            image: image,
+            ocrCroppingRectangle: .zero,
+            number: number,
+            expiryMonth: expiryMonth,
+            expiryYear: expiryMonth.map { _ in "30" },
+            name: nil,
+            computationTime: 0.0,
+            numberBoxes: nil,
+            expiryBoxes: nil,
+            nameBoxes: nil
+        )
+    }
+}
@@ -0,0 +1,65 @@
+//
+//  CardVerifyFraudDataTests.swift
+//  StripeCardScanTests
+//
+//  Created by Stripe on 10/17/26.
+//
+
+import XCTest
+
+@testable@_spi(STP) import StripeCardScan
+
+class CardVerifyFraudDataTests: XCTestCase {
+    override func setUp() {
+        super.setUp()
+        ScanAnalyticsManager.shared.reset()
+    }
+
+    func testResultReadyLogsFrameRetentionInPayloadInfo() {
+        let fraudData = CardVerifyFraudData()
+        var scanStats = ScanStats()
+        scanStats.peakRetainedFrameBytes = 9_000
+        scanStats.retainedFrames = 2
+
+        fraudData.onResultReady(
+            retainedFrames: [frame(byteCount: 1_000), frame(byteCount: 3_000)],
+            scanStats: scanStats
+        )
+
+        let resultExp = expectation(description: "Result is ready")
+        fraudData.result { _ in
+            resultExp.fulfill()
+        }
+        wait(for: [resultExp], timeout: 1)
+
+        let payloadExp = expectation(description: "Generated the scan analytics payload")
+        var payloadInfo: PayloadInfo?
+        ScanAnalyticsManager.shared.generateScanAnalyticsPayload(with: .init()) { payload in
+            payloadInfo = payload?.payloadInfo
+            payloadExp.fulfill()
+        }
+        wait(for: [payloadExp], timeout: 1)
+
+        XCTAssertEqual(payloadInfo?.imagePayloadSize, 4_000)
+        XCTAssertEqual(payloadInfo?.peakRetainedFrameBytes, 9_000)
+        XCTAssertEqual(payloadInfo?.retainedFrames, 2)
+        XCTAssertEqual(payloadInfo?.imageCompressionType, "jpeg")
+    }
+
+    // MARK: - Helpers
+
+    func frame(byteCount: Int) -> RetainedFrame {
+        return RetainedFrame(
+            verificationFramesData: VerificationFramesData(
+                imageData: Data(count: byteCount),
+                viewfinderMargins: ViewFinderMargins(left: 0, upper: 0, right: 0, lower: 0)
+            ),
+            imageMetadata: CardImageVerificationImageMetadata(
+                imageData: Data(count: byteCount),
+                imageSize: .zero,
+                compressionType: .jpeg,
+                compressionQuality: 0.8
+            )
+        )
+    }
+}
@@ -0,0 +1,97 @@
+//
+//  CreditCardOcrImplementationTests.swift
+//  StripeCardScanTests
+//
+//  Created by Stripe on 10/17/26.
+//
+
+import XCTest
+
+@testable@_spi(STP) import StripeCardScan
+
+class CreditCardOcrImplementationTests: XCTestCase {
+
+    /// Reads the same number from every frame and counts how often it ran
+    class StubOcr: CreditCardOcrImplementation {
+        var recognizeCount = 0
+
+        override func recognizeCard(in fullImage: CGImage, roiRectangle: CGRect) -> CreditCardOcrPrediction {
+            recognizeCount += 1
+            return CreditCardOcrPrediction(
+                image: fullImage,
+                ocrCroppingRectangle: roiRectangle,
+                number: "4242424242424242",
+                expiryMonth: nil,
+                expiryYear: nil,
+                name: nil,
+                computationTime: 0.0,
+                numberBoxes: nil,
+                expiryBoxes: nil,
+                nameBoxes: nil
+            )
+        }
+    }
+
+    let image = ImageHelpers.createBlankCGImage()
+    let roiRectangle = CGRect(x: 0, y: 0, width: 1, height: 1)
+
+    func testCompletionHandlerRecognizeMatchesSync() {
+        let ocr = StubOcr(dispatchQueueLabel: "test")
+
+        var prediction: CreditCardOcrPrediction?
+        ocr.recognizeCard(in: image, roiRectangle: roiRectangle) { prediction = $0 }
+
+        XCTAssertEqual(prediction?.number, "4242424242424242")
+        XCTAssertEqual(ocr.recognizeCount, 1)
+        XCTAssertFalse(ocr.isCancelled)
+    }
+
+    func testCancelledAnalyzerSkipsRecognition() {
+        let ocr = StubOcr(dispatchQueueLabel: "test")
+        ocr.cancel()
+
+        var prediction: CreditCardOcrPrediction?
+        ocr.recognizeCard(in: image, roiRectangle: roiRectangle) { prediction = $0 }
+
+        XCTAssertNotNil(prediction)
+        XCTAssertNil(prediction?.number)
+        XCTAssertEqual(ocr.recognizeCount, 0)
+    }
+
+    func testUxAnalyzerCancelsItsOcr() {
+        let ocr = StubOcr(dispatchQueueLabel: "test")
+        let uxAnalyzer = UxAnalyzer(with: ocr)
+        uxAnalyzer.cancel()
+
+        XCTAssertTrue(ocr.isCancelled)
+    }
+
+    func testRecognizesBatchOneFrameAtATimeByDefault() {
+        let ocr = StubOcr(dispatchQueueLabel: "test")
+        let frames = [(image: image, roiRectangle: roiRectangle), (image: image, roiRectangle: roiRectangle)]
+
+        var predictions: [CreditCardOcrPrediction]?
+        ocr.recognizeCards(in: frames) { predictions = $0 }
+
+        XCTAssertEqual(predictions?.map { $0.number }, ["4242424242424242", "4242424242424242"])
+        XCTAssertEqual(ocr.recognizeCount, 2)
+        XCTAssertEqual(ocr.maxBatchSize, 1)
+    }
+
+    func testAppleOcrCompletesWithoutBlocking() throws {
+        let (image, roiRectangle) = ImageHelpers.getTestImageAndRoiRectangle()
+        let cgImage = try XCTUnwrap(image.cgImage)
+        let ocr = AppleCreditCardOcr(dispatchQueueLabel: "test")
+
+        let recognized = expectation(description: "Recognized the card")
+        var prediction: CreditCardOcrPrediction?
+        ocr.recognizeCard(in: cgImage, roiRectangle: roiRectangle) {
+            prediction = $0
+            recognized.fulfill()
+        }
+        wait(for: [recognized], timeout: 10)
+
+        XCTAssertNotNil(prediction?.number)
+        XCTAssertEqual(ocr.frames, 1)
+    }
+}
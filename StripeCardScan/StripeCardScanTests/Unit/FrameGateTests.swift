@@ -0,0 +1,76 @@
+//
+//  FrameGateTests.swift
+//  StripeCardScanTests
+//
+//  Created by Stripe on 10/17/26.
+//
+
+import CoreGraphics
+import XCTest
+
+@testable@_spi(STP) import StripeCardScan
+
+class FrameGateTests: XCTestCase {
+    func testReusesResultForNearDuplicateFrames() {
+        let gate = FrameGate(duplicateThreshold: 2.0, maxConsecutiveSkips: 10)
+
+        XCTAssertEqual(gate.decision(for: image(gray: 100), cardState: .numberSide), .analyze)
+        XCTAssertEqual(gate.decision(for: image(gray: 100), cardState: .numberSide), .reuseLast)
+        XCTAssertEqual(gate.decision(for: image(gray: 180), cardState: .numberSide), .analyze)
+    }
+
+    func testComparesWithLastAnalyzedFrame() {
+        let gate = FrameGate(duplicateThreshold: 2.0, maxConsecutiveSkips: 10)
+
+        XCTAssertEqual(gate.decision(for: image(gray: 100), cardState: nil), .analyze)
+        XCTAssertEqual(gate.decision(for: image(gray: 101), cardState: nil), .reuseLast)
+        // only 1 away from the previous frame, but 2 away from the one that was analyzed
+        XCTAssertEqual(gate.decision(for: image(gray: 102), cardState: nil), .analyze)
+    }
+
+    func testSkipsFramesWithoutCard() {
+        let gate = FrameGate(duplicateThreshold: 2.0, maxConsecutiveSkips: 10)
+
+        XCTAssertEqual(gate.decision(for: image(gray: 100), cardState: .noCard), .skipNoCard)
+        XCTAssertEqual(gate.decision(for: image(gray: 100), cardState: .nonNumberSide), .analyze)
+    }
+
+    func testAnalyzesAfterTooManySkips() {
+        let gate = FrameGate(duplicateThreshold: 2.0, maxConsecutiveSkips: 2)
+
+        let decisions = (0..<6).map { _ in gate.decision(for: image(gray: 50), cardState: .numberSide) }
+        XCTAssertEqual(decisions, [.analyze, .reuseLast, .reuseLast, .analyze, .reuseLast, .reuseLast])
+
+        let noCardDecisions = (0..<3).map { _ in gate.decision(for: image(gray: 50), cardState: .noCard) }
+        XCTAssertEqual(noCardDecisions, [.analyze, .skipNoCard, .skipNoCard])
+
+        XCTAssertEqual(gate.statistics, FrameGateStatistics(analyzed: 3, skippedNoCard: 2, reusedLast: 4))
+    }
+
+    func testStatisticsAddUp() {
+        let sum =
+            FrameGateStatistics(analyzed: 1, skippedNoCard: 2, reusedLast: 3)
+            + FrameGateStatistics(analyzed: 10, skippedNoCard: 20, reusedLast: 30)
+        XCTAssertEqual(sum, FrameGateStatistics(analyzed: 11, skippedNoCard: 22, reusedLast: 33))
+    }
+
+    // MARK: - Helpers
+
+    func image(gray: UInt8) -> CGImage {
+        let width = 60
+        let height = 40
+        var pixels = [UInt8](repeating: gray, count: width * height)
+        return pixels.withUnsafeMutableBytes { bytes in
+            let context = CGContext(
+                data: bytes.baseAddress,
+                width: width,
+                height: height,
+                bitsPerComponent: 8,
+                bytesPerRow: width,
+                space: CGColorSpaceCreateDeviceGray(),
+                bitmapInfo: CGImageAlphaInfo.none.rawValue
+            )
+            return context!.makeImage()!
+        }
+    }
+}
@@ -0,0 +1,321 @@
+//
+//  FrameRetentionStoreTests.swift
+//  StripeCardScanTests
+//
+//  Created by Stripe on 10/17/26.
+//
+
+import StripeCoreTestUtils
+import XCTest
+
+@testable@_spi(STP) import StripeCardScan
+
+class FrameRetentionStoreTests: XCTestCase {
+    typealias Category = FrameRetentionStore.Category
+
+    let image = ImageHelpers.createBlankCGImage()
+
+    func testKeepsSameFramesAsPerCategoryArrays() {
+        var generator = SplitMix64(seed: 0xF4A3E)
+        let categories: [Category] = [.ocrOnly, .card, .cardAndOcr]
+
+        for _ in 0..<200 {
+            let store = FrameRetentionStore(byteBudget: .max, maxFrames: 5, maxFlashFrames: 3)
+            var reference = ReferenceFrameArrays()
+
+            for id in 0..<Int(generator.next() % 40) {
+                let category = categories[Int(generator.next() % 3)]
+                let flashForcedOn = generator.next() % 4 == 0
+                reference.append(id, category: category, flashForcedOn: flashForcedOn)
+                if store.offer(imageData(), category: category, flashForcedOn: flashForcedOn) {
+                    encodeWaitingFrame(in: store, id: id, byteCount: 10)
+                }
+            }
+
+            XCTAssertEqual(ids(in: store), reference.frames)
+        }
+    }
+
+    func testByteBudgetDropsLowestScoringFrames() {
+        let store = FrameRetentionStore(byteBudget: 250, maxFrames: 5, maxFlashFrames: 3)
+
+        for (id, category) in [Category.cardAndOcr, .card, .cardAndOcr, .ocrOnly].enumerated() {
+            XCTAssertTrue(store.offer(imageData(), category: category, flashForcedOn: false))
+            encodeWaitingFrame(in: store, id: id, byteCount: 100)
+        }
+
+        XCTAssertEqual(ids(in: store), [0, 2])
+        XCTAssertEqual(store.retainedBytes, 200)
+        XCTAssertEqual(store.imageBytes, 0)
+        // the most is either three encoded frames, or two and the image of the third
+        XCTAssertEqual(store.peakBytes, max(300, 200 + image.bytesPerRow * image.height))
+    }
+
+    func testOnlyBestFrameOfPoolWaitsWhileEncoding() {
+        let store = FrameRetentionStore(byteBudget: .max, maxFrames: 5, maxFlashFrames: 3)
+
+        XCTAssertTrue(store.offer(imageData(), category: .card, flashForcedOn: false))
+        let encoding = store.nextFrameToEncode()
+        XCTAssertNotNil(encoding)
+        XCTAssertTrue(store.isEncoding)
+
+        XCTAssertTrue(store.offer(imageData(), category: .cardAndOcr, flashForcedOn: false))
+        XCTAssertFalse(store.offer(imageData(), category: .card, flashForcedOn: false))
+        XCTAssertTrue(store.offer(imageData(), category: .cardAndOcr, flashForcedOn: false))
+        XCTAssertNil(store.nextFrameToEncode())
+
+        // one frame being encoded and one waiting, never more
+        XCTAssertEqual(store.imageBytes, 2 * image.bytesPerRow * image.height)
+
+        store.finishEncoding(sequence: encoding!.sequence, frame: frame(id: 0, byteCount: 10))
+        XCTAssertTrue(store.hasWaitingFrame)
+        encodeWaitingFrame(in: store, id: 3, byteCount: 10)
+
+        XCTAssertEqual(ids(in: store), [0, 3])
+        XCTAssertFalse(store.isEncoding)
+        XCTAssertFalse(store.hasWaitingFrame)
+    }
+
+    func testFlashFrameWaitsAlongsideNonFlashFrame() {
+        let store = FrameRetentionStore(byteBudget: .max, maxFrames: 5, maxFlashFrames: 3)
+
+        XCTAssertTrue(store.offer(imageData(), category: .card, flashForcedOn: false))
+        let encoding = store.nextFrameToEncode()
+        XCTAssertTrue(store.offer(imageData(), category: .cardAndOcr, flashForcedOn: false))
+
+        // a worse flash frame doesn't compete with the better frame waiting in the other pool
+        XCTAssertTrue(store.offer(imageData(), category: .card, flashForcedOn: true))
+        XCTAssertFalse(store.offer(imageData(), category: .ocrOnly, flashForcedOn: true))
+        XCTAssertEqual(store.imageBytes, 3 * image.bytesPerRow * image.height)
+
+        // and a newer non-flash frame doesn't replace the waiting flash frame
+        XCTAssertTrue(store.offer(imageData(), category: .cardAndOcr, flashForcedOn: false))
+        XCTAssertEqual(store.imageBytes, 3 * image.bytesPerRow * image.height)
+
+        store.finishEncoding(sequence: encoding!.sequence, frame: frame(id: 0, byteCount: 10))
+        encodeWaitingFrame(in: store, id: 2, byteCount: 10)
+        encodeWaitingFrame(in: store, id: 4, byteCount: 10)
+
+        XCTAssertEqual(ids(in: store), [2, 0, 4])
+        XCTAssertFalse(store.hasWaitingFrame)
+    }
+
+    func testEncodesUpToMaxConcurrentEncodesAtOnce() {
+        let store = FrameRetentionStore(byteBudget: .max, maxFrames: 5, maxFlashFrames: 3, maxConcurrentEncodes: 2)
+
+        XCTAssertTrue(store.offer(imageData(), category: .card, flashForcedOn: false))
+        let first = store.nextFrameToEncode()
+        XCTAssertTrue(store.offer(imageData(), category: .card, flashForcedOn: false))
+        let second = store.nextFrameToEncode()
+        XCTAssertTrue(store.offer(imageData(), category: .card, flashForcedOn: false))
+        XCTAssertNotNil(first)
+        XCTAssertNotNil(second)
+        XCTAssertNil(store.nextFrameToEncode())
+        XCTAssertEqual(store.encodingCount, 2)
+        XCTAssertEqual(store.imageBytes, 3 * image.bytesPerRow * image.height)
+
+        // frames can finish in any order
+        store.finishEncoding(sequence: second!.sequence, frame: frame(id: 1, byteCount: 10))
+        encodeWaitingFrame(in: store, id: 2, byteCount: 10)
+        store.finishEncoding(sequence: first!.sequence, frame: frame(id: 0, byteCount: 10))
+
+        XCTAssertEqual(ids(in: store), [0, 1, 2])
+        XCTAssertFalse(store.isEncoding)
+    }
+
+    func testImagesBeingEncodedAreHeldToEncodingByteBudget() {
+        // room for two images being encoded, but not three
+        let imageByteCount = image.bytesPerRow * image.height
+        let encodingByteBudget = 2 * imageByteCount + 1
+        let store = FrameRetentionStore(
+            byteBudget: 5,
+            maxFrames: 5,
+            maxFlashFrames: 3,
+            maxConcurrentEncodes: 4,
+            encodingByteBudget: encodingByteBudget
+        )
+
+        var encoding: [Int] = []
+        for id in 0..<20 {
+            XCTAssertTrue(store.offer(imageData(), category: .cardAndOcr, flashForcedOn: false))
+            while let next = store.nextFrameToEncode() {
+                encoding.append(next.sequence)
+            }
+            XCTAssertLessThanOrEqual(store.encodingCount, 2)
+            XCTAssertLessThanOrEqual(store.encodingBytes, encodingByteBudget)
+            XCTAssertLessThanOrEqual(store.retainedBytes, 5)
+
+            // frames arrive faster than they're encoded, and encodes finish out of order
+            if id % 2 == 1, let sequence = encoding.popLast() {
+                store.finishEncoding(sequence: sequence, frame: frame(id: id, byteCount: 1))
+            }
+        }
+        for sequence in encoding {
+            store.finishEncoding(sequence: sequence, frame: frame(id: 0, byteCount: 1))
+        }
+
+        XCTAssertEqual(store.encodingBytes, 0)
+        XCTAssertEqual(store.peakEncodingBytes, 2 * imageByteCount)
+    }
+
+    func testEncodesConcurrentlyWithFullResolutionFrames() {
+        // a 1080p frame is larger than all of the encoded frames kept, which mustn't stop a second encode
+        let fraudData = CardScanFraudData()
+        let fullResolutionImage = ImageHelpers.createBlankCGImage(
+            size: CGSize(width: 1920, height: 1080),
+            scale: 1
+        )
+        let imageByteCount = fullResolutionImage.bytesPerRow * fullResolutionImage.height
+        XCTAssertGreaterThan(imageByteCount, fraudData.kFrameByteBudget)
+        let store = FrameRetentionStore(
+            byteBudget: fraudData.kFrameByteBudget,
+            maxFrames: fraudData.kMaxScans,
+            maxFlashFrames: fraudData.kMaxFlashScans,
+            maxConcurrentEncodes: 2,
+            encodingByteBudget: fraudData.kEncodingByteBudget
+        )
+
+        let fullResolutionImageData = ScannedCardImageData(
+            previewLayerImage: fullResolutionImage,
+            previewLayerViewfinderRect: .zero
+        )
+        XCTAssertTrue(store.offer(fullResolutionImageData, category: .cardAndOcr, flashForcedOn: false))
+        let first = store.nextFrameToEncode()
+        XCTAssertTrue(store.offer(fullResolutionImageData, category: .cardAndOcr, flashForcedOn: false))
+        let second = store.nextFrameToEncode()
+
+        XCTAssertNotNil(first)
+        XCTAssertNotNil(second)
+        XCTAssertEqual(store.encodingCount, 2)
+        XCTAssertEqual(store.encodingBytes, 2 * imageByteCount)
+
+        store.finishEncoding(sequence: first!.sequence, frame: frame(id: 0, byteCount: 100_000))
+        store.finishEncoding(sequence: second!.sequence, frame: frame(id: 1, byteCount: 100_000))
+        XCTAssertEqual(ids(in: store), [0, 1])
+    }
+
+    func testStartsOneEncodeWhenImageIsLargerThanEncodingByteBudget() {
+        let store = FrameRetentionStore(
+            byteBudget: .max,
+            maxFrames: 5,
+            maxFlashFrames: 3,
+            maxConcurrentEncodes: 2,
+            encodingByteBudget: 1
+        )
+
+        XCTAssertTrue(store.offer(imageData(), category: .card, flashForcedOn: false))
+        let first = store.nextFrameToEncode()
+        XCTAssertTrue(store.offer(imageData(), category: .card, flashForcedOn: false))
+        XCTAssertNotNil(first)
+        XCTAssertNil(store.nextFrameToEncode())
+        XCTAssertEqual(store.encodingCount, 1)
+
+        store.finishEncoding(sequence: first!.sequence, frame: frame(id: 0, byteCount: 1))
+        encodeWaitingFrame(in: store, id: 1, byteCount: 1)
+        XCTAssertFalse(store.isEncoding)
+    }
+
+    func testFrameDroppedWhileEncodingIsNotKept() {
+        let store = FrameRetentionStore(byteBudget: .max, maxFrames: 1, maxFlashFrames: 1)
+
+        XCTAssertTrue(store.offer(imageData(), category: .ocrOnly, flashForcedOn: false))
+        let encoding = store.nextFrameToEncode()!
+        XCTAssertTrue(store.offer(imageData(), category: .cardAndOcr, flashForcedOn: false))
+
+        // the encoder still holds the dropped frame's image
+        XCTAssertEqual(store.imageBytes, 2 * image.bytesPerRow * image.height)
+        store.finishEncoding(sequence: encoding.sequence, frame: frame(id: 0, byteCount: 10))
+        XCTAssertEqual(store.retainedFrameCount, 0)
+        XCTAssertEqual(store.imageBytes, image.bytesPerRow * image.height)
+
+        encodeWaitingFrame(in: store, id: 1, byteCount: 10)
+        XCTAssertEqual(ids(in: store), [1])
+    }
+
+    // MARK: - Helpers
+
+    func imageData() -> ScannedCardImageData {
+        return ScannedCardImageData(previewLayerImage: image, previewLayerViewfinderRect: .zero)
+    }
+
+    func ids(in store: FrameRetentionStore) -> [Int] {
+        return store.retainedFrames.map { $0.verificationFramesData.viewfinderMargins.left }
+    }
+
+    /// A stand-in for an encoded frame, identified by the left viewfinder margin
+    func frame(id: Int, byteCount: Int) -> RetainedFrame {
+        return RetainedFrame(
+            verificationFramesData: VerificationFramesData(
+                imageData: Data(count: byteCount),
+                viewfinderMargins: ViewFinderMargins(left: id, upper: 0, right: 0, lower: 0)
+            ),
+            imageMetadata: CardImageVerificationImageMetadata(
+                imageData: Data(count: byteCount),
+                imageSize: .zero,
+                compressionType: .jpeg,
+                compressionQuality: 0.8
+            )
+        )
+    }
+
+    func encodeWaitingFrame(
+        in store: FrameRetentionStore,
+        id: Int,
+        byteCount: Int,
+        file: StaticString = #filePath,
+        line: UInt = #line
+    ) {
+        guard let next = store.nextFrameToEncode() else {
+            XCTFail("No frame waiting to be encoded", file: file, line: line)
+            return
+        }
+        store.finishEncoding(sequence: next.sequence, frame: frame(id: id, byteCount: byteCount))
+    }
+}
+
+/// The per-category arrays and `balanceFrames()` that `CardScanFraudData` used to keep frames in
+struct ReferenceFrameArrays {
+    let kMaxScans = 5
+    let kMaxFlashScans = 3
+    var framesWithCards: [Int] = []
+    var framesWithCardsAndOcr: [Int] = []
+    var ocrOnlyFrames: [Int] = []
+    var framesWithFlashCardsAndOcr: [Int] = []
+    var framesWithFlashAndCards: [Int] = []
+    var framesWithFlashAndOcr: [Int] = []
+
+    var frames: [Int] {
+        return framesWithFlashAndOcr + framesWithFlashAndCards + framesWithFlashCardsAndOcr + ocrOnlyFrames
+            + framesWithCards + framesWithCardsAndOcr
+    }
+
+    mutating func append(_ id: Int, category: FrameRetentionStore.Category, flashForcedOn: Bool) {
+        switch (category, flashForcedOn) {
+        case (.ocrOnly, false): ocrOnlyFrames.append(id)
+        case (.card, false): framesWithCards.append(id)
+        case (.cardAndOcr, false): framesWithCardsAndOcr.append(id)
+        case (.ocrOnly, true): framesWithFlashAndOcr.append(id)
+        case (.card, true): framesWithFlashAndCards.append(id)
+        case (.cardAndOcr, true): framesWithFlashCardsAndOcr.append(id)
+        }
+        balanceFrames()
+    }
+
+    private mutating func balanceFrames() {
+        framesWithCardsAndOcr = Array(framesWithCardsAndOcr.suffix(kMaxScans))
+        framesWithCards = Array(framesWithCards.suffix(max(kMaxScans - framesWithCardsAndOcr.count, 0)))
+        ocrOnlyFrames = Array(
+            ocrOnlyFrames.suffix(max(kMaxScans - framesWithCardsAndOcr.count - framesWithCards.count, 0))
+        )
+
+        framesWithFlashCardsAndOcr = Array(framesWithFlashCardsAndOcr.suffix(kMaxFlashScans))
+        framesWithFlashAndCards = Array(
+            framesWithFlashAndCards.suffix(max(kMaxFlashScans - framesWithFlashCardsAndOcr.count, 0))
+        )
+        framesWithFlashAndOcr = Array(
+            framesWithFlashAndOcr.suffix(
+                max(kMaxFlashScans - framesWithFlashCardsAndOcr.count - framesWithFlashAndCards.count, 0)
+            )
+        )
+    }
+}
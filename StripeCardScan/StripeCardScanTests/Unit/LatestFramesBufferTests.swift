@@ -0,0 +1,118 @@
+//
+//  LatestFramesBufferTests.swift
+//  StripeCardScanTests
+//
+//  Created by Stripe on 10/17/26.
+//
+
+import XCTest
+
+@testable@_spi(STP) import StripeCardScan
+
+class LatestFramesBufferTests: XCTestCase {
+
+    func testKeepsLatestFramesAndDropsOldest() {
+        let buffer = LatestFramesBuffer<Int>(capacity: 2)
+        for frame in 1...5 {
+            buffer.push(frame)
+        }
+
+        XCTAssertEqual(buffer.popOldest(), 4)
+        XCTAssertEqual(buffer.popOldest(), 5)
+        XCTAssertNil(buffer.popOldest())
+        XCTAssertEqual(
+            buffer.statistics,
+            LatestFramesStatistics(pushed: 5, dropped: 3, consumed: 2, stale: 0)
+        )
+    }
+
+    func testCloseFlushesAndRejectsFrames() {
+        let buffer = LatestFramesBuffer<Int>(capacity: 3)
+        buffer.push(1)
+        buffer.push(2)
+
+        buffer.close()
+        XCTAssertTrue(buffer.isEmpty)
+        XCTAssertFalse(buffer.push(3))
+        XCTAssertNil(buffer.popOldest())
+
+        buffer.open()
+        XCTAssertTrue(buffer.push(4))
+        XCTAssertEqual(buffer.popOldest(), 4)
+        XCTAssertEqual(
+            buffer.statistics,
+            LatestFramesStatistics(pushed: 3, dropped: 0, consumed: 1, stale: 2)
+        )
+    }
+
+    func testShrinkingCapacityKeepsMostRecentFrames() {
+        let buffer = LatestFramesBuffer<Int>(capacity: 4)
+        for frame in 1...4 {
+            buffer.push(frame)
+        }
+
+        buffer.capacity = 2
+        XCTAssertEqual(buffer.capacity, 2)
+        XCTAssertEqual(buffer.popOldest(), 3)
+        XCTAssertEqual(buffer.popOldest(), 4)
+        XCTAssertEqual(buffer.statistics.stale, 2)
+    }
+
+    func testConcurrentConsumersSeeEachFrameAtMostOnce() {
+        let buffer = LatestFramesBuffer<Int>(capacity: 2)
+        let frameCount = 10_000
+        let consumerCount = 2
+        var consumed: [[Int]] = []
+        let consumedLock = NSLock()
+        let group = DispatchGroup()
+        let producerDone = DispatchSemaphore(value: 0)
+
+        for _ in 0..<consumerCount {
+            DispatchQueue.global().async(group: group) {
+                var frames: [Int] = []
+                var finished = false
+                while true {
+                    if let frame = buffer.popOldest() {
+                        frames.append(frame)
+                    } else if finished {
+                        consumedLock.lock()
+                        consumed.append(frames)
+                        consumedLock.unlock()
+                        return
+                    } else {
+                        finished = producerDone.wait(timeout: .now()) == .success
+                        if finished {
+                            producerDone.signal()
+                        }
+                    }
+                }
+            }
+        }
+
+        for frame in 0..<frameCount {
+            buffer.push(frame)
+        }
+        producerDone.signal()
+        group.wait()
+
+        let allConsumed = consumed.flatMap { $0 }
+        XCTAssertEqual(Set(allConsumed).count, allConsumed.count)
+        for frames in consumed {
+            XCTAssertEqual(frames, frames.sorted())
+        }
+
+        let statistics = buffer.statistics
+        XCTAssertEqual(statistics.pushed, frameCount)
+        XCTAssertEqual(statistics.consumed, allConsumed.count)
+        XCTAssertEqual(statistics.dropped + statistics.consumed, frameCount)
+    }
+
+    func testPushPerformance() {
+        let buffer = LatestFramesBuffer<Int>(capacity: 2)
+        measure {
+            for frame in 0..<100_000 {
+                buffer.push(frame)
+            }
+        }
+    }
+}
@@ -0,0 +1,114 @@
+//
+//  ModelInputPreprocessorTests.swift
+//  StripeCardScanTests
+//
+//  Created by Stripe on 10/17/26.
+//
+
+import UIKit
+import XCTest
+
+@testable@_spi(STP) import StripeCardScan
+
+class ModelInputPreprocessorTests: XCTestCase {
+
+    var croppedImage: CGImage?
+
+    override func setUpWithError() throws {
+        let (image, roiRectangle) = ImageHelpers.getTestImageAndRoiRectangle()
+        croppedImage = image.cgImage?.croppedImageForSsd(roiRectangle: roiRectangle)?.0
+    }
+
+    func testOutputMatchesCoreGraphicsPath() throws {
+        let croppedImage = try XCTUnwrap(croppedImage)
+        let preprocessor = ModelInputPreprocessor()
+
+        let pooled = try XCTUnwrap(preprocessor.pixelBuffer(from: croppedImage, pool: .ssdOcrInput))
+        let drawn = try XCTUnwrap(UIImage(cgImage: croppedImage).pixelBuffer(width: 600, height: 375))
+
+        XCTAssertEqual(CVPixelBufferGetPixelFormatType(pooled), kCVPixelFormatType_32ARGB)
+        XCTAssertEqual(CVPixelBufferGetWidth(pooled), 600)
+        XCTAssertEqual(CVPixelBufferGetHeight(pooled), 375)
+        // the two paths resample differently, so only expect the pixels to be close
+        XCTAssertLessThan(meanAbsoluteColorDifference(pooled, drawn), 4.0)
+    }
+
+    func testPredictionMatchesCoreGraphicsPath() throws {
+        let croppedImage = try XCTUnwrap(croppedImage)
+        let warmedUp = expectation(description: "models warmed up")
+        ModelWarmUp.shared.warmUp { _ in warmedUp.fulfill() }
+        wait(for: [warmedUp], timeout: 30)
+
+        let ssdOcrDetect = SSDOcrDetect()
+        let expectedNumber = ssdOcrDetect.predict(image: UIImage(cgImage: croppedImage))
+        XCTAssertNotNil(expectedNumber)
+        XCTAssertEqual(ssdOcrDetect.predict(cgImage: croppedImage), expectedNumber)
+    }
+
+    func testSquareUxInput() throws {
+        let (image, roiRectangle) = ImageHelpers.getTestImageAndRoiRectangle()
+        let squareImage = try XCTUnwrap(image.cgImage?.squareImageForUxModel(roiRectangle: roiRectangle))
+
+        let pixelBuffer = try XCTUnwrap(
+            ModelInputPreprocessor().pixelBuffer(from: squareImage, pool: .uxModelInput)
+        )
+        XCTAssertEqual(CVPixelBufferGetWidth(pixelBuffer), 224)
+        XCTAssertEqual(CVPixelBufferGetHeight(pixelBuffer), 224)
+    }
+
+    // MARK: - Benchmarks
+
+    func testCoreGraphicsPathPerformance() throws {
+        let croppedImage = try XCTUnwrap(croppedImage)
+        measure(metrics: [XCTClockMetric(), XCTMemoryMetric()]) {
+            for _ in 0..<50 {
+                _ = UIImage(cgImage: croppedImage).pixelBuffer(width: 600, height: 375)
+            }
+        }
+    }
+
+    func testPooledVImagePathPerformance() throws {
+        let croppedImage = try XCTUnwrap(croppedImage)
+        let preprocessor = ModelInputPreprocessor()
+        measure(metrics: [XCTClockMetric(), XCTMemoryMetric()]) {
+            for _ in 0..<50 {
+                _ = preprocessor.pixelBuffer(from: croppedImage, pool: .ssdOcrInput)
+            }
+        }
+    }
+
+    // MARK: - Helpers
+
+    /// Averages the absolute difference of the RGB channels of two same sized 32ARGB buffers
+    func meanAbsoluteColorDifference(_ first: CVPixelBuffer, _ second: CVPixelBuffer) -> Double {
+        CVPixelBufferLockBaseAddress(first, .readOnly)
+        CVPixelBufferLockBaseAddress(second, .readOnly)
+        defer {
+            CVPixelBufferUnlockBaseAddress(first, .readOnly)
+            CVPixelBufferUnlockBaseAddress(second, .readOnly)
+        }
+
+        let width = CVPixelBufferGetWidth(first)
+        let height = CVPixelBufferGetHeight(first)
+        guard let firstBase = CVPixelBufferGetBaseAddress(first),
+            let secondBase = CVPixelBufferGetBaseAddress(second)
+        else {
+            return .infinity
+        }
+        let firstRowBytes = CVPixelBufferGetBytesPerRow(first)
+        let secondRowBytes = CVPixelBufferGetBytesPerRow(second)
+
+        var total = 0
+        for y in 0..<height {
+            let firstRow = firstBase.advanced(by: y * firstRowBytes).assumingMemoryBound(to: UInt8.self)
+            let secondRow = secondBase.advanced(by: y * secondRowBytes).assumingMemoryBound(to: UInt8.self)
+            for x in 0..<width {
+                // skip the first byte of each pixel, it's the unused alpha channel
+                for channel in 1..<4 {
+                    total += abs(Int(firstRow[x * 4 + channel]) - Int(secondRow[x * 4 + channel]))
+                }
+            }
+        }
+        return Double(total) / Double(width * height * 3)
+    }
+}
@@ -0,0 +1,45 @@
+//
+//  ModelWarmUpTests.swift
+//  StripeCardScanTests
+//
+//  Created by Stripe on 10/17/26.
+//
+
+import XCTest
+
+@testable@_spi(STP) import StripeCardScan
+
+class ModelWarmUpTests: XCTestCase {
+
+    func testWarmUpLoadsModelsAndReportsTimings() throws {
+        let warmedUp = expectation(description: "models warmed up")
+        var reportedTimings: ModelWarmUpTimings?
+        OcrMainLoop.warmUp { timings in
+            reportedTimings = timings
+            warmedUp.fulfill()
+        }
+        wait(for: [warmedUp], timeout: 30)
+
+        let timings = try XCTUnwrap(reportedTimings)
+        XCTAssertNotNil(ModelWarmUp.shared.ssdOcrModel)
+        XCTAssertNotNil(ModelWarmUp.shared.uxModel)
+        XCTAssertGreaterThan(timings.ssdOcrLoad, 0)
+        XCTAssertGreaterThan(timings.uxModelLoad, 0)
+        XCTAssertGreaterThan(timings.ssdOcrColdInference, 0)
+        XCTAssertGreaterThan(timings.ssdOcrWarmInference, 0)
+        XCTAssertGreaterThan(timings.uxModelColdInference, 0)
+        XCTAssertGreaterThan(timings.uxModelWarmInference, 0)
+    }
+
+    func testDetectorsReusePrewarmedModels() {
+        let warmedUp = expectation(description: "models warmed up")
+        ModelWarmUp.shared.warmUp { _ in warmedUp.fulfill() }
+        wait(for: [warmedUp], timeout: 30)
+
+        let ssdOcrDetect = SSDOcrDetect()
+        XCTAssertTrue(ssdOcrDetect.ssdOcrModel === ModelWarmUp.shared.ssdOcrModel)
+
+        let uxAnalyzer = UxAnalyzer(with: SSDCreditCardOcr(dispatchQueueLabel: "test"))
+        XCTAssertTrue(uxAnalyzer.uxModel === ModelWarmUp.shared.uxModel)
+    }
+}
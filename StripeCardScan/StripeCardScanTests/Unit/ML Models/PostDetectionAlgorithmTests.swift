@@ -0,0 +1,210 @@
+//
+//  PostDetectionAlgorithmTests.swift
+//  StripeCardScanTests
+//
+//  Created by Stripe on 10/17/26.
+//
+
+import CoreGraphics
+import StripeCoreTestUtils
+import XCTest
+
+@testable@_spi(STP) import StripeCardScan
+
+class PostDetectionAlgorithmTests: XCTestCase {
+    let numRows = 8
+    let numCols = 30
+
+    func testFindsSameNumbersAsSeparateSearches() {
+        var generator = SplitMix64(seed: 0x9057_DE7)
+
+        for _ in 0..<500 {
+            let boxes = randomBoxes(using: &generator)
+            let algorithm = PostDetectionAlgorithm(boxes: boxes)
+            let reference = ReferencePostDetectionAlgorithm(boxes: boxes)
+
+            XCTAssertEqual(cells(algorithm.horizontalNumbers()), cells(reference.horizontalNumbers()))
+            XCTAssertEqual(cells(algorithm.verticalNumbers()), cells(reference.verticalNumbers()))
+            XCTAssertEqual(cells(algorithm.amexNumbers()), cells(reference.amexNumbers()))
+
+            let all = algorithm.allNumbers()
+            XCTAssertEqual(cells(all.horizontal), cells(reference.horizontalNumbers()))
+            XCTAssertEqual(cells(all.vertical), cells(reference.verticalNumbers()))
+            XCTAssertEqual(cells(all.amex), cells(reference.amexNumbers()))
+        }
+    }
+
+    func testCombineCloseBoxesKeepsMostConfidentBox() {
+        let boxes = [
+            box(row: 2, col: 4, confidence: 0.5),
+            box(row: 3, col: 5, confidence: 0.9),
+            box(row: 2, col: 10, confidence: 0.7),
+        ]
+        let combined = PostDetectionAlgorithm(boxes: boxes).combineCloseBoxes(deltaRow: 2, deltaCol: 2)
+
+        XCTAssertEqual(combined.map { [$0.row, $0.col] }, [[3, 5], [2, 10]])
+    }
+
+    func testFindsEvenlySpacedHorizontalNumber() {
+        let boxes = [2, 8, 14, 20].map { box(row: 3, col: $0, confidence: 0.9) }
+        let lines = PostDetectionAlgorithm(boxes: boxes).horizontalNumbers()
+
+        // the search has always started its lines with an empty one
+        XCTAssertEqual(cells(lines), [[], [[3, 2], [3, 8], [3, 14], [3, 20]]])
+    }
+
+    func testAllNumbersPerformance() {
+        var generator = SplitMix64(seed: 0xB0C5)
+        let boxSets = (0..<200).map { _ in randomBoxes(using: &generator) }
+
+        measure {
+            for boxes in boxSets {
+                _ = PostDetectionAlgorithm(boxes: boxes).allNumbers()
+            }
+        }
+    }
+
+    // MARK: - Helpers
+
+    func box(row: Int, col: Int, confidence: Double) -> DetectedBox {
+        return DetectedBox(
+            row: row,
+            col: col,
+            confidence: confidence,
+            numRows: numRows,
+            numCols: numCols,
+            boxSize: CGSize(width: 80, height: 36),
+            cardSize: CGSize(width: 480, height: 302),
+            imageSize: CGSize(width: 480, height: 302)
+        )
+    }
+
+    /// Mostly boxes along a few rows and columns, like digits on a card, with some noise
+    func randomBoxes(using generator: inout SplitMix64) -> [DetectedBox] {
+        let count = Int(generator.next() % 30)
+        let lineRow = Int(generator.next() % UInt64(numRows))
+        let lineCol = Int(generator.next() % UInt64(numCols))
+        return (0..<count).map { _ in
+            let row: Int
+            let col: Int
+            switch generator.next() % 3 {
+            case 0:
+                row = min(max(lineRow + Int(generator.next() % 3) - 1, 0), numRows - 1)
+                col = Int(generator.next() % UInt64(numCols))
+            case 1:
+                row = Int(generator.next() % UInt64(numRows))
+                col = min(max(lineCol + Int(generator.next() % 3) - 1, 0), numCols - 1)
+            default:
+                row = Int(generator.next() % UInt64(numRows))
+                col = Int(generator.next() % UInt64(numCols))
+            }
+            return box(row: row, col: col, confidence: Double(generator.next() % 1000) / 1000)
+        }
+    }
+
+    func cells(_ lines: [[DetectedBox]]) -> [[[Int]]] {
+        return lines.map { line in line.map { [$0.row, $0.col] } }
+    }
+}
+
+/// The separate combine, search and filter passes that `PostDetectionAlgorithm` used to run for
+/// each kind of number
+struct ReferencePostDetectionAlgorithm {
+    let sortedBoxes: [DetectedBox]
+    let numRows: Int
+    let numCols: Int
+
+    init(
+        boxes: [DetectedBox]
+    ) {
+        sortedBoxes = Array(boxes.sorted { $0.confidence > $1.confidence }.prefix(20))
+        numRows = (sortedBoxes.map { $0.row }.max() ?? 0) + 1
+        numCols = (sortedBoxes.map { $0.col }.max() ?? 0) + 1
+    }
+
+    func horizontalNumbers() -> [[DetectedBox]] {
+        let lines = findNumbers(
+            words: combineCloseBoxes(deltaRow: 2, deltaCol: 2).sorted { $0.col < $1.col },
+            predicate: horizontalAddBoxPredicate,
+            numberOfBoxes: 4
+        )
+        return lines.filter { line in
+            let deltas = zip(line, line.dropFirst()).map { box, nextBox in nextBox.col - box.col }
+            return ((deltas.max() ?? 0) - (deltas.min() ?? 0)) <= 2
+        }
+    }
+
+    func verticalNumbers() -> [[DetectedBox]] {
+        let lines = findNumbers(
+            words: combineCloseBoxes(deltaRow: 2, deltaCol: 2).sorted { $0.row < $1.row },
+            predicate: verticalAddBoxPredicate,
+            numberOfBoxes: 4
+        )
+        return lines.filter { line in
+            let deltas = zip(line, line.dropFirst()).map { box, nextBox in nextBox.row - box.row }
+            return ((deltas.max() ?? 0) - (deltas.min() ?? 0)) <= 2
+        }
+    }
+
+    func amexNumbers() -> [[DetectedBox]] {
+        let lines = findNumbers(
+            words: combineCloseBoxes(deltaRow: 2, deltaCol: 1).sorted { $0.col < $1.col },
+            predicate: horizontalAddBoxPredicate,
+            numberOfBoxes: 5
+        )
+        return lines.filter { line in
+            let colDeltas = zip(line, line.dropFirst()).map { box, nextBox in nextBox.col - box.col }
+            let evenColDeltas = colDeltas.enumerated().filter { $0.0 % 2 == 0 }.map { $0.1 }
+            let oddColDeltas = colDeltas.enumerated().filter { $0.0 % 2 == 1 }.map { $0.1 }
+            return zip(evenColDeltas, oddColDeltas).allSatisfy { even, odd in Double(even) / Double(odd) >= 2.0 }
+        }
+    }
+
+    func combineCloseBoxes(deltaRow: Int, deltaCol: Int) -> [DetectedBox] {
+        var cardGrid = Array(repeating: Array(repeating: false, count: numCols), count: numRows)
+        for box in sortedBoxes {
+            cardGrid[box.row][box.col] = true
+        }
+        for box in sortedBoxes where cardGrid[box.row][box.col] {
+            for row in (box.row - deltaRow)...(box.row + deltaRow) {
+                for col in (box.col - deltaCol)...(box.col + deltaCol)
+                where row >= 0 && row < numRows && col >= 0 && col < numCols {
+                    cardGrid[row][col] = false
+                }
+            }
+            cardGrid[box.row][box.col] = true
+        }
+        return sortedBoxes.filter { cardGrid[$0.row][$0.col] }
+    }
+
+    func findNumbers(
+        words: [DetectedBox],
+        predicate: (DetectedBox, DetectedBox) -> Bool,
+        numberOfBoxes: Int
+    ) -> [[DetectedBox]] {
+        var lines: [[DetectedBox]] = [[]]
+
+        func search(_ currentLine: [DetectedBox], _ words: ArraySlice<DetectedBox>) {
+            if currentLine.count == numberOfBoxes {
+                lines.append(currentLine)
+                return
+            }
+            for (idx, word) in zip(words.indices, words) where predicate(currentLine.last!, word) {
+                search(currentLine + [word], words[(idx + 1)...])
+            }
+        }
+
+        for (idx, word) in words.enumerated() {
+            search([word], words[(idx + 1)...])
+        }
+        return lines
+    }
+
+    func horizontalAddBoxPredicate(_ currentWord: DetectedBox, _ nextWord: DetectedBox) -> Bool {
+        return nextWord.col > currentWord.col && abs(nextWord.row - currentWord.row) <= 1
+    }
+
+    func verticalAddBoxPredicate(_ currentWord: DetectedBox, _ nextWord: DetectedBox) -> Bool {
+        return nextWord.row > currentWord.row && abs(nextWord.col - currentWord.col) <= 1
+    }
+}
@@ -0,0 +1,118 @@
+//
+//  SSDOcrDecodeTests.swift
+//  StripeCardScanTests
+//
+//  Created by Stripe on 10/17/26.
+//
+
+import XCTest
+
+@testable@_spi(STP) import StripeCardScan
+
+class SSDOcrDecodeTests: XCTestCase {
+
+    let filterThreshold: Float = 0.39
+    let centerVariance: Float = 0.1
+    let sizeVariance: Float = 0.2
+    let priors = OcrPriorsGen.combinePriors()
+
+    var output: SSDOcrOutput?
+
+    override func setUpWithError() throws {
+        output = SSDOcrOutputHelpers.recordedOutput()
+    }
+
+    func testFlatDecodeMatchesNestedArrayDecode() throws {
+        let output = try XCTUnwrap(output)
+
+        let (scores, boxes) = legacyDecode(output)
+        let buffer = SSDOcrDecodeBuffer(capacity: 0, numClasses: 0)
+        flatDecode(output, into: buffer)
+
+        XCTAssertGreaterThan(buffer.count, 0)
+        XCTAssertEqual(buffer.count, scores.count)
+        XCTAssertEqual(buffer.count, boxes.count)
+        for row in 0..<buffer.count {
+            // the vectorized box decode may round differently than the scalar reference
+            for (flat, nested) in zip(buffer.box(at: row), boxes[row]) {
+                XCTAssertEqual(flat, nested, accuracy: 1e-5)
+            }
+            for classIndex in 0..<buffer.numClasses {
+                XCTAssertEqual(buffer.score(at: row, classIndex: classIndex), scores[row][classIndex])
+            }
+        }
+    }
+
+    func testPriorTableMatchesGeneratedPriors() {
+        let table = SSDOcrPriorTable.shared
+        XCTAssertEqual(table.count, priors.count)
+        for (index, prior) in priors.enumerated() {
+            XCTAssertEqual(table.centerX[index], Float(prior.minX))
+            XCTAssertEqual(table.centerY[index], Float(prior.minY))
+            XCTAssertEqual(table.width[index], Float(prior.width))
+            XCTAssertEqual(table.height[index], Float(prior.height))
+        }
+    }
+
+    func testFlatDecodeReusesBufferAcrossFrames() throws {
+        let output = try XCTUnwrap(output)
+        let buffer = SSDOcrDecodeBuffer(capacity: 3420, numClasses: 10)
+
+        flatDecode(output, into: buffer)
+        let firstCount = buffer.count
+        let firstBoxes = (0..<buffer.count).map { buffer.box(at: $0) }
+
+        flatDecode(output, into: buffer)
+        XCTAssertEqual(buffer.count, firstCount)
+        XCTAssertEqual((0..<buffer.count).map { buffer.box(at: $0) }, firstBoxes)
+    }
+
+    // MARK: - Benchmarks
+
+    func testNestedArrayDecodePerformance() throws {
+        let output = try XCTUnwrap(output)
+        measure(metrics: [XCTClockMetric(), XCTMemoryMetric()]) {
+            for _ in 0..<100 {
+                _ = legacyDecode(output)
+            }
+        }
+    }
+
+    func testFlatDecodePerformance() throws {
+        let output = try XCTUnwrap(output)
+        let buffer = SSDOcrDecodeBuffer(capacity: 3420, numClasses: 10)
+        measure(metrics: [XCTClockMetric(), XCTMemoryMetric()]) {
+            for _ in 0..<100 {
+                flatDecode(output, into: buffer)
+            }
+        }
+    }
+
+    // MARK: - Helpers
+
+    func legacyDecode(_ output: SSDOcrOutput) -> ([[Float]], [[Float]]) {
+        let (scores, boxes, filterArray) = output.getScores(filterThreshold: filterThreshold)
+        let regularBoxes = output.convertLocationsToBoxes(
+            locations: boxes,
+            priors: priors,
+            centerVariance: centerVariance,
+            sizeVariance: sizeVariance
+        )
+        let cornerFormBoxes = output.centerFormToCornerForm(regularBoxes: regularBoxes)
+        return output.filterScoresAndBoxes(
+            scores: scores,
+            boxes: cornerFormBoxes,
+            filterArray: filterArray,
+            filterThreshold: filterThreshold
+        )
+    }
+
+    func flatDecode(_ output: SSDOcrOutput, into buffer: SSDOcrDecodeBuffer) {
+        output.decode(
+            filterThreshold: filterThreshold,
+            centerVariance: centerVariance,
+            sizeVariance: sizeVariance,
+            into: buffer
+        )
+    }
+}
@@ -0,0 +1,45 @@
+//
+//  SSDOcrDetectTests.swift
+//  StripeCardScanTests
+//
+//  Created by Stripe on 10/17/26.
+//
+
+import XCTest
+
+@testable@_spi(STP) import StripeCardScan
+
+class SSDOcrDetectTests: XCTestCase {
+    var ssdOcrDetect: SSDOcrDetect!
+    var cardImage: CGImage!
+    let blankImage = ImageHelpers.createBlankCGImage(
+        size: CGSize(width: SSDOcrDetect.imageWidth, height: SSDOcrDetect.imageHeight),
+        scale: 1
+    )
+
+    override func setUpWithError() throws {
+        try super.setUpWithError()
+        ssdOcrDetect = SSDOcrDetect()
+        ssdOcrDetect.ssdOcrModel = try XCTUnwrap(SSDOcrDetect.loadModelFromBundle())
+
+        let (image, roiRectangle) = ImageHelpers.getTestImageAndRoiRectangle()
+        cardImage = try XCTUnwrap(image.cgImage?.croppedImageForSsd(roiRectangle: roiRectangle)?.0)
+    }
+
+    func testBatchedFrameWithoutDigitsReportsNoBoxes() throws {
+        let results = try XCTUnwrap(ssdOcrDetect.predict(cgImages: [cardImage, blankImage]))
+
+        XCTAssertEqual(results.count, 2)
+        XCTAssertFalse(results[0].boxes.isEmpty)
+        XCTAssertNil(results[1].number)
+        XCTAssertEqual(results[1].boxes, [])
+    }
+
+    func testFrameWithoutDigitsReportsNoBoxes() {
+        _ = ssdOcrDetect.predict(cgImage: cardImage)
+        XCTAssertFalse(ssdOcrDetect.lastDetectedBoxes.isEmpty)
+
+        XCTAssertNil(ssdOcrDetect.predict(cgImage: blankImage))
+        XCTAssertEqual(ssdOcrDetect.lastDetectedBoxes, [])
+    }
+}
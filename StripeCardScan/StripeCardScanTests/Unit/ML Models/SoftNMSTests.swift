@@ -0,0 +1,180 @@
+//
+//  SoftNMSTests.swift
+//  StripeCardScanTests
+//
+//  Created by Stripe on 10/17/26.
+//
+
+import XCTest
+
+@_spi(STP) import StripeCore
+@testable@_spi(STP) import StripeCardScan
+
+class SoftNMSTests: XCTestCase {
+
+    let probThreshold: Float = 0.45
+    let sigma = SSDOcrDetect.sigma
+
+    var candidatesPerClass: [([[Float]], [Float])] = []
+    var decoded: SSDOcrDecodeBuffer?
+
+    override func setUpWithError() throws {
+        guard let output = SSDOcrOutputHelpers.recordedOutput() else {
+            return
+        }
+
+        let buffer = SSDOcrDecodeBuffer(capacity: 3420, numClasses: 10)
+        output.decode(
+            filterThreshold: 0.39,
+            centerVariance: 0.1,
+            sizeVariance: 0.2,
+            into: buffer
+        )
+        decoded = buffer
+
+        candidatesPerClass = (0..<buffer.numClasses).map { classIndex in
+            let rows = (0..<buffer.count).filter {
+                buffer.score(at: $0, classIndex: classIndex) > probThreshold
+            }
+            return (
+                rows.map { buffer.box(at: $0) },
+                rows.map { buffer.score(at: $0, classIndex: classIndex) }
+            )
+        }
+    }
+
+    func testInPlaceSoftNMSMatchesArraySoftNMSOnRecordedDetections() {
+        XCTAssertFalse(candidatesPerClass.allSatisfy { $0.1.isEmpty })
+
+        let engine = NonMaxSuppressionEngine()
+        for (boxes, probs) in candidatesPerClass where !probs.isEmpty {
+            assertSoftNMSMatches(boxes: boxes, probs: probs, engine: engine)
+        }
+    }
+
+    func testInPlaceSoftNMSMatchesArraySoftNMSOnClusteredBoxes() {
+        // Clusters of heavily overlapping boxes, like the SSD produces around each digit
+        let engine = NonMaxSuppressionEngine()
+        for seed in 0..<20 {
+            var boxes: [[Float]] = []
+            var probs: [Float] = []
+            for index in 0..<120 {
+                let cluster = Float(index % 16)
+                let jitter = Float((index * 7 + seed * 13) % 11) / 1000
+                let x = cluster * 0.06 + jitter
+                let y = 0.4 + jitter
+                boxes.append([x, y, x + 0.05, y + 0.1])
+                probs.append(0.46 + Float((index * 31 + seed * 17) % 53) / 100)
+            }
+            assertSoftNMSMatches(boxes: boxes, probs: probs, engine: engine)
+        }
+    }
+
+    func testDecodedPredictionUtilMatchesArrayPredictionUtil() throws {
+        let decoded = try XCTUnwrap(decoded)
+        let rows = 0..<decoded.count
+
+        let expected = PredictionUtilOcr().predictionUtil(
+            scores: rows.map { row in
+                (0..<decoded.numClasses).map { decoded.score(at: row, classIndex: $0) }
+            },
+            boxes: rows.map { decoded.box(at: $0) },
+            probThreshold: probThreshold
+        )
+        let result = PredictionUtilOcr().predictionUtil(
+            decoded: decoded,
+            probThreshold: probThreshold,
+            engine: NonMaxSuppressionEngine()
+        )
+
+        XCTAssertFalse(result.pickedBoxes.isEmpty)
+        XCTAssertEqual(result.pickedBoxes, expected.pickedBoxes)
+        XCTAssertEqual(result.pickedBoxProbs, expected.pickedBoxProbs)
+        XCTAssertEqual(result.pickedLabels, expected.pickedLabels)
+    }
+
+    func testMaxOutputsCapsSelections() {
+        let engine = NonMaxSuppressionEngine()
+        for index in 0..<10 {
+            let x = Float(index) * 0.1
+            engine.append(xMin: x, yMin: 0, xMax: x + 0.05, yMax: 0.1, score: 0.9)
+        }
+
+        let picked = engine.softNMS(
+            decay: .gaussian(sigma: sigma),
+            scoreThreshold: probThreshold,
+            maxOutputs: 3
+        )
+        XCTAssertEqual(picked, [0, 1, 2])
+    }
+
+    // MARK: - Benchmarks
+
+    func testArraySoftNMSPerformance() {
+        measure {
+            for _ in 0..<100 {
+                for (boxes, probs) in candidatesPerClass where !probs.isEmpty {
+                    _ = SoftNMS.softNMS(
+                        subsetBoxes: boxes,
+                        probs: probs,
+                        probThreshold: probThreshold,
+                        sigma: sigma,
+                        topK: 0,
+                        candidateSize: 0
+                    )
+                }
+            }
+        }
+    }
+
+    func testInPlaceSoftNMSPerformance() {
+        let engine = NonMaxSuppressionEngine(capacity: 3420)
+        measure {
+            for _ in 0..<100 {
+                for (boxes, probs) in candidatesPerClass where !probs.isEmpty {
+                    engine.removeAll()
+                    for (box, prob) in zip(boxes, probs) {
+                        engine.append(xMin: box[0], yMin: box[1], xMax: box[2], yMax: box[3], score: prob)
+                    }
+                    engine.softNMS(
+                        decay: .gaussian(sigma: sigma),
+                        scoreThreshold: probThreshold,
+                        maxOutputs: 0
+                    )
+                }
+            }
+        }
+    }
+
+    // MARK: - Helpers
+
+    func assertSoftNMSMatches(
+        boxes: [[Float]],
+        probs: [Float],
+        engine: NonMaxSuppressionEngine,
+        file: StaticString = #filePath,
+        line: UInt = #line
+    ) {
+        let (expectedBoxes, expectedScores) = SoftNMS.softNMS(
+            subsetBoxes: boxes,
+            probs: probs,
+            probThreshold: probThreshold,
+            sigma: sigma,
+            topK: 0,
+            candidateSize: 0
+        )
+
+        engine.removeAll()
+        for (box, prob) in zip(boxes, probs) {
+            engine.append(xMin: box[0], yMin: box[1], xMax: box[2], yMax: box[3], score: prob)
+        }
+        let picked = engine.softNMS(
+            decay: .gaussian(sigma: sigma),
+            scoreThreshold: probThreshold,
+            maxOutputs: 0
+        )
+
+        XCTAssertEqual(picked.map { boxes[$0] }, expectedBoxes, file: file, line: line)
+        XCTAssertEqual(engine.selectedScores, expectedScores, file: file, line: line)
+    }
+}
@@ -0,0 +1,80 @@
+//
+//  OcrMainLoopTests.swift
+//  StripeCardScanTests
+//
+//  Created by Stripe on 10/17/26.
+//
+
+import XCTest
+
+@testable@_spi(STP) import StripeCardScan
+
+class OcrMainLoopTests: XCTestCase {
+    let number = "4242424242424242"
+    let image = ImageHelpers.createBlankCGImage()
+    let roiRectangle = CGRect(x: 0, y: 0, width: 1, height: 1)
+
+    func testReusedPredictionsVoteButCountAsOneRead() {
+        let mainLoop = OcrMainLoop(analyzers: [])
+        let ocr = CreditCardOcrImplementation(dispatchQueueLabel: "test")
+        let imageData = ScannedCardImageData(previewLayerImage: image, previewLayerViewfinderRect: roiRectangle)
+
+        // one read, then frames the gate found to be duplicates of it
+        let results = [prediction(isReused: false)] + (0..<5).map { _ in prediction(isReused: true) }
+        mainLoop.analyzerDidFinish(
+            ocr: ocr,
+            results: results.map { (imageData, $0) },
+            latency: 0.05
+        )
+        mainLoop.mutexQueue.sync {}
+
+        XCTAssertEqual(mainLoop.errorCorrection.numbers.confidence.totalVotes, 6)
+        XCTAssertEqual(mainLoop.errorCorrection.frames, 6)
+        XCTAssertEqual(mainLoop.scheduler.stats(for: ocr).samples, 1)
+        XCTAssertEqual(mainLoop.scanStats.scans, 6)
+    }
+
+    func testReusedPredictionsDontDelayResult() {
+        // at 30fps, the gate reuses the last read for 3 of every 4 frames of a still card
+        let finishedFrame = { (gateReusesFrames: Bool) -> Int? in
+            var now = Date(timeIntervalSince1970: 0)
+            let stateMachine = CardVerifyStateMachine()
+            stateMachine.now = { now }
+            let mainLoop = OcrMainLoop(analyzers: [])
+            mainLoop.errorCorrection = ErrorCorrection(stateMachine: stateMachine)
+
+            for frame in 0..<90 {
+                now = Date(timeIntervalSince1970: Double(frame) / 30)
+                let isReused = gateReusesFrames && frame % 4 != 0
+                let result = mainLoop.combine(prediction: self.prediction(isReused: isReused, hasCard: true))
+                if result?.state == .finished {
+                    return frame
+                }
+            }
+            return nil
+        }
+
+        // the clear leader finishes ocr&card after 0.75 seconds, whether or not the gate reused frames
+        XCTAssertEqual(finishedFrame(false), 23)
+        XCTAssertEqual(finishedFrame(true), 23)
+    }
+
+    // MARK: - Helpers
+
+    func prediction(isReused: Bool, hasCard: Bool = false) -> CreditCardOcrPrediction {
+        return CreditCardOcrPrediction(
+            image: image,
+            ocrCroppingRectangle: roiRectangle,
+            number: number,
+            expiryMonth: nil,
+            expiryYear: nil,
+            name: nil,
+            computationTime: 0.0,
+            numberBoxes: nil,
+            expiryBoxes: nil,
+            nameBoxes: nil,
+            isReused: isReused,
+            centeredCardState: hasCard ? .numberSide : nil
+        )
+    }
+}
@@ -0,0 +1,114 @@
+//
+//  OcrTextClassifierTests.swift
+//  StripeCardScanTests
+//
+//  Created by Stripe on 10/17/26.
+//
+
+import StripeCoreTestUtils
+import XCTest
+
+@testable@_spi(STP) import StripeCardScan
+
+class OcrTextClassifierTests: XCTestCase {
+
+    /// Lines of text like the ones Vision reads off of the front of cards
+    static let corpus = [
+        "4242 4242 4242 4242", "4242424242424242", "5555 5555 5555 4444", "3782 822463 10005",
+        "4000 0566 5566 5556", "4242 4242 4242 4241", "VALID THRU 12/25", "GOOD THRU 01/29",
+        "12/25", "01.27", "EXP 13/25", "VALID FROM 09/21", "JOHN Q SMITH", "JANE DOE",
+        "CARDHOLDER JANE DOE", "MEMBER SINCE 2015", "CHASE", "VISA", "DEBIT", "Platinum",
+        "CAPITAL ONE", "WELLS FARGO BUSINESS", "AUTHORIZED SIGNATURE", "MR JOHN APPLESEED",
+        "5412 7512 3412 3456", "THRU", "04/28\n", "Valid\n07/26", "1234", "BANK OF AMERICA",
+        "ÉLODIE MARTIN", "NOT TRANSFERABLE",
+    ]
+
+    func testMatchesReferenceOnCorpus() {
+        for text in OcrTextClassifierTests.corpus {
+            assertMatchesReference(text)
+        }
+    }
+
+    func testClassifiesCardText() {
+        XCTAssertEqual(OcrTextClassifier.classify("4242 4242 4242 4242").pan, "4242424242424242")
+        XCTAssertNil(OcrTextClassifier.classify("4242 4242 4242 4241").pan)
+
+        let expiry = OcrTextClassifier.classify("VALID THRU 12/25").expiry
+        XCTAssertEqual(expiry?.month, "12")
+        XCTAssertEqual(expiry?.year, "25")
+        XCTAssertEqual(OcrTextClassifier.classify("04/28\r\n").expiry?.month, "04")
+        XCTAssertNil(OcrTextClassifier.classify("Valid\n07/26").expiry)
+
+        XCTAssertEqual(OcrTextClassifier.classify("CARDHOLDER JANE  DOE").name, "JANE DOE")
+        XCTAssertNil(OcrTextClassifier.classify("CAPITAL ONE").name)
+    }
+
+    func testFuzzMatchesReference() {
+        // characters the patterns care about, plus some that they don't
+        let alphabet: [String] = Array("0123456789  /.AJNOSTVXZaez-\n\r\t").map { String($0) } + [
+            "\r\n", "é", "\u{2028}", "1\u{301}", "VISA", "THRU", "CARD", "12/", "4242",
+        ]
+        var generator = SplitMix64(seed: 0x5EED)
+
+        for _ in 0..<20_000 {
+            let length = Int(generator.next() % 12)
+            var text = ""
+            for _ in 0..<length {
+                text += alphabet[Int(generator.next() % UInt64(alphabet.count))]
+            }
+            assertMatchesReference(text)
+        }
+    }
+
+    func testPerfectHashWordSet() {
+        let wordSet = NameWords.blacklistWordSet
+        XCTAssertEqual(wordSet.count, Set(NameWords.blacklist).count)
+
+        for word in NameWords.blacklist {
+            XCTAssertTrue(wordSet.contains(word), word)
+            XCTAssertTrue(wordSet.contains(word.uppercased()), word)
+        }
+        for word in ["JOHN", "jane", "visas", "", "cardholdersinc", "appleseed"] {
+            XCTAssertFalse(wordSet.contains(word), word)
+        }
+    }
+
+    // MARK: - Benchmarks
+
+    func testReferencePerformance() {
+        let corpus = OcrTextClassifierTests.corpus
+        measure {
+            for _ in 0..<200 {
+                for text in corpus {
+                    _ = CreditCardOcrPrediction.pan(text)
+                    _ = CreditCardOcrPrediction.likelyExpiry(text)
+                    _ = AppleCreditCardOcr.likelyName(text)
+                }
+            }
+        }
+    }
+
+    func testClassifierPerformance() {
+        let corpus = OcrTextClassifierTests.corpus
+        measure {
+            for _ in 0..<200 {
+                for text in corpus {
+                    _ = OcrTextClassifier.classify(text)
+                }
+            }
+        }
+    }
+
+    // MARK: - Helpers
+
+    func assertMatchesReference(_ text: String, file: StaticString = #filePath, line: UInt = #line) {
+        let classification = OcrTextClassifier.classify(text)
+        let expiry = CreditCardOcrPrediction.likelyExpiry(text)
+        let debugText = text.debugDescription
+
+        XCTAssertEqual(classification.pan, CreditCardOcrPrediction.pan(text), debugText, file: file, line: line)
+        XCTAssertEqual(classification.expiry?.month, expiry?.0, debugText, file: file, line: line)
+        XCTAssertEqual(classification.expiry?.year, expiry?.1, debugText, file: file, line: line)
+        XCTAssertEqual(classification.name, AppleCreditCardOcr.likelyName(text), debugText, file: file, line: line)
+    }
+}
@@ -0,0 +1,97 @@
+//
+//  SSDOcrBatchingPolicyTests.swift
+//  StripeCardScanTests
+//
+//  Created by Stripe on 10/17/26.
+//
+
+import XCTest
+
+@testable@_spi(STP) import StripeCardScan
+
+class SSDOcrBatchingPolicyTests: XCTestCase {
+
+    var currentTime = Date(timeIntervalSince1970: 0)
+    var policy: SSDOcrBatchingPolicy!
+
+    override func setUp() {
+        super.setUp()
+        policy = SSDOcrBatchingPolicy(
+            maxBatchSize: 3,
+            latencySensitiveDuration: 1.0,
+            minimumSamples: 2,
+            probeInterval: 4,
+            now: { [unowned self] in self.currentTime }
+        )
+    }
+
+    func testMeasuresSingleFramesThenBatches() {
+        XCTAssertEqual(policy.batchSize, 1)
+        recordSingleFrames(count: 2, latency: 0.03)
+        XCTAssertEqual(policy.batchSize, 3)
+    }
+
+    func testBatchesWhileFasterPerFrame() {
+        recordSingleFrames(count: 2, latency: 0.03)
+        recordBatches(count: 2, latency: 0.06)
+
+        XCTAssertEqual(policy.batchedFrameLatency, 0.02, accuracy: 0.0001)
+        XCTAssertEqual(policy.batchSize, 3)
+    }
+
+    func testFallsBackToSingleFramesWhenBatchingIsSlower() {
+        recordSingleFrames(count: 2, latency: 0.03)
+        recordBatches(count: 2, latency: 0.12)
+        XCTAssertEqual(policy.batchSize, 1)
+
+        // tries a batch again after `probeInterval` single frames
+        recordSingleFrames(count: 3, latency: 0.03)
+        XCTAssertEqual(policy.batchSize, 1)
+        recordSingleFrames(count: 1, latency: 0.03)
+        XCTAssertEqual(policy.batchSize, 3)
+    }
+
+    func testRunsSingleFramesRightAfterCardAppears() {
+        recordSingleFrames(count: 2, latency: 0.03)
+        recordBatches(count: 2, latency: 0.06)
+
+        policy.record(frames: 3, latency: 0.06, foundCard: true)
+        XCTAssertEqual(policy.batchSize, 1)
+
+        currentTime += 0.5
+        policy.record(frames: 1, latency: 0.03, foundCard: true)
+        XCTAssertEqual(policy.batchSize, 1)
+
+        // still the same card, so it doesn't restart the latency sensitive window
+        currentTime += 0.6
+        XCTAssertEqual(policy.batchSize, 3)
+        policy.record(frames: 3, latency: 0.06, foundCard: true)
+        XCTAssertEqual(policy.batchSize, 3)
+
+        // a card that shows up after none was seen for a while is a new card
+        currentTime += 2.0
+        policy.record(frames: 3, latency: 0.06, foundCard: true)
+        XCTAssertEqual(policy.batchSize, 1)
+    }
+
+    func testBatchSizeOfOneNeverBatches() {
+        let policy = SSDOcrBatchingPolicy(maxBatchSize: 1, minimumSamples: 1)
+        policy.record(frames: 1, latency: 0.03, foundCard: false)
+
+        XCTAssertEqual(policy.batchSize, 1)
+    }
+
+    // MARK: - Helpers
+
+    func recordSingleFrames(count: Int, latency: TimeInterval) {
+        for _ in 0..<count {
+            policy.record(frames: 1, latency: latency, foundCard: false)
+        }
+    }
+
+    func recordBatches(count: Int, latency: TimeInterval) {
+        for _ in 0..<count {
+            policy.record(frames: policy.maxBatchSize, latency: latency, foundCard: false)
+        }
+    }
+}
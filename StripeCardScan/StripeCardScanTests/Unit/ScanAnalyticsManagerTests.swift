@@ -34,13 +34,17 @@ class ScanAnalyticsManagerTests: XCTestCase {
         let payloadInfo = ScanAnalyticsPayload.PayloadInfo(
             imageCompressionType: "heic",
             imageCompressionQuality: 0.8,
-            imagePayloadSize: 4000
+            imagePayloadSize: 4000,
+            peakRetainedFrameBytes: 6000,
+            retainedFrames: 2
         )
+        let performanceInfo = PerformanceInfo(scanStats: ScanStats())
         /// Log scan activity repeating and non-repeating tasks
         scanAnalyticsManager.setScanSessionStartTime(time: startTime)
         scanAnalyticsManager.logCameraPermissionsTask(success: false)
         scanAnalyticsManager.logMainLoopImageProcessedRepeatingTask(.init(executions: 100))
         scanAnalyticsManager.logPayloadInfo(with: payloadInfo)
+        scanAnalyticsManager.logPerformanceInfo(with: performanceInfo)
         scanAnalyticsManager.logScanActivityTask(event: .firstImageProcessed)
         scanAnalyticsManager.logTorchSupportTask(supported: false)
         scanAnalyticsManager.trackCompletionLoopDuration(task: task)
@@ -63,6 +67,7 @@ class ScanAnalyticsManagerTests: XCTestCase {
             /// Check the populated configuration and payload info
             XCTAssertEqual(payload.configuration.strictModeFrames, 0)
             XCTAssertEqual(payload.payloadInfo, payloadInfo)
+            XCTAssertEqual(payload.performanceInfo, performanceInfo)
 
             /// Check the populated scan activity
             let payloadScanStats = payload.scanStats
@@ -108,6 +113,7 @@ class ScanAnalyticsManagerTests: XCTestCase {
         scanAnalyticsManager.logMainLoopImageProcessedRepeatingTask(.init(executions: 100))
         scanAnalyticsManager.logScanActivityTaskFromStartTime(event: .firstImageProcessed)
         scanAnalyticsManager.logTorchSupportTask(supported: false)
+        scanAnalyticsManager.logPerformanceInfo(with: PerformanceInfo(scanStats: ScanStats()))
 
         /// Reset the scan analytics manager
         scanAnalyticsManager.reset()
@@ -127,6 +133,7 @@ class ScanAnalyticsManagerTests: XCTestCase {
                 payload.payloadInfo,
                 "A reset scan analytics manager should have a nil payload info"
             )
+            XCTAssertNil(payload.performanceInfo)
 
             /// Check the reset scan activity
             let payloadScanStats = payload.scanStats
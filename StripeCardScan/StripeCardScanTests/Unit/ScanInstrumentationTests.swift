@@ -0,0 +1,102 @@
+//
+//  ScanInstrumentationTests.swift
+//  StripeCardScanTests
+//
+//  Created by Stripe on 10/17/26.
+//
+
+import XCTest
+
+@testable@_spi(STP) import StripeCardScan
+
+class ScanInstrumentationTests: XCTestCase {
+    func testHistogramBucketsArePowersOfTwoMilliseconds() {
+        var histogram = LatencyHistogram()
+        for duration in [0.0005, 0.001, 0.0019, 0.003, 0.012, 0.5, 2.0] {
+            histogram.record(duration)
+        }
+
+        XCTAssertEqual(histogram.buckets, [1, 2, 1, 0, 1, 0, 0, 0, 0, 1, 0, 1])
+        XCTAssertEqual(histogram.count, 7)
+        XCTAssertEqual(histogram.maxDuration, 2.0)
+    }
+
+    func testPercentilesUseBucketUpperBounds() {
+        var histogram = LatencyHistogram()
+        for _ in 0..<9 {
+            histogram.record(0.005)
+        }
+        histogram.record(0.1)
+
+        XCTAssertEqual(histogram.duration(atPercentile: 0.5), 0.008)
+        XCTAssertEqual(histogram.duration(atPercentile: 0.9), 0.008)
+        // the slowest bucket's upper bound is past the longest duration
+        XCTAssertEqual(histogram.duration(atPercentile: 1.0), 0.1)
+        XCTAssertEqual(LatencyHistogram().duration(atPercentile: 0.5), 0.0)
+    }
+
+    func testMeasureRecordsStageAndReturnsResult() {
+        let instrumentation = ScanInstrumentation()
+
+        let result = instrumentation.measure(.nms) { 42 }
+        instrumentation.record(.frame, duration: 0.03)
+
+        let summary = instrumentation.snapshot()
+        XCTAssertEqual(result, 42)
+        XCTAssertEqual(summary.latency(of: .nms).count, 1)
+        XCTAssertEqual(summary.latency(of: .frame).count, 1)
+        XCTAssertEqual(summary.latency(of: .ocrInference).count, 0)
+    }
+
+    func testCountsFramesPerThermalState() {
+        let instrumentation = ScanInstrumentation()
+        instrumentation.recordFrame(thermalState: .nominal)
+        instrumentation.recordFrame(thermalState: .nominal)
+        instrumentation.recordFrame(thermalState: .serious)
+
+        let summary = instrumentation.snapshot()
+        XCTAssertEqual(summary.thermalStateFrames, [2, 0, 1, 0])
+        XCTAssertEqual(summary.maxThermalState, .serious)
+    }
+
+    func testConcurrentMeasurementsAreAllRecorded() {
+        let instrumentation = ScanInstrumentation()
+
+        DispatchQueue.concurrentPerform(iterations: 1000) { _ in
+            instrumentation.record(.appleOcr, duration: 0.01)
+            instrumentation.recordFrame(thermalState: .fair)
+        }
+
+        let summary = instrumentation.snapshot()
+        XCTAssertEqual(summary.latency(of: .appleOcr).count, 1000)
+        XCTAssertEqual(summary.frames(at: .fair), 1000)
+    }
+
+    func testPerformanceInfoSummarizesScanStats() {
+        let instrumentation = ScanInstrumentation()
+        instrumentation.record(.ocrInference, duration: 0.02)
+        instrumentation.recordFrame(thermalState: .fair)
+
+        var scanStats = ScanStats()
+        scanStats.framesDropped = 3
+        scanStats.update(instrumentation: instrumentation)
+
+        let performanceInfo = PerformanceInfo(scanStats: scanStats)
+        XCTAssertEqual(performanceInfo.framesDropped, 3)
+        XCTAssertEqual(performanceInfo.maxThermalState, "fair")
+        XCTAssertEqual(performanceInfo.stageLatencies.map { $0.stage }, ["ocr_inference"])
+        XCTAssertEqual(performanceInfo.stageLatencies.first?.maxMs, 20)
+        XCTAssertEqual(performanceInfo.stageLatencies.first?.p50Ms, 20)
+        XCTAssertEqual(performanceInfo.thermalStateFrames, [0, 1, 0, 0])
+    }
+
+    func testMeasurePerformance() {
+        let instrumentation = ScanInstrumentation()
+
+        measure {
+            for _ in 0..<10_000 {
+                instrumentation.measure(.digitGrouping) {}
+            }
+        }
+    }
+}
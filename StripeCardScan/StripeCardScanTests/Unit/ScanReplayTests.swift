@@ -0,0 +1,130 @@
+//
+//  ScanReplayTests.swift
+//  StripeCardScanTests
+//
+//  Created by Stripe on 10/17/26.
+//
+
+import CoreML
+import XCTest
+
+@testable@_spi(STP) import StripeCardScan
+
+class ScanReplayTests: XCTestCase {
+
+    var recording: ScanRecording?
+    var recordingDirectory: URL?
+
+    override func setUpWithError() throws {
+        let output = try XCTUnwrap(SSDOcrOutputHelpers.recordedOutput())
+        let expectedNumber = SSDOcrDetect().detectOcrObjects(
+            prediction: output,
+            imageSize: CGSize(width: SSDOcrDetect.imageWidth, height: SSDOcrDetect.imageHeight)
+        )
+        XCTAssertNotNil(expectedNumber)
+
+        // 3 seconds of the same frame at 30fps, written out and read back like a real recording
+        let directory = FileManager.default.temporaryDirectory
+            .appendingPathComponent("ScanReplayTests-\(UUID().uuidString)")
+        try ScanRecording.repeating(output, frameCount: 90, expectedNumber: expectedNumber)
+            .write(to: directory)
+        recordingDirectory = directory
+        recording = try ScanRecording.load(from: directory)
+    }
+
+    override func tearDownWithError() throws {
+        if let recordingDirectory = recordingDirectory {
+            try FileManager.default.removeItem(at: recordingDirectory)
+        }
+    }
+
+    func testRecordingRoundTrips() throws {
+        let recording = try XCTUnwrap(recording)
+        let output = try XCTUnwrap(SSDOcrOutputHelpers.recordedOutput())
+        let loaded = try XCTUnwrap(recording.frames.first?.output)
+
+        XCTAssertEqual(recording.frames.count, 90)
+        XCTAssertEqual(recording.frames.last?.centeredCardState, .numberSide)
+        for (original, replayed) in [
+            (output.scores, loaded.scores), (output.boxes, loaded.boxes), (output.filter, loaded.filter),
+        ] {
+            XCTAssertEqual(original.shape, replayed.shape)
+            for index in stride(from: 0, to: 3420, by: 7) {
+                let key: [NSNumber] = [0, 0, 0, NSNumber(value: index), 0]
+                XCTAssertEqual(original[key].floatValue, replayed[key].floatValue)
+            }
+        }
+    }
+
+    func testReplayFinishesOnVirtualClock() throws {
+        let recording = try XCTUnwrap(recording)
+        let report = ScanReplay(recording: recording).run()
+
+        // ocr only finishes 2 seconds after the first number, at frame 60 of the recording, no
+        // matter how long the replay took to run
+        XCTAssertEqual(report.finalState, .finished)
+        XCTAssertEqual(try XCTUnwrap(report.timeToFinish), 2.0, accuracy: 0.0001)
+        XCTAssertEqual(report.frameNumbers.count, 61)
+        XCTAssertEqual(report.isCorrect, true)
+    }
+
+    func testReplayIsDeterministic() throws {
+        let recording = try XCTUnwrap(recording)
+        let first = ScanReplay(recording: recording).run(stateMachine: CardVerifyStateMachine())
+        let second = ScanReplay(recording: recording).run(stateMachine: CardVerifyStateMachine())
+
+        XCTAssertEqual(first.frameNumbers, second.frameNumbers)
+        XCTAssertEqual(first.finalState, second.finalState)
+        XCTAssertEqual(first.finalNumber, second.finalNumber)
+        XCTAssertEqual(first.timeToFinish, second.timeToFinish)
+        XCTAssertEqual(first.finalState, .finished)
+    }
+
+    /// Replays every recording in the directory named by `CARDSCAN_REPLAY_DIRECTORY`, one
+    /// subdirectory per scan, and attaches each scan's latency percentiles and the overall accuracy to
+    /// the test results
+    func testReplayRecordedScans() throws {
+        guard let path = ProcessInfo.processInfo.environment["CARDSCAN_REPLAY_DIRECTORY"] else {
+            throw XCTSkip("Set CARDSCAN_REPLAY_DIRECTORY to replay recorded scans")
+        }
+
+        let scans = try FileManager.default.contentsOfDirectory(
+            at: URL(fileURLWithPath: path),
+            includingPropertiesForKeys: nil
+        ).filter { $0.hasDirectoryPath }.sorted { $0.path < $1.path }
+
+        var correct = 0
+        var known = 0
+        for scan in scans {
+            try XCTContext.runActivity(named: scan.lastPathComponent) { activity in
+                let report = ScanReplay(recording: try ScanRecording.load(from: scan)).run(
+                    stateMachine: CardVerifyStateMachine()
+                )
+                activity.add(keptAttachment(named: "summary", report.summary))
+                if let isCorrect = report.isCorrect {
+                    known += 1
+                    correct += isCorrect ? 1 : 0
+                }
+            }
+        }
+        add(keptAttachment(named: "accuracy", "\(correct)/\(known)"))
+    }
+
+    // MARK: - Benchmarks
+
+    func testReplayPerformance() throws {
+        let recording = try XCTUnwrap(recording)
+        measure(metrics: [XCTClockMetric(), XCTMemoryMetric()]) {
+            _ = ScanReplay(recording: recording).run()
+        }
+    }
+
+    // MARK: - Helpers
+
+    func keptAttachment(named name: String, _ string: String) -> XCTAttachment {
+        let attachment = XCTAttachment(string: string)
+        attachment.name = name
+        attachment.lifetime = .keepAlways
+        return attachment
+    }
+}
@@ -117,6 +117,48 @@ class StrictFramesTests: XCTestCase {
         XCTAssertEqual(cardVerifyStateMachine.visibleMatchingCardCount, 0)
 
     }
+
+    func testCardVerifyStateMachine_ClearLeader_FinishesEarly() {
+        let cardVerifyStateMachine = CardVerifyStateMachine(
+            requiredLastFour: correctCardNumber.last4
+        )
+
+        /// Mock that we have been in `ocrAndCard` for 1 second, short of the usual 1.5 seconds, but every
+        /// frame so far read the same number
+        cardVerifyStateMachine.state = .ocrAndCard
+        cardVerifyStateMachine.startTimeForCurrentState = Date().addingTimeInterval(-1)
+        cardVerifyStateMachine.numberConfidence = VoteConfidence(
+            leaderVotes: 8,
+            runnerUpVotes: 0,
+            totalVotes: 8
+        )
+
+        transition(
+            stateMachine: cardVerifyStateMachine,
+            prediction: matchNumberPrediction(cardVisible: true)
+        )
+        XCTAssertEqual(cardVerifyStateMachine.state, .finished)
+    }
+
+    func testCardVerifyStateMachine_ContestedLeader_WaitsForFullDuration() {
+        let cardVerifyStateMachine = CardVerifyStateMachine(
+            requiredLastFour: correctCardNumber.last4
+        )
+
+        cardVerifyStateMachine.state = .ocrAndCard
+        cardVerifyStateMachine.startTimeForCurrentState = Date().addingTimeInterval(-1)
+        cardVerifyStateMachine.numberConfidence = VoteConfidence(
+            leaderVotes: 5,
+            runnerUpVotes: 3,
+            totalVotes: 8
+        )
+
+        transition(
+            stateMachine: cardVerifyStateMachine,
+            prediction: matchNumberPrediction(cardVisible: true)
+        )
+        XCTAssertEqual(cardVerifyStateMachine.state, .ocrAndCard)
+    }
 }
 
 extension StrictFramesTests {
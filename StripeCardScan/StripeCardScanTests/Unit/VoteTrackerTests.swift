@@ -0,0 +1,114 @@
+//
+//  VoteTrackerTests.swift
+//  StripeCardScanTests
+//
+//  Created by Stripe on 10/17/26.
+//
+
+import StripeCoreTestUtils
+import XCTest
+
+@testable@_spi(STP) import StripeCardScan
+
+class VoteTrackerTests: XCTestCase {
+
+    func testLeaderFollowsVotes() {
+        var tracker = VoteTracker<String>()
+        XCTAssertNil(tracker.leader)
+
+        tracker.vote(for: "a")
+        tracker.vote(for: "b")
+        tracker.vote(for: "b")
+        XCTAssertEqual(tracker.leader, "b")
+        XCTAssertEqual(
+            tracker.confidence,
+            VoteConfidence(leaderVotes: 2, runnerUpVotes: 1, totalVotes: 3)
+        )
+
+        tracker.vote(for: "a")
+        tracker.vote(for: "a")
+        XCTAssertEqual(tracker.leader, "a")
+        XCTAssertEqual(tracker.confidence.runnerUpVotes, 2)
+        XCTAssertEqual(tracker.count, 2)
+    }
+
+    func testTiesGoToFirstCandidate() {
+        var tracker = VoteTracker<String>()
+        tracker.vote(for: "a")
+        tracker.vote(for: "b")
+
+        XCTAssertEqual(tracker.leader, "a")
+        XCTAssertEqual(tracker.confidence.margin, 0)
+    }
+
+    func testMatchesSortingDictionaryOfCounts() {
+        var generator = SplitMix64(seed: 0x707E)
+        for _ in 0..<50 {
+            var tracker = VoteTracker<Int>()
+            var counts: [Int: Int] = [:]
+            for _ in 0..<200 {
+                let candidate = Int.random(in: 0..<8, using: &generator)
+                tracker.vote(for: candidate)
+                counts[candidate, default: 0] += 1
+
+                let sorted = counts.values.sorted(by: >)
+                XCTAssertEqual(counts[tracker.leader!], sorted[0])
+                XCTAssertEqual(tracker.confidence.leaderVotes, Double(sorted[0]))
+                XCTAssertEqual(tracker.confidence.runnerUpVotes, Double(sorted.count > 1 ? sorted[1] : 0))
+            }
+        }
+    }
+
+    func testDecayFavorsRecentVotes() {
+        var tracker = VoteTracker<String>(decay: 0.5)
+        for _ in 0..<3 {
+            tracker.nextFrame()
+            tracker.vote(for: "old")
+        }
+        for _ in 0..<2 {
+            tracker.nextFrame()
+            tracker.vote(for: "new")
+        }
+
+        XCTAssertEqual(tracker.leader, "new")
+        XCTAssertEqual(tracker.votes(for: "new"), 1.5, accuracy: 1e-9)
+        XCTAssertEqual(tracker.votes(for: "old"), 0.4375, accuracy: 1e-9)
+    }
+
+    func testDecayRescalesWithoutChangingVotes() {
+        var tracker = VoteTracker<String>(decay: 0.5)
+        for _ in 0..<1000 {
+            tracker.nextFrame()
+            tracker.vote(for: "a")
+        }
+
+        XCTAssertEqual(tracker.leader, "a")
+        XCTAssertEqual(tracker.votes(for: "a"), 2.0, accuracy: 1e-9)
+        XCTAssertEqual(tracker.confidence.margin, 1.0, accuracy: 1e-9)
+    }
+
+    // MARK: - Benchmarks
+
+    func testSortingLeaderPerformance() {
+        let candidates = (0..<30).map { "424242424242\(String(format: "%04d", $0))" }
+        measure {
+            var counts: [String: Int] = [:]
+            for frame in 0..<5_000 {
+                let candidate = candidates[frame % candidates.count]
+                counts[candidate] = (counts[candidate] ?? 0) + 1
+                _ = counts.sorted { $0.1 > $1.1 }.map { $0.0 }.first
+            }
+        }
+    }
+
+    func testVoteTrackerLeaderPerformance() {
+        let candidates = (0..<30).map { "424242424242\(String(format: "%04d", $0))" }
+        measure {
+            var tracker = VoteTracker<String>()
+            for frame in 0..<5_000 {
+                tracker.vote(for: candidates[frame % candidates.count])
+                _ = tracker.leader
+            }
+        }
+    }
+}
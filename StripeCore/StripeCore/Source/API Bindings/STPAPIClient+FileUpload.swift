@@ -37,6 +37,17 @@ extension STPAPIClient {
         public let fileSizeBytes: Int
     }
 
+    /// How an image upload sends its multipart/form-data body.
+    @_spi(STP) public enum FileUploadMode {
+        /// Builds the body in memory and sends it as the request's body.
+        case inMemory
+        /// Writes the body to a temporary file one part at a time and uploads it from there with
+        /// `URLSession.uploadTask(with:fromFile:)`, so that the body isn't in memory next to the
+        /// encoded image. Uploads that fail with a transient network error are resumed or restarted
+        /// from the file. See `URLSession.stp_performUploadTask`.
+        case streamedFromFile
+    }
+
     @_spi(STP) public static let defaultImageFileName = "image"
 
     func data(
@@ -96,6 +107,14 @@ extension STPAPIClient {
         }
     }
 
+    /// Uses the Stripe file upload API to upload a JPEG encoded image, and reports how long it took.
+    ///
+    /// See `uploadImage(_:compressionQuality:purpose:fileName:ownedBy:ephemeralKeySecret:completion:)`.
+    ///
+    /// - Parameters:
+    ///   - uploadMode: Whether to send the body from memory or stream it from a temporary file.
+    ///   - progressHandler: Called on the main queue with the fraction of the body uploaded so far.
+    ///     Only streamed uploads report progress.
     @_spi(STP) public func uploadImageAndGetMetrics(
         _ image: UIImage,
         compressionQuality: CGFloat = UIImage.defaultCompressionQuality,
@@ -103,6 +122,8 @@ extension STPAPIClient {
         fileName: String = defaultImageFileName,
         ownedBy: String? = nil,
         ephemeralKeySecret: String? = nil,
+        uploadMode: FileUploadMode = .inMemory,
+        progressHandler: ((Double) -> Void)? = nil,
         completion: @escaping (Result<FileAndUploadMetrics, Error>) -> Void
     ) {
         let purposePart = STPMultipartFormDataPart()
@@ -133,34 +154,84 @@ extension STPAPIClient {
 
         let boundary = STPMultipartFormDataEncoder.generateBoundary()
         let parts = [purposePart, ownedByPart, imagePart].compactMap { $0 }
-        let data = STPMultipartFormDataEncoder.multipartFormData(
-            for: parts,
-            boundary: boundary
-        )
+        let fileSizeBytes = imagePart.data?.count ?? 0
 
         var request = configuredRequest(
             for: URL(string: FileUploadURL)!,
             using: ephemeralKeySecret
         )
         request.httpMethod = HTTPMethod.post.rawValue
-        request.stp_setMultipartForm(data, boundary: boundary)
 
         let requestStartTime = Date()
-        sendRequest(
-            request: request,
-            completion: { (result: Result<StripeFile, Error>) in
-                let timeToUpload = Date().timeIntervalSince(requestStartTime)
-                completion(
-                    result.map {
-                        (
-                            file: $0,
-                            metrics: .init(
-                                timeToUpload: timeToUpload,
-                                fileSizeBytes: imagePart.data?.count ?? 0
-                            )
+        let requestCompletion: (Result<StripeFile, Error>) -> Void = { result in
+            let timeToUpload = Date().timeIntervalSince(requestStartTime)
+            completion(
+                result.map {
+                    (
+                        file: $0,
+                        metrics: .init(
+                            timeToUpload: timeToUpload,
+                            fileSizeBytes: fileSizeBytes
                         )
-                    }
+                    )
+                }
+            )
+        }
+
+        switch uploadMode {
+        case .inMemory:
+            let data = STPMultipartFormDataEncoder.multipartFormData(
+                for: parts,
+                boundary: boundary
+            )
+            request.stp_setMultipartForm(data, boundary: boundary)
+            sendRequest(request: request, completion: requestCompletion)
+        case .streamedFromFile:
+            let fileURL = FileManager.default.temporaryDirectory
+                .appendingPathComponent("stripe-upload-\(UUID().uuidString)")
+            let contentLength: Int
+            do {
+                contentLength = try STPMultipartFormDataEncoder.writeMultipartFormData(
+                    for: parts,
+                    boundary: boundary,
+                    to: fileURL
                 )
+            } catch {
+                try? FileManager.default.removeItem(at: fileURL)
+                DispatchQueue.main.async {
+                    requestCompletion(.failure(error))
+                }
+                return
+            }
+            request.stp_setMultipartFormHeaders(contentLength: contentLength, boundary: boundary)
+            sendUploadRequest(
+                request: request,
+                fromFile: fileURL,
+                progressHandler: progressHandler
+            ) { (result: Result<StripeFile, Error>) in
+                try? FileManager.default.removeItem(at: fileURL)
+                requestCompletion(result)
+            }
+        }
+    }
+
+    /// Like `sendRequest(request:completion:)`, but uploads the body from a file
+    func sendUploadRequest<T: Decodable>(
+        request: URLRequest,
+        fromFile fileURL: URL,
+        progressHandler: ((Double) -> Void)?,
+        completion: @escaping (Result<T, Error>) -> Void
+    ) {
+        urlSession.stp_performUploadTask(
+            with: request,
+            fromFile: fileURL,
+            progressHandler: progressHandler,
+            completionHandler: { (data, response, error) in
+                DispatchQueue.main.async {
+                    completion(
+                        STPAPIClient.decodeResponse(data: data, error: error, response: response, request: request)
+                    )
+                }
             }
         )
     }
@@ -179,6 +250,7 @@ extension STPAPIClient {
     ///     automatically be appended to this name.
     ///   - ownedBy: A Stripe-internal property that sets the owner of the file.
     ///   - ephemeralKeySecret: Authorization key, if applicable.
+    ///   - uploadMode: Whether to send the body from memory or stream it from a temporary file.
     ///
     /// - Returns: A promise that resolves to a Stripe file and upload metrics, if successful, or an
     ///   error that may have occurred.
@@ -195,7 +267,8 @@ extension STPAPIClient {
         purpose: String,
         fileName: String = defaultImageFileName,
         ownedBy: String? = nil,
-        ephemeralKeySecret: String? = nil
+        ephemeralKeySecret: String? = nil,
+        uploadMode: FileUploadMode = .inMemory
     ) -> Future<FileAndUploadMetrics> {
         let promise = Promise<FileAndUploadMetrics>()
         uploadImageAndGetMetrics(
@@ -204,7 +277,8 @@ extension STPAPIClient {
             purpose: purpose,
             fileName: fileName,
             ownedBy: ownedBy,
-            ephemeralKeySecret: ephemeralKeySecret
+            ephemeralKeySecret: ephemeralKeySecret,
+            uploadMode: uploadMode
         ) { result in
             promise.fullfill(with: result)
         }
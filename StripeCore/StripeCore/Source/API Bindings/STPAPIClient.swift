@@ -557,6 +557,28 @@ extension STPAPIClient {
         }
     }
 
+    /// Make a POST request with a multipart/form-data body built by `STPMultipartFormDataEncoder`.
+    ///
+    /// - Returns: a promise that is fullfilled when the request is complete.
+    @_spi(STP) public func postMultipartForm<O: Decodable>(
+        resource: String,
+        body: Data,
+        boundary: String,
+        ephemeralKeySecret: String? = nil
+    ) -> Promise<O> {
+        let promise = Promise<O>()
+        var request = configuredRequest(
+            for: apiURL.appendingPathComponent(resource),
+            using: ephemeralKeySecret
+        )
+        request.httpMethod = HTTPMethod.post.rawValue
+        request.stp_setMultipartForm(body, boundary: boundary)
+        sendRequest(request: request) { (result: Result<O, Error>) in
+            promise.fullfill(with: result)
+        }
+        return promise
+    }
+
     func sendRequest<T: Decodable>(
         request: URLRequest,
         completion: @escaping (Result<T, Error>) -> Void
@@ -11,28 +11,75 @@ import Foundation
 /// Encoder class to generate the HTTP body data for a multipart/form-data request.
 ///
 /// - seealso: https://www.w3.org/TR/html401/interact/forms.html#h-17.13.4
-class STPMultipartFormDataEncoder: NSObject {
+@_spi(STP) public class STPMultipartFormDataEncoder: NSObject {
     /// Generates the HTTP body data from an array of parts.
-    class func multipartFormData(for parts: [STPMultipartFormDataPart], boundary: String) -> Data {
+    @_spi(STP) public class func multipartFormData(
+        for parts: [STPMultipartFormDataPart],
+        boundary: String
+    ) -> Data {
         var data = Data()
-        let boundaryData = "--\(boundary)\r\n".data(using: .utf8)
-
         for part in parts {
-            if let boundaryData = boundaryData {
-                data.append(boundaryData)
-            }
-            data.append(part.composedData())
+            append(part, to: &data, boundary: boundary)
+        }
+        appendClosingBoundary(to: &data, boundary: boundary)
+        return data
+    }
+
+    /// Appends a part to an HTTP body that's being built one part at a time, e.g. as the data for
+    /// each part is produced. Finish the body with `appendClosingBoundary(to:boundary:)`.
+    @_spi(STP) public class func append(
+        _ part: STPMultipartFormDataPart,
+        to data: inout Data,
+        boundary: String
+    ) {
+        data.append(contentsOf: "--\(boundary)\r\n".utf8)
+        part.append(to: &data)
+    }
+
+    /// Appends the boundary that ends an HTTP body built with `append(_:to:boundary:)`.
+    @_spi(STP) public class func appendClosingBoundary(to data: inout Data, boundary: String) {
+        data.append(contentsOf: "--\(boundary)--\r\n".utf8)
+    }
+
+    /// Writes the same HTTP body as `multipartFormData(for:boundary:)` to a new file at `fileURL`.
+    ///
+    /// Each part's data is written straight to the file, so the body is never in memory all at once.
+    ///
+    /// - Returns: The size of the body in bytes.
+    @_spi(STP) public class func writeMultipartFormData(
+        for parts: [STPMultipartFormDataPart],
+        boundary: String,
+        to fileURL: URL
+    ) throws -> Int {
+        guard FileManager.default.createFile(atPath: fileURL.path, contents: nil) else {
+            throw CocoaError(.fileWriteUnknown, userInfo: [NSFilePathErrorKey: fileURL.path])
         }
+        let fileHandle = try FileHandle(forWritingTo: fileURL)
+        defer { try? fileHandle.close() }
 
-        if let data1 = "--\(boundary)--\r\n".data(using: .utf8) {
-            data.append(data1)
+        var byteCount = 0
+        func write(_ data: Data) throws {
+            try fileHandle.write(contentsOf: data)
+            byteCount += data.count
         }
 
-        return data
+        for part in parts {
+            var headers = Data("--\(boundary)\r\n".utf8)
+            part.appendHeaders(to: &headers)
+            try write(headers)
+            if let data = part.data {
+                try write(data)
+            }
+            try write(STPMultipartFormDataPart.trailer)
+        }
+        var closingBoundary = Data()
+        appendClosingBoundary(to: &closingBoundary, boundary: boundary)
+        try write(closingBoundary)
+        return byteCount
     }
 
     /// Generates a unique boundary string to be used between parts.
-    class func generateBoundary() -> String {
+    @_spi(STP) public class func generateBoundary() -> String {
         return "Stripe-iOS-\(UUID().uuidString)"
     }
 }
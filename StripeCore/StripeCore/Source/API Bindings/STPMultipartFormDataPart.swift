@@ -11,53 +11,57 @@ import Foundation
 /// Represents a single part of a multipart/form-data upload.
 ///
 /// - seealso: https://www.w3.org/TR/html401/interact/forms.html#h-17.13.4
-class STPMultipartFormDataPart: NSObject {
+@_spi(STP) public class STPMultipartFormDataPart: NSObject {
     /// The data for this part.
-    var data: Data?
+    @_spi(STP) public var data: Data?
     /// The name for this part.
-    var name: String?
+    @_spi(STP) public var name: String?
     /// The filename for this part.
     ///
     /// As a rule of thumb, this can be ommitted when the data is just an encoded string.
     /// However, this is typically required for other types of binary file data (like images).
-    var filename: String?
+    @_spi(STP) public var filename: String?
     /// The content type for this part.
     ///
     /// When omitted, the multipart/form-data standard assumes text/plain.
-    var contentType: String?
+    @_spi(STP) public var contentType: String?
 
     // MARK: - Data Composition
 
     /// Returns the fully-composed data for this part.
-    func composedData() -> Data {
+    @_spi(STP) public func composedData() -> Data {
         var data = Data()
+        append(to: &data)
+        return data
+    }
 
+    /// Appends the fully-composed data for this part to `data`, without copying the part's data
+    /// anywhere else first.
+    @_spi(STP) public func append(to data: inout Data) {
+        appendHeaders(to: &data)
+        if let _data = self.data {
+            data.append(_data)
+        }
+        data.append(contentsOf: STPMultipartFormDataPart.trailer)
+    }
+
+    /// Appends everything that comes before the part's data: its headers and the blank line after them.
+    func appendHeaders(to data: inout Data) {
         var contentDisposition = "Content-Disposition: form-data; name=\"\(name ?? "")\""
         if filename != nil {
             contentDisposition += "; filename=\"\(filename ?? "")\""
         }
         contentDisposition += "\r\n"
-
-        if let data1 = contentDisposition.data(using: .utf8) {
-            data.append(data1)
-        }
+        data.append(contentsOf: contentDisposition.utf8)
 
         var contentType = ""
         if let _contentType = self.contentType {
             contentType.append("Content-Type: \(_contentType)\r\n")
         }
         contentType += "\r\n"
-        if let data1 = contentType.data(using: .utf8) {
-            data.append(data1)
-        }
-
-        if let _data = self.data {
-            data.append(_data)
-        }
-        if let data1 = "\r\n".data(using: .utf8) {
-            data.append(data1)
-        }
-
-        return data
+        data.append(contentsOf: contentType.utf8)
     }
+
+    /// What comes after the part's data
+    static let trailer = Data("\r\n".utf8)
 }
@@ -41,8 +41,14 @@ extension URLRequest {
 
     @_spi(STP) public mutating func stp_setMultipartForm(_ data: Data?, boundary: String?) {
         httpBody = data
+        stp_setMultipartFormHeaders(contentLength: data?.count ?? 0, boundary: boundary)
+    }
+
+    /// Sets the headers for a multipart/form-data body that's sent separately from the request,
+    /// e.g. with `URLSession.uploadTask(with:fromFile:)`
+    @_spi(STP) public mutating func stp_setMultipartFormHeaders(contentLength: Int, boundary: String?) {
         setValue(
-            String(format: "%lu", UInt(data?.count ?? 0)),
+            String(format: "%lu", UInt(contentLength)),
             forHTTPHeaderField: "Content-Length"
         )
         setValue(
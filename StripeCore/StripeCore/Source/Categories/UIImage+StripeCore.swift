@@ -16,6 +16,7 @@ extension UIImage {
     /// Encodes the image to jpeg at the specified compression quality.
     ///
     /// The image will be scaled down, if needed, to ensure its size does not exceed `maxBytes`.
+    /// See `ByteBudgetImageEncoder` for how the size is picked.
     ///
     /// - Parameters:
     ///   - maxBytes: The maximum size of the allowed file. If value is nil, then
@@ -32,7 +33,8 @@ extension UIImage {
     ) -> ImageDataAndSize {
         dataAndDimensions(
             maxBytes: maxBytes,
-            compressionQuality: compressionQuality
+            compressionQuality: compressionQuality,
+            format: .jpeg
         ) { image, quality in
             image.jpegData(compressionQuality: quality)
         }
@@ -41,6 +43,7 @@ extension UIImage {
     /// Encodes the image to heic at the specified compression quality.
     ///
     /// The image will be scaled down, if needed, to ensure its size does not exceed `maxBytes`.
+    /// See `ByteBudgetImageEncoder` for how the size is picked.
     ///
     /// - Parameters:
     ///   - maxBytes: The maximum size of the allowed file. If value is nil, then
@@ -57,7 +60,8 @@ extension UIImage {
     ) -> ImageDataAndSize {
         dataAndDimensions(
             maxBytes: maxBytes,
-            compressionQuality: compressionQuality
+            compressionQuality: compressionQuality,
+            format: .heic
         ) { image, quality in
             image.heicData(compressionQuality: quality)
         }
@@ -107,8 +111,29 @@ extension UIImage {
     private func dataAndDimensions(
         maxBytes: Int? = nil,
         compressionQuality: CGFloat = defaultCompressionQuality,
+        format: ByteBudgetImageEncoder.Format,
         imageDataProvider: ((_ image: UIImage, _ quality: CGFloat) -> Data?)
     ) -> ImageDataAndSize {
+        if let maxBytes = maxBytes,
+            let cgImage = cgImage,
+            let (data, pixelSize) = ByteBudgetImageEncoder(
+                cgImage: cgImage,
+                orientation: CGImagePropertyOrientation(imageOrientation),
+                format: format
+            ).encode(maxBytes: maxBytes, compressionQuality: compressionQuality)
+        {
+            // `pixelSize` is before orientation, and `size` is in points
+            let isRotated = imageOrientation.isRotated
+            return (
+                imageData: data,
+                imageSize: CGSize(
+                    width: (isRotated ? pixelSize.height : pixelSize.width) / scale,
+                    height: (isRotated ? pixelSize.width : pixelSize.height) / scale
+                )
+            )
+        }
+
+        // Images that aren't backed by a `CGImage` fall back to scaling down until they fit
         var imageData = imageDataProvider(self, compressionQuality)
 
         guard imageData != nil else {
@@ -147,6 +172,36 @@ extension UIImage {
     }
 }
 
+extension UIImage.Orientation {
+    /// Whether the image's width and height are swapped when it's displayed
+    var isRotated: Bool {
+        switch self {
+        case .left, .leftMirrored, .right, .rightMirrored:
+            return true
+        case .up, .upMirrored, .down, .downMirrored:
+            return false
+        @unknown default:
+            return false
+        }
+    }
+}
+
+extension CGImagePropertyOrientation {
+    init(_ orientation: UIImage.Orientation) {
+        switch orientation {
+        case .up: self = .up
+        case .upMirrored: self = .upMirrored
+        case .down: self = .down
+        case .downMirrored: self = .downMirrored
+        case .left: self = .left
+        case .leftMirrored: self = .leftMirrored
+        case .right: self = .right
+        case .rightMirrored: self = .rightMirrored
+        @unknown default: self = .up
+        }
+    }
+}
+
 extension Array where Element: UIImage {
     @_spi(STP) public func heicData(
         compressionQuality: CGFloat = UIImage.defaultCompressionQuality
@@ -0,0 +1,310 @@
+//
+//  ByteBudgetImageEncoder.swift
+//  StripeCore
+//
+//  Created by Stripe on 10/17/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+import Accelerate
+import AVFoundation
+import CoreGraphics
+import Foundation
+import ImageIO
+
+/// Encodes an image so that it fits in a byte budget, with as few full size encodes as possible.
+///
+/// The image is encoded as it is first, and returned if it fits, which takes a single encode.
+/// Otherwise, scaling it down by a guess and re-encoding it until it fits can take several more full
+/// size encodes. Instead, the encoder encodes two small downsampled copies of the image and fits
+/// `bytes = a * pixels^b` through them and the encode that missed, which captures that a smaller copy
+/// of a photo takes more bytes per pixel than the original. It then encodes the largest size the model
+/// says fits, so the next encode usually fits. If it doesn't, the model is recalibrated from that
+/// encode and the next try lands just under the budget.
+///
+/// When fitting the budget at the requested quality would take shrinking the image below
+/// `minimumPreferredScale`, the quality is lowered, down to `minimumQualityRatio` of the requested
+/// quality, before the image is shrunk any further.
+///
+/// Downscaling is done with vImage from one decoded copy of the image, which is only made if the
+/// image needs scaling. Instances are not thread safe.
+@_spi(STP) public final class ByteBudgetImageEncoder {
+    @_spi(STP) public enum Format {
+        case jpeg
+        case heic
+
+        var typeIdentifier: CFString {
+            switch self {
+            case .jpeg:
+                return AVFileType.jpg as CFString
+            case .heic:
+                return AVFileType.heic as CFString
+            }
+        }
+    }
+
+    /// Longest sides of the downsampled copies encoded to fit the size model
+    static let trialLongSides = [256, 512]
+    /// Fraction of `maxBytes` the encoder aims for when scaling the image down, so that encoder variance
+    /// doesn't push it over
+    static let budgetMargin = 0.92
+    /// Before scaling the image down by more than this, the encoder lowers the quality instead
+    static let minimumPreferredScale = 0.5
+    /// How far below the requested quality the encoder is allowed to go
+    static let minimumQualityRatio: CGFloat = 0.7
+    /// The range the fitted exponent is clamped to. Encoded size grows slower than pixel count,
+    /// but never much slower.
+    static let exponentRange = 0.6...1.0
+    /// Exponent used until there are two encodes to fit it from
+    static let defaultExponent = 0.9
+
+    let cgImage: CGImage
+    let orientation: CGImagePropertyOrientation
+    let format: Format
+
+    /// Encodes done so far, including the downsampled trial encodes
+    @_spi(STP) public private(set) var encodeCount = 0
+
+    private var sourceBuffer: vImage_Buffer?
+    private let bufferFormat = vImage_CGImageFormat(
+        bitsPerComponent: 8,
+        bitsPerPixel: 32,
+        colorSpace: CGColorSpaceCreateDeviceRGB(),
+        bitmapInfo: CGBitmapInfo(rawValue: CGImageAlphaInfo.premultipliedFirst.rawValue)
+    )
+
+    /// - Parameters:
+    ///   - cgImage: The pixels to encode
+    ///   - orientation: Written to the encoded image's metadata, the pixels aren't rotated
+    @_spi(STP) public init(
+        cgImage: CGImage,
+        orientation: CGImagePropertyOrientation = .up,
+        format: Format
+    ) {
+        self.cgImage = cgImage
+        self.orientation = orientation
+        self.format = format
+    }
+
+    deinit {
+        sourceBuffer?.free()
+    }
+
+    /// Encodes the image at the largest size that fits in `maxBytes`.
+    ///
+    /// - Returns: The encoded data and its size in pixels, before orientation, or `nil` if the image
+    ///   couldn't be encoded.
+    @_spi(STP) public func encode(
+        maxBytes: Int,
+        compressionQuality: CGFloat
+    ) -> (data: Data, pixelSize: CGSize)? {
+        let fullSize = CGSize(width: cgImage.width, height: cgImage.height)
+        let longSide = max(cgImage.width, cgImage.height)
+        let budget = Double(maxBytes) * ByteBudgetImageEncoder.budgetMargin
+
+        // most images already fit, which doesn't need the size model or a decoded copy of the image
+        guard let fullData = encode(size: fullSize, quality: compressionQuality) else {
+            return nil
+        }
+        if fullData.count <= maxBytes {
+            return (fullData, fullSize)
+        }
+
+        // fit the model to small copies of the image, and make it go through the full size encode
+        var model = SizeModel()
+        for trialLongSide in ByteBudgetImageEncoder.trialLongSides where trialLongSide < longSide {
+            let size = scaledSize(fullSize, scale: Double(trialLongSide) / Double(longSide))
+            guard let data = encode(size: size, quality: compressionQuality) else {
+                return nil
+            }
+            model.add(pixels: size.width * size.height, bytes: data.count)
+        }
+        model.add(pixels: fullSize.width * fullSize.height, bytes: fullData.count)
+
+        var quality = compressionQuality
+        var scale = min(model.scale(fitting: budget, pixels: fullSize.width * fullSize.height), 1.0)
+        if scale < ByteBudgetImageEncoder.minimumPreferredScale,
+            let qualityChoice = lowerQuality(
+                fullSize: fullSize,
+                budget: budget,
+                model: model,
+                compressionQuality: compressionQuality
+            )
+        {
+            quality = qualityChoice.quality
+            model = qualityChoice.model
+            scale = min(model.scale(fitting: budget, pixels: fullSize.width * fullSize.height), 1.0)
+        }
+
+        while true {
+            let size = scaledSize(fullSize, scale: scale)
+            guard let data = encode(size: size, quality: quality) else {
+                return nil
+            }
+            if data.count <= maxBytes || (size.width <= 1 && size.height <= 1) {
+                return (data, size)
+            }
+
+            // recalibrate from the size that missed, and shrink by at least 10% so that this always ends
+            let pixels = size.width * size.height
+            model.calibrate(pixels: pixels, bytes: data.count)
+            scale = min(model.scale(fitting: budget, pixels: fullSize.width * fullSize.height), scale * 0.9)
+        }
+    }
+
+    // MARK: - Size model
+
+    /// `bytes = a * pixels^b` for one quality
+    struct SizeModel {
+        private(set) var points: [(pixels: Double, bytes: Double)] = []
+        private(set) var coefficient = 0.0
+        private(set) var exponent = ByteBudgetImageEncoder.defaultExponent
+
+        mutating func add(pixels: CGFloat, bytes: Int) {
+            points.append((Double(pixels), Double(max(bytes, 1))))
+            if let first = points.first, let last = points.last, last.pixels > first.pixels {
+                let fitted = log(last.bytes / first.bytes) / log(last.pixels / first.pixels)
+                exponent = min(
+                    max(fitted, ByteBudgetImageEncoder.exponentRange.lowerBound),
+                    ByteBudgetImageEncoder.exponentRange.upperBound
+                )
+            }
+            calibrate(pixels: pixels, bytes: bytes)
+        }
+
+        /// Keeps the exponent and makes the model go through this encode
+        mutating func calibrate(pixels: CGFloat, bytes: Int) {
+            coefficient = Double(max(bytes, 1)) / pow(Double(pixels), exponent)
+        }
+
+        func bytes(pixels: Double) -> Double {
+            return coefficient * pow(pixels, exponent)
+        }
+
+        /// The linear scale at which an image of `pixels` pixels should encode to `budget` bytes
+        func scale(fitting budget: Double, pixels: CGFloat) -> Double {
+            guard coefficient > 0, pixels > 0 else {
+                return 1.0
+            }
+            let targetPixels = pow(budget / coefficient, 1.0 / exponent)
+            return (targetPixels / Double(pixels)).squareRoot()
+        }
+
+        func scaled(by factor: Double) -> SizeModel {
+            var model = self
+            model.coefficient *= factor
+            return model
+        }
+    }
+
+    /// Picks a quality between the requested one and `minimumQualityRatio` of it that fits the budget
+    /// at `minimumPreferredScale`, assuming encoded size shrinks linearly between the two qualities.
+    /// The size ratio between the qualities is measured on the largest trial, or on the full size image
+    /// if it's no bigger than the trials.
+    private func lowerQuality(
+        fullSize: CGSize,
+        budget: Double,
+        model: SizeModel,
+        compressionQuality: CGFloat
+    ) -> (quality: CGFloat, model: SizeModel)? {
+        let lowestQuality = compressionQuality * ByteBudgetImageEncoder.minimumQualityRatio
+        let fullPixels = Double(fullSize.width * fullSize.height)
+        guard let trial = model.points.last(where: { $0.pixels < fullPixels }) ?? model.points.last,
+            lowestQuality > 0
+        else {
+            return nil
+        }
+
+        let trialScale = (trial.pixels / fullPixels).squareRoot()
+        let trialSize = scaledSize(fullSize, scale: trialScale)
+        guard let data = encode(size: trialSize, quality: lowestQuality) else {
+            return nil
+        }
+        let lowestRatio = min(Double(data.count) / trial.bytes, 1.0)
+        guard lowestRatio < 1.0 else {
+            return nil
+        }
+
+        let preferredScale = ByteBudgetImageEncoder.minimumPreferredScale
+        let preferredPixels = fullPixels * preferredScale * preferredScale
+        let neededRatio = budget / model.bytes(pixels: preferredPixels)
+        let ratio = min(max(neededRatio, lowestRatio), 1.0)
+        let qualityFraction = (1.0 - ratio) / (1.0 - lowestRatio)
+        let quality = compressionQuality - CGFloat(qualityFraction) * (compressionQuality - lowestQuality)
+        return (quality, model.scaled(by: ratio))
+    }
+
+    // MARK: - Encoding
+
+    private func scaledSize(_ size: CGSize, scale: Double) -> CGSize {
+        guard scale < 1.0 else {
+            return size
+        }
+        return CGSize(
+            width: max(floor(size.width * CGFloat(scale)), 1),
+            height: max(floor(size.height * CGFloat(scale)), 1)
+        )
+    }
+
+    private func encode(size: CGSize, quality: CGFloat) -> Data? {
+        encodeCount += 1
+
+        let image: CGImage?
+        if Int(size.width) == cgImage.width && Int(size.height) == cgImage.height {
+            image = cgImage
+        } else {
+            image = scaledImage(width: Int(size.width), height: Int(size.height))
+        }
+        guard let image = image,
+            let mutableData = CFDataCreateMutable(nil, 0),
+            let destination = CGImageDestinationCreateWithData(
+                mutableData,
+                format.typeIdentifier,
+                1,
+                nil
+            )
+        else {
+            return nil
+        }
+
+        let properties: [CFString: Any] = [
+            kCGImageDestinationLossyCompressionQuality: quality,
+            kCGImagePropertyOrientation: orientation.rawValue,
+        ]
+        CGImageDestinationAddImage(destination, image, properties as CFDictionary)
+        guard CGImageDestinationFinalize(destination) else {
+            return nil
+        }
+        return mutableData as Data
+    }
+
+    private func scaledImage(width: Int, height: Int) -> CGImage? {
+        guard let bufferFormat = bufferFormat else {
+            return nil
+        }
+        if sourceBuffer == nil {
+            sourceBuffer = try? vImage_Buffer(cgImage: cgImage, format: bufferFormat)
+        }
+        guard var source = sourceBuffer,
+            var destination = try? vImage_Buffer(
+                width: width,
+                height: height,
+                bitsPerPixel: bufferFormat.bitsPerPixel
+            )
+        else {
+            return nil
+        }
+        defer { destination.free() }
+
+        let error = vImageScale_ARGB8888(
+            &source,
+            &destination,
+            nil,
+            vImage_Flags(kvImageHighQualityResampling)
+        )
+        guard error == kvImageNoError else {
+            return nil
+        }
+        return try? destination.createCGImage(format: bufferFormat)
+    }
+}
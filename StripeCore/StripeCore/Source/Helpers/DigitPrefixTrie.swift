@@ -0,0 +1,193 @@
+//
+//  DigitPrefixTrie.swift
+//  StripeCore
+//
+//  Created by Stripe on 10/17/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+import Foundation
+
+/// An immutable trie over the digits of card numbers, for looking up which of a list of account
+/// ranges (BIN ranges, brand prefixes) a card number or a partially typed one falls into.
+///
+/// Each range `low...high` is stored as the few prefixes that exactly cover it, e.g. `"40"..."49"`
+/// is just `"4"`, and `"450628"..."450629"` is `"450628"` and `"450629"`. A lookup walks one node
+/// per digit of the number, so its cost depends on the length of the number rather than on the
+/// number of ranges.
+///
+/// Ranges are identified by their index in the list the trie was built from, and lookups return
+/// indices in that order. Ranges whose bounds aren't digit strings of the same length (at most 18
+/// digits, so they compare the same as `Int`s), or whose low bound is above the high bound, can't be
+/// indexed. They are listed in `unindexedRanges` for callers to check themselves.
+@_spi(STP) public struct DigitPrefixTrie {
+    private static let radix = 10
+    private static let maxIndexedLength = 18
+
+    /// The child of each node for each digit, `radix` entries per node, 0 for no child
+    private var children: [Int32] = []
+    /// Ranges that contain every number under each node
+    private var covering: [[Int]] = []
+    /// Ranges that contain at least one number under each node, including `covering`
+    private var below: [[Int]] = []
+
+    /// Indices of the ranges that lookups don't return
+    @_spi(STP) public private(set) var unindexedRanges: [Int] = []
+
+    @_spi(STP) public init(
+        ranges: [(low: String, high: String)]
+    ) {
+        addNode()
+        for (index, range) in ranges.enumerated() {
+            let low = Array(range.low.utf8)
+            let high = Array(range.high.utf8)
+            guard low.count == high.count, low.count <= DigitPrefixTrie.maxIndexedLength,
+                low.allSatisfy(DigitPrefixTrie.isDigit), high.allSatisfy(DigitPrefixTrie.isDigit),
+                low.lexicographicallyPrecedes(high) || low == high
+            else {
+                unindexedRanges.append(index)
+                continue
+            }
+            insert(index, low: low, high: high, node: 0, depth: 0, boundedBelow: true, boundedAbove: true)
+        }
+        _ = collectBelow(node: 0)
+    }
+
+    // MARK: - Lookup
+
+    /// The ranges that contain the number made of the leading digits of `number`, compared at the
+    /// length of each range's bounds. A range only matches once `number` has at least as many
+    /// digits as its bounds, like `String.hasPrefix`.
+    @_spi(STP) public func ranges(containing number: String) -> [Int] {
+        var result: [Int] = []
+        forEachNode(along: number) { node in
+            result.append(contentsOf: covering[node])
+        }
+        return DigitPrefixTrie.sortedUnique(result)
+    }
+
+    /// The ranges that `number` could still fall into: the ones that contain it like
+    /// `ranges(containing:)`, plus the ones that contain a longer number starting with it.
+    ///
+    /// `number` should only contain digits. A non-digit ends the lookup the same way as a digit that
+    /// no range continues with.
+    @_spi(STP) public func ranges(consistentWith number: String) -> [Int] {
+        var result: [Int] = []
+        var node = 0
+        var reachedEnd = true
+        var index = number.utf8.startIndex
+        let utf8 = number.utf8
+        while index != utf8.endIndex {
+            let byte = utf8[index]
+            result.append(contentsOf: covering[node])
+            guard DigitPrefixTrie.isDigit(byte) else {
+                reachedEnd = false
+                break
+            }
+            let child = Int(children[node * DigitPrefixTrie.radix + Int(byte - 0x30)])
+            guard child != 0 else {
+                reachedEnd = false
+                break
+            }
+            node = child
+            utf8.formIndex(after: &index)
+        }
+        if reachedEnd {
+            result.append(contentsOf: below[node])
+        }
+        return DigitPrefixTrie.sortedUnique(result)
+    }
+
+    private func forEachNode(along number: String, _ body: (Int) -> Void) {
+        var node = 0
+        body(node)
+        for byte in number.utf8 {
+            guard DigitPrefixTrie.isDigit(byte) else { return }
+            let child = Int(children[node * DigitPrefixTrie.radix + Int(byte - 0x30)])
+            guard child != 0 else { return }
+            node = child
+            body(node)
+        }
+    }
+
+    // MARK: - Building
+
+    private mutating func addNode() {
+        children.append(contentsOf: repeatElement(0, count: DigitPrefixTrie.radix))
+        covering.append([])
+        below.append([])
+    }
+
+    private mutating func child(of node: Int, digit: Int) -> Int {
+        let slot = node * DigitPrefixTrie.radix + digit
+        if children[slot] == 0 {
+            children[slot] = Int32(covering.count)
+            addNode()
+        }
+        return Int(children[slot])
+    }
+
+    /// Splits `low...high` at `depth` into the children it partially covers and the ones it covers
+    /// completely, which get marked without going any deeper
+    private mutating func insert(
+        _ index: Int,
+        low: [UInt8],
+        high: [UInt8],
+        node: Int,
+        depth: Int,
+        boundedBelow: Bool,
+        boundedAbove: Bool
+    ) {
+        let coversBelow = !boundedBelow || low[depth...].allSatisfy { $0 == 0x30 }
+        let coversAbove = !boundedAbove || high[depth...].allSatisfy { $0 == 0x39 }
+        if coversBelow && coversAbove {
+            covering[node].append(index)
+            return
+        }
+
+        let first = boundedBelow ? Int(low[depth] - 0x30) : 0
+        let last = boundedAbove ? Int(high[depth] - 0x30) : DigitPrefixTrie.radix - 1
+        guard first <= last else { return }
+        for digit in first...last {
+            let child = self.child(of: node, digit: digit)
+            insert(
+                index,
+                low: low,
+                high: high,
+                node: child,
+                depth: depth + 1,
+                boundedBelow: boundedBelow && digit == first,
+                boundedAbove: boundedAbove && digit == last
+            )
+        }
+    }
+
+    private mutating func collectBelow(node: Int) -> [Int] {
+        var result = covering[node]
+        for digit in 0..<DigitPrefixTrie.radix {
+            let child = Int(children[node * DigitPrefixTrie.radix + digit])
+            if child != 0 {
+                result.append(contentsOf: collectBelow(node: child))
+            }
+        }
+        result = DigitPrefixTrie.sortedUnique(result)
+        below[node] = result
+        return result
+    }
+
+    // MARK: - Helpers
+
+    private static func isDigit(_ byte: UInt8) -> Bool {
+        return byte >= 0x30 && byte <= 0x39
+    }
+
+    private static func sortedUnique(_ indices: [Int]) -> [Int] {
+        guard indices.count > 1 else { return indices }
+        var result: [Int] = []
+        result.reserveCapacity(indices.count)
+        for index in indices.sorted() where result.last != index {
+            result.append(index)
+        }
+        return result
+    }
+}
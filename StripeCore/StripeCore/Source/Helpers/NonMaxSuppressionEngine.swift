@@ -0,0 +1,367 @@
+//
+//  NonMaxSuppressionEngine.swift
+//  StripeCore
+//
+//  Created by Stripe on 10/17/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+import Accelerate
+import CoreGraphics
+import Foundation
+
+/// Reusable non-maximum suppression over flat corner form boxes.
+///
+/// Candidates are appended into column buffers (`xMin`, `yMin`, `xMax`, `yMax`, `scores`) with
+/// their areas precomputed. `hardNMS` then sorts a single index permutation by score, walks it
+/// once, and marks overlapping candidates in a suppression bitmask rather than removing them from
+/// an array. Buffers keep their capacity across `removeAll()` calls, so an engine owned by a
+/// detector doesn't allocate once it has seen its largest frame.
+///
+/// `softNMS` works on the same candidates, decaying scores in place instead of suppressing.
+///
+/// Instances are not thread safe, callers should use one engine per queue.
+@_spi(STP) public final class NonMaxSuppressionEngine {
+    /// How `softNMS` decays the scores of candidates that overlap a selected box.
+    @_spi(STP) public enum SoftNMSDecay {
+        /// `score * exp(-(iou * iou) / sigma)`
+        case gaussian(sigma: Float)
+        /// `score * (1 - iou)` for candidates that overlap by more than `iouThreshold`
+        case linear(iouThreshold: Float)
+    }
+
+    @_spi(STP) public private(set) var xMin: [Float] = []
+    @_spi(STP) public private(set) var yMin: [Float] = []
+    @_spi(STP) public private(set) var xMax: [Float] = []
+    @_spi(STP) public private(set) var yMax: [Float] = []
+    @_spi(STP) public private(set) var areas: [Float] = []
+    @_spi(STP) public private(set) var scores: [Float] = []
+
+    /// Indices of the candidates selected by the last call to `hardNMS` or `softNMS`, in the
+    /// order they were selected
+    @_spi(STP) public private(set) var selected: [Int] = []
+    /// The score of each selected candidate at the time it was selected by `softNMS`
+    @_spi(STP) public private(set) var selectedScores: [Float] = []
+
+    private var order: [Int] = []
+    private var suppressed: [UInt64] = []
+
+    // Soft-NMS working set. Positions `0..<liveCount` hold the candidates that are still live, in
+    // their original relative order, and are compacted in place after every selection.
+    private var liveIndices: [Int] = []
+    private var liveScores: [Float] = []
+    private var liveMinX: [Double] = []
+    private var liveMinY: [Double] = []
+    private var liveMaxX: [Double] = []
+    private var liveMaxY: [Double] = []
+    private var liveAreas: [Double] = []
+    private var scratchLow: [Double] = []
+    private var scratchHigh: [Double] = []
+    private var scratchDelta: [Double] = []
+    private var overlapWidth: [Double] = []
+    private var overlapHeight: [Double] = []
+    private var overlapArea: [Double] = []
+    private var unionArea: [Double] = []
+    private var liveIous: [Float] = []
+
+    @_spi(STP) public var count: Int {
+        return scores.count
+    }
+
+    @_spi(STP) public init(
+        capacity: Int = 0
+    ) {
+        reserveCapacity(capacity)
+    }
+
+    @_spi(STP) public func reserveCapacity(_ capacity: Int) {
+        xMin.reserveCapacity(capacity)
+        yMin.reserveCapacity(capacity)
+        xMax.reserveCapacity(capacity)
+        yMax.reserveCapacity(capacity)
+        areas.reserveCapacity(capacity)
+        scores.reserveCapacity(capacity)
+        order.reserveCapacity(capacity)
+        suppressed.reserveCapacity((capacity + 63) / 64)
+    }
+
+    /// Clears all candidates while keeping the allocated capacity.
+    @_spi(STP) public func removeAll() {
+        xMin.removeAll(keepingCapacity: true)
+        yMin.removeAll(keepingCapacity: true)
+        xMax.removeAll(keepingCapacity: true)
+        yMax.removeAll(keepingCapacity: true)
+        areas.removeAll(keepingCapacity: true)
+        scores.removeAll(keepingCapacity: true)
+        selected.removeAll(keepingCapacity: true)
+        selectedScores.removeAll(keepingCapacity: true)
+    }
+
+    /// Adds a candidate box in corner form.
+    @_spi(STP) public func append(
+        xMin: Float,
+        yMin: Float,
+        xMax: Float,
+        yMax: Float,
+        score: Float
+    ) {
+        let width = xMax - xMin
+        let height = yMax - yMin
+
+        self.xMin.append(xMin)
+        self.yMin.append(yMin)
+        self.xMax.append(xMax)
+        self.yMax.append(yMax)
+        self.areas.append(width > 0 && height > 0 ? width * height : 0)
+        self.scores.append(score)
+    }
+
+    /// Adds a candidate box.
+    @_spi(STP) public func append(rect: CGRect, score: Float) {
+        append(
+            xMin: Float(rect.minX),
+            yMin: Float(rect.minY),
+            xMax: Float(rect.maxX),
+            yMax: Float(rect.maxY),
+            score: score
+        )
+    }
+
+    /// Intersection over union of two candidates, or 0 if either has no area.
+    @_spi(STP) public func iou(_ a: Int, _ b: Int) -> Float {
+        let areaA = areas[a]
+        let areaB = areas[b]
+        if areaA <= 0 || areaB <= 0 {
+            return 0
+        }
+
+        let intersectionWidth = min(xMax[a], xMax[b]) - max(xMin[a], xMin[b])
+        let intersectionHeight = min(yMax[a], yMax[b]) - max(yMin[a], yMin[b])
+        if intersectionWidth <= 0 || intersectionHeight <= 0 {
+            return 0
+        }
+
+        let intersectionArea = intersectionWidth * intersectionHeight
+        return intersectionArea / (areaA + areaB - intersectionArea)
+    }
+
+    /// Greedy hard non-maximum suppression.
+    ///
+    /// - Parameters:
+    ///   - iouThreshold: Candidates that overlap a selected box by more than this are suppressed.
+    ///   - suppressesEqualOverlap: Whether an overlap exactly equal to `iouThreshold` also
+    ///     suppresses a candidate.
+    ///   - maxCandidates: Only consider this many of the highest scoring candidates. If
+    ///     `maxCandidates <= 0`, consider all of them.
+    ///   - maxOutputs: Stop once this many boxes are selected. If `maxOutputs <= 0`, keep all of
+    ///     the results.
+    ///
+    /// - Returns: Indices of the selected candidates in descending score order. Ties are broken
+    ///   by insertion order.
+    @discardableResult
+    @_spi(STP) public func hardNMS(
+        iouThreshold: Float,
+        suppressesEqualOverlap: Bool = false,
+        maxCandidates: Int = 0,
+        maxOutputs: Int
+    ) -> [Int] {
+        selected.removeAll(keepingCapacity: true)
+        selectedScores.removeAll(keepingCapacity: true)
+        sortByScore()
+
+        let numCandidates = maxCandidates > 0 ? min(maxCandidates, count) : count
+        suppressed.removeAll(keepingCapacity: true)
+        suppressed.append(contentsOf: repeatElement(0, count: (count + 63) / 64))
+
+        for i in 0..<numCandidates {
+            let current = order[i]
+            if isSuppressed(current) {
+                continue
+            }
+
+            selected.append(current)
+            if maxOutputs > 0 && selected.count == maxOutputs {
+                break
+            }
+
+            for j in (i + 1)..<numCandidates {
+                let next = order[j]
+                if isSuppressed(next) {
+                    continue
+                }
+                let overlap = iou(current, next)
+                if overlap > iouThreshold || (suppressesEqualOverlap && overlap == iouThreshold) {
+                    suppressed[next >> 6] |= 1 << UInt64(next & 63)
+                }
+            }
+        }
+
+        return selected
+    }
+
+    /// Soft non-maximum suppression.
+    ///
+    /// Repeatedly selects the highest scoring live candidate, decays the scores of the remaining
+    /// candidates by their overlap with it, and drops any whose score falls to `scoreThreshold` or
+    /// below. The live set is compacted in place while preserving order, so ties resolve to the
+    /// earliest candidate exactly as removing from an array would.
+    ///
+    /// Overlaps are computed in `Double` from `CGRect`-equivalent boxes, and decay uses the scalar
+    /// `exp`, so results are bit for bit identical to running the same algorithm over `CGRect.iou`.
+    ///
+    /// - Parameters:
+    ///   - decay: How to decay overlapping scores.
+    ///   - scoreThreshold: Candidates must score above this to stay live.
+    ///   - maxOutputs: Stop once this many boxes are selected. If `maxOutputs <= 0`, keep all of
+    ///     the results.
+    ///
+    /// - Returns: Indices of the selected candidates in selection order. The decayed score of each
+    ///   one is in `selectedScores`.
+    @discardableResult
+    @_spi(STP) public func softNMS(
+        decay: SoftNMSDecay,
+        scoreThreshold: Float,
+        maxOutputs: Int
+    ) -> [Int] {
+        selected.removeAll(keepingCapacity: true)
+        selectedScores.removeAll(keepingCapacity: true)
+        prepareLiveSet()
+
+        var liveCount = count
+        while liveCount > 0 {
+            var maxScore: Float = 0.0
+            var maxPosition: vDSP_Length = 0
+            vDSP_maxvi(liveScores, 1, &maxScore, &maxPosition, vDSP_Length(liveCount))
+            let current = Int(maxPosition)
+
+            selected.append(liveIndices[current])
+            selectedScores.append(maxScore)
+
+            if liveCount == 1 || (maxOutputs > 0 && selected.count == maxOutputs) {
+                break
+            }
+
+            computeLiveIous(against: current, liveCount: liveCount)
+
+            var writePosition = 0
+            for readPosition in 0..<liveCount where readPosition != current {
+                let iou = liveIous[readPosition]
+                var score = liveScores[readPosition]
+                switch decay {
+                case .gaussian(let sigma):
+                    score = score * exp(-(iou * iou) / sigma)
+                case .linear(let iouThreshold):
+                    if iou > iouThreshold {
+                        score = score * (1 - iou)
+                    }
+                }
+
+                guard score > scoreThreshold else {
+                    continue
+                }
+                liveScores[writePosition] = score
+                if writePosition != readPosition {
+                    liveIndices[writePosition] = liveIndices[readPosition]
+                    liveMinX[writePosition] = liveMinX[readPosition]
+                    liveMinY[writePosition] = liveMinY[readPosition]
+                    liveMaxX[writePosition] = liveMaxX[readPosition]
+                    liveMaxY[writePosition] = liveMaxY[readPosition]
+                    liveAreas[writePosition] = liveAreas[readPosition]
+                }
+                writePosition += 1
+            }
+            liveCount = writePosition
+        }
+
+        return selected
+    }
+
+    /// Copies every candidate into the soft-NMS working set, resizing it only if it has grown.
+    private func prepareLiveSet() {
+        if liveIndices.count < count {
+            liveIndices = [Int](repeating: 0, count: count)
+            liveScores = [Float](repeating: 0, count: count)
+            liveMinX = [Double](repeating: 0, count: count)
+            liveMinY = [Double](repeating: 0, count: count)
+            liveMaxX = [Double](repeating: 0, count: count)
+            liveMaxY = [Double](repeating: 0, count: count)
+            liveAreas = [Double](repeating: 0, count: count)
+            scratchLow = [Double](repeating: 0, count: count)
+            scratchHigh = [Double](repeating: 0, count: count)
+            scratchDelta = [Double](repeating: 0, count: count)
+            overlapWidth = [Double](repeating: 0, count: count)
+            overlapHeight = [Double](repeating: 0, count: count)
+            overlapArea = [Double](repeating: 0, count: count)
+            unionArea = [Double](repeating: 0, count: count)
+            liveIous = [Float](repeating: 0, count: count)
+        }
+
+        for index in 0..<count {
+            // Build the same rectangle that callers historically built so that overlaps match
+            let rect = CGRect(
+                x: Double(xMin[index]),
+                y: Double(yMin[index]),
+                width: Double(xMax[index] - xMin[index]),
+                height: Double(yMax[index] - yMin[index])
+            )
+            liveIndices[index] = index
+            liveScores[index] = scores[index]
+            liveMinX[index] = Double(rect.minX)
+            liveMinY[index] = Double(rect.minY)
+            liveMaxX[index] = Double(rect.maxX)
+            liveMaxY[index] = Double(rect.maxY)
+            liveAreas[index] = Double(rect.width * rect.height)
+        }
+    }
+
+    /// Fills `liveIous` with the overlap of every live candidate with the one at `position`.
+    private func computeLiveIous(against position: Int, liveCount: Int) {
+        let length = vDSP_Length(liveCount)
+        var currentArea = liveAreas[position]
+        guard currentArea > 0 else {
+            var zero: Float = 0
+            vDSP_vfill(&zero, &liveIous, 1, length)
+            return
+        }
+
+        var currentMinX = liveMinX[position]
+        var currentMinY = liveMinY[position]
+        var currentMaxX = liveMaxX[position]
+        var currentMaxY = liveMaxY[position]
+        var lowest = -Double.greatestFiniteMagnitude
+        var zero = 0.0
+
+        // overlap = max(min(maxes) - max(mins), 0)
+        vDSP_vthrD(liveMinX, 1, &currentMinX, &scratchLow, 1, length)
+        vDSP_vclipD(liveMaxX, 1, &lowest, &currentMaxX, &scratchHigh, 1, length)
+        vDSP_vsubD(scratchLow, 1, scratchHigh, 1, &scratchDelta, 1, length)
+        vDSP_vthrD(scratchDelta, 1, &zero, &overlapWidth, 1, length)
+
+        vDSP_vthrD(liveMinY, 1, &currentMinY, &scratchLow, 1, length)
+        vDSP_vclipD(liveMaxY, 1, &lowest, &currentMaxY, &scratchHigh, 1, length)
+        vDSP_vsubD(scratchLow, 1, scratchHigh, 1, &scratchDelta, 1, length)
+        vDSP_vthrD(scratchDelta, 1, &zero, &overlapHeight, 1, length)
+
+        // iou = overlap / (currentArea + area - overlap)
+        vDSP_vmulD(overlapHeight, 1, overlapWidth, 1, &overlapArea, 1, length)
+        vDSP_vsaddD(liveAreas, 1, &currentArea, &scratchLow, 1, length)
+        vDSP_vsubD(overlapArea, 1, scratchLow, 1, &unionArea, 1, length)
+        vDSP_vdivD(unionArea, 1, overlapArea, 1, &scratchDelta, 1, length)
+        vDSP_vdpsp(scratchDelta, 1, &liveIous, 1, length)
+    }
+
+    /// Sorts `order` into descending score order, breaking ties by insertion order.
+    private func sortByScore() {
+        order.removeAll(keepingCapacity: true)
+        order.append(contentsOf: 0..<count)
+        scores.withUnsafeBufferPointer { scores in
+            order.sort { a, b in
+                scores[a] > scores[b] || (scores[a] == scores[b] && a < b)
+            }
+        }
+    }
+
+    private func isSuppressed(_ index: Int) -> Bool {
+        return suppressed[index >> 6] & (1 << UInt64(index & 63)) != 0
+    }
+}
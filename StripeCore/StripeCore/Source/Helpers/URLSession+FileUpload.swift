@@ -0,0 +1,141 @@
+//
+//  URLSession+FileUpload.swift
+//  StripeCore
+//
+//  Created by Stripe on 10/17/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+import Foundation
+
+extension URLSession {
+    /// Uploads the file at `fileURL` as the body of `request`.
+    ///
+    /// Like `stp_performDataTask`, rate limited requests are retried with backoff. So are uploads that
+    /// fail with a transient network error, e.g. when the connection drops. Those resume where they
+    /// left off if the system gave us resume data for them, and otherwise start over from the file.
+    ///
+    /// A connection can drop after the server got the whole request, so the request is sent with an
+    /// `Idempotency-Key` header that stays the same across retries, unless it already has one. That
+    /// way a retry gets the response to the first request, rather than uploading the file twice.
+    ///
+    /// - Parameter progressHandler: Called on the main queue with the fraction of the body sent so
+    ///   far. It goes back to zero when an upload starts over.
+    @_spi(STP) public func stp_performUploadTask(
+        with request: URLRequest,
+        fromFile fileURL: URL,
+        progressHandler: ((Double) -> Void)? = nil,
+        completionHandler: @escaping (Data?, URLResponse?, Error?) -> Void
+    ) {
+        var request = request
+        if request.value(forHTTPHeaderField: URLSession.idempotencyKeyHeader) == nil {
+            request.setValue(UUID().uuidString, forHTTPHeaderField: URLSession.idempotencyKeyHeader)
+        }
+
+        stp_performUploadTask(
+            with: request,
+            fromFile: fileURL,
+            resumeData: nil,
+            progressDelegate: progressHandler.map { UploadProgressDelegate(progressHandler: $0) },
+            completionHandler: completionHandler,
+            retryCount: StripeAPI.maxRetries
+        )
+    }
+
+    private func stp_performUploadTask(
+        with request: URLRequest,
+        fromFile fileURL: URL,
+        resumeData: Data?,
+        progressDelegate: UploadProgressDelegate?,
+        completionHandler: @escaping (Data?, URLResponse?, Error?) -> Void,
+        retryCount: Int
+    ) {
+        let taskCompletionHandler: (Data?, URLResponse?, Error?) -> Void = { data, response, error in
+            guard retryCount > 0, URLSession.stp_isTransientUploadFailure(response: response, error: error)
+            else {
+                completionHandler(data, response, error)
+                return
+            }
+
+            var resumeData: Data?
+            if #available(iOS 17.0, *) {
+                resumeData = (error as? URLError)?.uploadTaskResumeData
+            }
+
+            // Same backoff as `stp_performDataTask`
+            let delayTime = TimeInterval(
+                pow(Double(1 + StripeAPI.maxRetries - retryCount), Double(2))
+                    + .random(in: 0..<0.5)
+            )
+            let fireDate = Date() + delayTime
+            self.delegateQueue.schedule(after: .init(fireDate)) {
+                self.stp_performUploadTask(
+                    with: request,
+                    fromFile: fileURL,
+                    resumeData: resumeData,
+                    progressDelegate: progressDelegate,
+                    completionHandler: completionHandler,
+                    retryCount: retryCount - 1
+                )
+            }
+        }
+
+        let task: URLSessionUploadTask
+        if #available(iOS 17.0, *), let resumeData = resumeData {
+            task = uploadTask(withResumeData: resumeData, completionHandler: taskCompletionHandler)
+        } else {
+            task = uploadTask(with: request, fromFile: fileURL, completionHandler: taskCompletionHandler)
+        }
+        task.delegate = progressDelegate
+        task.resume()
+    }
+
+    static let idempotencyKeyHeader = "Idempotency-Key"
+
+    static func stp_isTransientUploadFailure(response: URLResponse?, error: Error?) -> Bool {
+        if let httpResponse = response as? HTTPURLResponse, httpResponse.statusCode == 429 {
+            return true
+        }
+        guard let urlError = error as? URLError else {
+            return false
+        }
+        switch urlError.code {
+        case .networkConnectionLost,
+            .notConnectedToInternet,
+            .timedOut,
+            .cannotConnectToHost,
+            .cannotFindHost,
+            .dnsLookupFailed:
+            return true
+        default:
+            return false
+        }
+    }
+}
+
+/// Forwards an upload task's progress to a handler on the main queue
+private final class UploadProgressDelegate: NSObject, URLSessionTaskDelegate {
+    let progressHandler: (Double) -> Void
+
+    init(
+        progressHandler: @escaping (Double) -> Void
+    ) {
+        self.progressHandler = progressHandler
+    }
+
+    func urlSession(
+        _ session: URLSession,
+        task: URLSessionTask,
+        didSendBodyData bytesSent: Int64,
+        totalBytesSent: Int64,
+        totalBytesExpectedToSend: Int64
+    ) {
+        guard totalBytesExpectedToSend > 0 else {
+            return
+        }
+        let fractionCompleted = Double(totalBytesSent) / Double(totalBytesExpectedToSend)
+        DispatchQueue.main.async {
+            self.progressHandler(fractionCompleted)
+        }
+    }
+}
@@ -0,0 +1,94 @@
+//
+//  STPAPIClient+FileUploadTest.swift
+//  StripeCoreTests
+//
+//  Created by Stripe on 10/17/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+import OHHTTPStubs
+import OHHTTPStubsSwift
+@_spi(STP)@testable import StripeCore
+import StripeCoreTestUtils
+import UIKit
+import XCTest
+
+class STPAPIClient_FileUploadTest: APIStubbedTestCase {
+    let image = UIImage.mockIcon()
+
+    func testStreamedUploadSendsMultipartHeaders() throws {
+        let responseData = try FileMock.identityDocument.data()
+        stub { urlRequest in
+            guard urlRequest.url?.host == "uploads.stripe.com" else { return false }
+            XCTAssertEqual(urlRequest.httpMethod, "POST")
+            XCTAssertTrue(
+                urlRequest.value(forHTTPHeaderField: "Content-Type")?.hasPrefix("multipart/form-data; boundary=")
+                    ?? false
+            )
+            XCTAssertGreaterThan(Int(urlRequest.value(forHTTPHeaderField: "Content-Length") ?? "") ?? 0, 0)
+            return true
+        } response: { _ in
+            return HTTPStubsResponse(data: responseData, statusCode: 200, headers: nil)
+        }
+
+        let result = upload()
+
+        let file = try XCTUnwrap(try result?.get().file)
+        XCTAssertEqual(file.id, "file_id")
+        XCTAssertGreaterThan(try XCTUnwrap(try result?.get().metrics.fileSizeBytes), 0)
+        XCTAssertEqual(temporaryUploadFiles(), [])
+    }
+
+    func testStreamedUploadRetriesAfterConnectionLoss() throws {
+        let responseData = try FileMock.identityDocument.data()
+        var idempotencyKeys: [String?] = []
+        stub { urlRequest in
+            return urlRequest.url?.host == "uploads.stripe.com"
+        } response: { urlRequest in
+            idempotencyKeys.append(urlRequest.value(forHTTPHeaderField: "Idempotency-Key"))
+            if idempotencyKeys.count == 1 {
+                return HTTPStubsResponse(error: URLError(.networkConnectionLost))
+            }
+            return HTTPStubsResponse(data: responseData, statusCode: 200, headers: nil)
+        }
+
+        let result = upload(timeout: 5)
+
+        XCTAssertEqual(try result?.get().file.id, "file_id")
+        XCTAssertEqual(idempotencyKeys.count, 2)
+        // the retry can't create a second file if the server got the first request
+        XCTAssertNotNil(idempotencyKeys.first ?? nil)
+        XCTAssertEqual(idempotencyKeys.first, idempotencyKeys.last)
+        XCTAssertEqual(temporaryUploadFiles(), [])
+    }
+
+    func testOnlyTransientFailuresAreRetried() {
+        XCTAssertTrue(URLSession.stp_isTransientUploadFailure(response: nil, error: URLError(.timedOut)))
+        XCTAssertFalse(URLSession.stp_isTransientUploadFailure(response: nil, error: URLError(.cancelled)))
+        XCTAssertFalse(URLSession.stp_isTransientUploadFailure(response: nil, error: nil))
+    }
+
+    // MARK: - Helpers
+
+    func upload(timeout: TimeInterval = 2) -> Result<STPAPIClient.FileAndUploadMetrics, Error>? {
+        let exp = expectation(description: "upload")
+        var result: Result<STPAPIClient.FileAndUploadMetrics, Error>?
+        stubbedAPIClient().uploadImageAndGetMetrics(
+            image,
+            purpose: StripeFile.Purpose.identityDocument.rawValue,
+            uploadMode: .streamedFromFile
+        ) {
+            result = $0
+            exp.fulfill()
+        }
+        wait(for: [exp], timeout: timeout)
+        return result
+    }
+
+    func temporaryUploadFiles() -> [String] {
+        let contents =
+            (try? FileManager.default.contentsOfDirectory(atPath: FileManager.default.temporaryDirectory.path))
+            ?? []
+        return contents.filter { $0.hasPrefix("stripe-upload-") }
+    }
+}
@@ -0,0 +1,72 @@
+//
+//  STPMultipartFormDataEncoderTest.swift
+//  StripeCoreTests
+//
+//  Created by Stripe on 10/17/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+@_spi(STP) import StripeCore
+import XCTest
+
+class STPMultipartFormDataEncoderTest: XCTestCase {
+    func testMultipartFormData() {
+        let body = STPMultipartFormDataEncoder.multipartFormData(for: parts(), boundary: "boundary")
+
+        var expected = Data(
+            ("--boundary\r\n"
+                + "Content-Disposition: form-data; name=\"purpose\"\r\n"
+                + "\r\n"
+                + "identity_document\r\n"
+                + "--boundary\r\n"
+                + "Content-Disposition: form-data; name=\"file\"; filename=\"image.jpg\"\r\n"
+                + "Content-Type: image/jpeg\r\n"
+                + "\r\n").utf8
+        )
+        expected.append(contentsOf: [0xFF, 0xD8])
+        expected.append(contentsOf: "\r\n--boundary--\r\n".utf8)
+
+        XCTAssertEqual(body, expected)
+    }
+
+    func testAppendingPartsOneAtATimeMatchesEncodingThemTogether() {
+        var body = Data()
+        for part in parts() {
+            STPMultipartFormDataEncoder.append(part, to: &body, boundary: "boundary")
+        }
+        STPMultipartFormDataEncoder.appendClosingBoundary(to: &body, boundary: "boundary")
+
+        XCTAssertEqual(body, STPMultipartFormDataEncoder.multipartFormData(for: parts(), boundary: "boundary"))
+    }
+
+    func testWritingToFileMatchesInMemoryBody() throws {
+        let fileURL = FileManager.default.temporaryDirectory.appendingPathComponent(UUID().uuidString)
+        defer { try? FileManager.default.removeItem(at: fileURL) }
+
+        let byteCount = try STPMultipartFormDataEncoder.writeMultipartFormData(
+            for: parts(),
+            boundary: "boundary",
+            to: fileURL
+        )
+
+        let expected = STPMultipartFormDataEncoder.multipartFormData(for: parts(), boundary: "boundary")
+        XCTAssertEqual(try Data(contentsOf: fileURL), expected)
+        XCTAssertEqual(byteCount, expected.count)
+    }
+
+    // MARK: - Helpers
+
+    func parts() -> [STPMultipartFormDataPart] {
+        let purposePart = STPMultipartFormDataPart()
+        purposePart.name = "purpose"
+        purposePart.data = Data("identity_document".utf8)
+
+        let imagePart = STPMultipartFormDataPart()
+        imagePart.name = "file"
+        imagePart.filename = "image.jpg"
+        imagePart.contentType = "image/jpeg"
+        imagePart.data = Data([0xFF, 0xD8])
+
+        return [purposePart, imagePart]
+    }
+}
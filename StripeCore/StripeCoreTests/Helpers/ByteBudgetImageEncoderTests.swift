@@ -0,0 +1,127 @@
+//
+//  ByteBudgetImageEncoderTests.swift
+//  StripeCoreTests
+//
+//  Created by Stripe on 10/17/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+import CoreGraphics
+import UIKit
+import XCTest
+
+@_spi(STP) @testable import StripeCore
+
+class ByteBudgetImageEncoderTests: XCTestCase {
+    let photo = ByteBudgetImageEncoderTests.makeImage(width: 2400, height: 1600)
+
+    func testFitsBudgetInFewEncodes() throws {
+        let maxBytes = 200_000
+        let encoder = ByteBudgetImageEncoder(cgImage: photo, format: .jpeg)
+
+        let (data, pixelSize) = try XCTUnwrap(encoder.encode(maxBytes: maxBytes, compressionQuality: 0.5))
+
+        XCTAssertLessThanOrEqual(data.count, maxBytes)
+        // doesn't shrink the image much more than it has to
+        XCTAssertGreaterThan(data.count, maxBytes / 2)
+        XCTAssertLessThan(pixelSize.width, 2400)
+        XCTAssertEqual(pixelSize.width / pixelSize.height, 1.5, accuracy: 0.01)
+        // the full size encode that missed, two trials, maybe one lower quality trial, and one or two
+        // scaled encodes
+        XCTAssertLessThanOrEqual(encoder.encodeCount, 6)
+    }
+
+    func testKeepsFullSizeWhenItFits() throws {
+        let encoder = ByteBudgetImageEncoder(cgImage: photo, format: .jpeg)
+
+        let (data, pixelSize) = try XCTUnwrap(encoder.encode(maxBytes: 50_000_000, compressionQuality: 0.5))
+
+        XCTAssertEqual(pixelSize, CGSize(width: 2400, height: 1600))
+        XCTAssertNotNil(UIImage(data: data))
+        XCTAssertEqual(encoder.encodeCount, 1)
+    }
+
+    func testKeepsFullSizeWhenItFitsWithinBudgetMargin() throws {
+        let fullSizeBytes = try XCTUnwrap(
+            ByteBudgetImageEncoder(cgImage: photo, format: .jpeg).encode(
+                maxBytes: .max,
+                compressionQuality: 0.5
+            )
+        ).data.count
+        let encoder = ByteBudgetImageEncoder(cgImage: photo, format: .jpeg)
+
+        // fits, but only without the margin the encoder leaves when it scales down
+        let maxBytes = Int(Double(fullSizeBytes) / 0.96)
+        let (data, pixelSize) = try XCTUnwrap(encoder.encode(maxBytes: maxBytes, compressionQuality: 0.5))
+
+        XCTAssertEqual(pixelSize, CGSize(width: 2400, height: 1600))
+        XCTAssertEqual(data.count, fullSizeBytes)
+        XCTAssertEqual(encoder.encodeCount, 1)
+    }
+
+    func testSmallImageIsEncodedOnce() throws {
+        let image = ByteBudgetImageEncoderTests.makeImage(width: 200, height: 100)
+        let encoder = ByteBudgetImageEncoder(cgImage: image, format: .jpeg)
+
+        let (_, pixelSize) = try XCTUnwrap(encoder.encode(maxBytes: 1_000_000, compressionQuality: 0.5))
+
+        XCTAssertEqual(pixelSize, CGSize(width: 200, height: 100))
+        XCTAssertEqual(encoder.encodeCount, 1)
+    }
+
+    func testWritesOrientation() throws {
+        let encoder = ByteBudgetImageEncoder(cgImage: photo, orientation: .right, format: .jpeg)
+        let (data, _) = try XCTUnwrap(encoder.encode(maxBytes: 200_000, compressionQuality: 0.5))
+
+        let image = try XCTUnwrap(UIImage(data: data))
+        XCTAssertEqual(image.imageOrientation, .right)
+        XCTAssertGreaterThan(image.size.height, image.size.width)
+    }
+
+    func testSizeModelFitsPowerLaw() {
+        var model = ByteBudgetImageEncoder.SizeModel()
+        model.add(pixels: 10_000, bytes: 1_000)
+        model.add(pixels: 40_000, bytes: 3_000)
+
+        XCTAssertEqual(model.exponent, log(3.0) / log(4.0), accuracy: 0.0001)
+        XCTAssertEqual(model.bytes(pixels: 40_000), 3_000, accuracy: 0.01)
+        XCTAssertEqual(model.scale(fitting: 3_000, pixels: 160_000), 0.5, accuracy: 0.0001)
+    }
+
+    func testEncodePerformance() {
+        measure {
+            _ = ByteBudgetImageEncoder(cgImage: photo, format: .jpeg).encode(
+                maxBytes: 200_000,
+                compressionQuality: 0.5
+            )
+        }
+    }
+
+    // MARK: - Helpers
+
+    /// Smooth gradients with some noise, so that it compresses roughly like a photo
+    static func makeImage(width: Int, height: Int) -> CGImage {
+        let context = CGContext(
+            data: nil,
+            width: width,
+            height: height,
+            bitsPerComponent: 8,
+            bytesPerRow: width * 4,
+            space: CGColorSpaceCreateDeviceRGB(),
+            bitmapInfo: CGImageAlphaInfo.noneSkipLast.rawValue
+        )!
+        let pixels = context.data!.bindMemory(to: UInt8.self, capacity: width * height * 4)
+        var state: UInt32 = 12345
+        for y in 0..<height {
+            for x in 0..<width {
+                state = state &* 1_664_525 &+ 1_013_904_223
+                let noise = Int(state >> 28)
+                let offset = (y * width + x) * 4
+                pixels[offset] = UInt8((x * 255 / width + noise) & 0xFF)
+                pixels[offset + 1] = UInt8((y * 255 / height + noise) & 0xFF)
+                pixels[offset + 2] = UInt8(((x + y) % 256 + noise) & 0xFF)
+            }
+        }
+        return context.makeImage()!
+    }
+}
@@ -0,0 +1,83 @@
+//
+//  DigitPrefixTrieTests.swift
+//  StripeCoreTests
+//
+//  Created by Stripe on 10/17/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+import Foundation
+
+@_spi(STP) @testable import StripeCore
+import StripeCoreTestUtils
+import XCTest
+
+class DigitPrefixTrieTests: XCTestCase {
+
+    let ranges: [(low: String, high: String)] = [
+        ("", ""),
+        ("40", "49"),
+        ("450628", "450629"),
+        ("134", "167"),
+        ("2221", "2720"),
+        ("6244780000000000", "6244789999999999"),
+        ("35", "35"),
+        ("38", "39"),
+    ]
+
+    func testContainingMatchesHasPrefix() {
+        let prefixes = ["34", "37", "300", "36", "6011", "64", "4", "2221", "271", "62"]
+        let trie = DigitPrefixTrie(ranges: prefixes.map { (low: $0, high: $0) })
+
+        for number in ["", "3", "34", "378282246310005", "3000", "4242 4242", "6011000990139424", "2720", "62x"] {
+            let expected = prefixes.indices.filter { number.hasPrefix(prefixes[$0]) }
+            XCTAssertEqual(trie.ranges(containing: number), expected, number)
+        }
+    }
+
+    func testConsistentWithPartialNumbers() {
+        let trie = DigitPrefixTrie(ranges: ranges)
+
+        XCTAssertEqual(trie.ranges(consistentWith: ""), Array(ranges.indices))
+        XCTAssertEqual(trie.ranges(consistentWith: "4"), [0, 1, 2])
+        XCTAssertEqual(trie.ranges(consistentWith: "4506"), [0, 1, 2])
+        XCTAssertEqual(trie.ranges(consistentWith: "450630"), [0, 1])
+        XCTAssertEqual(trie.ranges(consistentWith: "1"), [0, 3])
+        XCTAssertEqual(trie.ranges(consistentWith: "168"), [0])
+        XCTAssertEqual(trie.ranges(consistentWith: "2"), [0, 4])
+        XCTAssertEqual(trie.ranges(consistentWith: "2799"), [0])
+        XCTAssertEqual(trie.ranges(consistentWith: "62447812"), [0, 5])
+        XCTAssertEqual(trie.ranges(consistentWith: "39"), [0, 7])
+    }
+
+    func testConsistentWithMatchesTruncatedComparison() {
+        let trie = DigitPrefixTrie(ranges: ranges)
+        var generator = SplitMix64(seed: 0x7B1E)
+
+        for _ in 0..<5_000 {
+            let length = Int.random(in: 0...17, using: &generator)
+            let number = String((0..<length).map { _ in "0123456789".randomElement(using: &generator)! })
+            let expected = ranges.indices.filter {
+                DigitPrefixTrieTests.matchesTruncated(number, low: ranges[$0].low, high: ranges[$0].high)
+            }
+            XCTAssertEqual(trie.ranges(consistentWith: number), expected, number)
+        }
+    }
+
+    func testUnindexedRanges() {
+        let trie = DigitPrefixTrie(ranges: [("4", "4"), ("1", "22"), ("9", "1"), ("4a", "4b"), ("42", "42")])
+
+        XCTAssertEqual(trie.unindexedRanges, [1, 2, 3])
+        XCTAssertEqual(trie.ranges(consistentWith: "4"), [0, 4])
+        XCTAssertEqual(trie.ranges(containing: "42"), [0, 4])
+    }
+
+    // MARK: - Helpers
+
+    /// Compares `number` and the bounds truncated to the shorter of the two, like `STPBINRange`
+    static func matchesTruncated(_ number: String, low: String, high: String) -> Bool {
+        let length = min(number.count, low.count)
+        let numberPrefix = number.prefix(length)
+        return numberPrefix >= low.prefix(length) && numberPrefix <= high.prefix(length)
+    }
+}
@@ -0,0 +1,221 @@
+//
+//  NonMaxSuppressionEngineTests.swift
+//  StripeCoreTests
+//
+//  Created by Stripe on 10/17/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+import CoreGraphics
+import Foundation
+
+@_spi(STP) @testable import StripeCore
+import StripeCoreTestUtils
+import XCTest
+
+class NonMaxSuppressionEngineTests: XCTestCase {
+
+    func testSuppressesOverlappingLowerScoringBoxes() {
+        let engine = NonMaxSuppressionEngine()
+        engine.append(xMin: 0, yMin: 0, xMax: 1, yMax: 1, score: 0.5)
+        engine.append(xMin: 0, yMin: 0, xMax: 1, yMax: 0.9, score: 0.9)
+        engine.append(xMin: 2, yMin: 2, xMax: 3, yMax: 3, score: 0.7)
+
+        XCTAssertEqual(engine.hardNMS(iouThreshold: 0.5, maxOutputs: 0), [1, 2])
+    }
+
+    func testStopsAtMaxOutputs() {
+        let engine = NonMaxSuppressionEngine()
+        for i in 0..<5 {
+            let x = Float(i) * 2
+            engine.append(xMin: x, yMin: 0, xMax: x + 1, yMax: 1, score: Float(i))
+        }
+
+        XCTAssertEqual(engine.hardNMS(iouThreshold: 0.5, maxOutputs: 2), [4, 3])
+    }
+
+    func testMaxCandidatesOnlyConsidersHighestScores() {
+        let engine = NonMaxSuppressionEngine()
+        for i in 0..<5 {
+            let x = Float(i) * 2
+            engine.append(xMin: x, yMin: 0, xMax: x + 1, yMax: 1, score: Float(i))
+        }
+
+        XCTAssertEqual(engine.hardNMS(iouThreshold: 0.5, maxCandidates: 3, maxOutputs: 0), [4, 3, 2])
+    }
+
+    func testEqualOverlap() {
+        let engine = NonMaxSuppressionEngine()
+        // The second box overlaps half of the first box's area, so IOU is exactly 0.5
+        engine.append(xMin: 0, yMin: 0, xMax: 2, yMax: 1, score: 0.9)
+        engine.append(xMin: 0, yMin: 0, xMax: 1, yMax: 1, score: 0.8)
+
+        XCTAssertEqual(engine.hardNMS(iouThreshold: 0.5, maxOutputs: 0), [0, 1])
+        XCTAssertEqual(
+            engine.hardNMS(iouThreshold: 0.5, suppressesEqualOverlap: true, maxOutputs: 0),
+            [0]
+        )
+    }
+
+    func testTiesKeepInsertionOrder() {
+        let engine = NonMaxSuppressionEngine()
+        engine.append(xMin: 0, yMin: 0, xMax: 1, yMax: 1, score: 0.5)
+        engine.append(xMin: 0, yMin: 0, xMax: 1, yMax: 1, score: 0.5)
+
+        XCTAssertEqual(engine.hardNMS(iouThreshold: 0.5, maxOutputs: 0), [0])
+    }
+
+    func testZeroAreaBoxesNeverSuppress() {
+        let engine = NonMaxSuppressionEngine()
+        engine.append(xMin: 0, yMin: 0, xMax: 0, yMax: 1, score: 0.9)
+        engine.append(xMin: 0, yMin: 0, xMax: 1, yMax: 1, score: 0.8)
+
+        XCTAssertEqual(engine.hardNMS(iouThreshold: 0.1, maxOutputs: 0), [0, 1])
+    }
+
+    func testMatchesReferenceImplementationOnRandomBoxes() {
+        var generator = SplitMix64(seed: 42)
+        let engine = NonMaxSuppressionEngine()
+
+        for _ in 0..<20 {
+            let boxes = randomBoxes(count: 300, using: &generator)
+            engine.removeAll()
+            for box in boxes {
+                engine.append(rect: box.rect, score: box.score)
+            }
+
+            XCTAssertEqual(
+                engine.hardNMS(iouThreshold: 0.45, maxOutputs: 20),
+                referenceNMS(boxes, iouThreshold: 0.45, maxOutputs: 20)
+            )
+        }
+    }
+
+    func testBuffersAreReusedAcrossFrames() {
+        var generator = SplitMix64(seed: 7)
+        let boxes = randomBoxes(count: 100, using: &generator)
+        let engine = NonMaxSuppressionEngine(capacity: 100)
+
+        var results: [[Int]] = []
+        for _ in 0..<2 {
+            engine.removeAll()
+            for box in boxes {
+                engine.append(rect: box.rect, score: box.score)
+            }
+            results.append(engine.hardNMS(iouThreshold: 0.5, maxOutputs: 0))
+        }
+        XCTAssertEqual(results[0], results[1])
+    }
+
+    func testSoftNMSLinearDecayKeepsDecayedOverlaps() {
+        let engine = NonMaxSuppressionEngine()
+        // IOU with the first box is 0.5, so the second box decays to 0.4
+        engine.append(xMin: 0, yMin: 0, xMax: 2, yMax: 1, score: 0.9)
+        engine.append(xMin: 0, yMin: 0, xMax: 1, yMax: 1, score: 0.8)
+        engine.append(xMin: 5, yMin: 5, xMax: 6, yMax: 6, score: 0.7)
+
+        XCTAssertEqual(
+            engine.softNMS(decay: .linear(iouThreshold: 0.3), scoreThreshold: 0.1, maxOutputs: 0),
+            [0, 2, 1]
+        )
+        XCTAssertEqual(engine.selectedScores, [0.9, 0.7, 0.4])
+
+        XCTAssertEqual(
+            engine.softNMS(decay: .linear(iouThreshold: 0.3), scoreThreshold: 0.5, maxOutputs: 0),
+            [0, 2]
+        )
+    }
+
+    func testSoftNMSGaussianDecayDropsDuplicates() {
+        let engine = NonMaxSuppressionEngine()
+        engine.append(xMin: 0, yMin: 0, xMax: 1, yMax: 1, score: 0.9)
+        engine.append(xMin: 0, yMin: 0, xMax: 1, yMax: 1, score: 0.6)
+        engine.append(xMin: 2, yMin: 2, xMax: 3, yMax: 3, score: 0.5)
+
+        // An identical box decays to 0.6 * exp(-1 / 0.5), well under the threshold
+        XCTAssertEqual(
+            engine.softNMS(decay: .gaussian(sigma: 0.5), scoreThreshold: 0.2, maxOutputs: 0),
+            [0, 2]
+        )
+    }
+
+    // MARK: - Benchmarks
+
+    func testPerformance10Candidates() {
+        measureHardNMS(candidateCount: 10)
+    }
+
+    func testPerformance100Candidates() {
+        measureHardNMS(candidateCount: 100)
+    }
+
+    func testPerformance1000Candidates() {
+        measureHardNMS(candidateCount: 1000)
+    }
+
+    func testPerformance3000Candidates() {
+        measureHardNMS(candidateCount: 3000)
+    }
+
+    // MARK: - Helpers
+
+    struct Box {
+        let rect: CGRect
+        let score: Float
+    }
+
+    func randomBoxes(count: Int, using generator: inout SplitMix64) -> [Box] {
+        return (0..<count).map { _ in
+            let x = CGFloat.random(in: 0..<0.9, using: &generator)
+            let y = CGFloat.random(in: 0..<0.9, using: &generator)
+            return Box(
+                rect: CGRect(
+                    x: x,
+                    y: y,
+                    width: CGFloat.random(in: 0.01..<0.1, using: &generator),
+                    height: CGFloat.random(in: 0.01..<0.1, using: &generator)
+                ),
+                score: Float.random(in: 0..<1, using: &generator)
+            )
+        }
+    }
+
+    /// Straightforward greedy NMS to compare the engine against
+    func referenceNMS(_ boxes: [Box], iouThreshold: Float, maxOutputs: Int) -> [Int] {
+        func iou(_ a: CGRect, _ b: CGRect) -> Float {
+            let intersection = a.intersection(b)
+            guard !intersection.isNull else { return 0 }
+            let intersectionArea = Float(intersection.width * intersection.height)
+            let union = Float(a.width * a.height) + Float(b.width * b.height) - intersectionArea
+            return intersectionArea / union
+        }
+
+        let sorted = boxes.indices.sorted {
+            boxes[$0].score > boxes[$1].score || (boxes[$0].score == boxes[$1].score && $0 < $1)
+        }
+        var selected: [Int] = []
+        for index in sorted {
+            if selected.count >= maxOutputs { break }
+            if selected.allSatisfy({ iou(boxes[$0].rect, boxes[index].rect) <= iouThreshold }) {
+                selected.append(index)
+            }
+        }
+        return selected
+    }
+
+    func measureHardNMS(candidateCount: Int) {
+        var generator = SplitMix64(seed: UInt64(candidateCount))
+        let boxes = randomBoxes(count: candidateCount, using: &generator)
+        let engine = NonMaxSuppressionEngine(capacity: candidateCount)
+
+        measure {
+            for _ in 0..<100 {
+                engine.removeAll()
+                for box in boxes {
+                    engine.append(rect: box.rect, score: box.score)
+                }
+                engine.hardNMS(iouThreshold: 0.5, maxOutputs: 20)
+            }
+        }
+    }
+}
@@ -118,7 +118,8 @@ final class IdentityAPIClientImpl: IdentityAPIClient {
             compressionQuality: compressionQuality,
             purpose: purpose,
             fileName: fileName,
-            ownedBy: verificationSessionId
+            ownedBy: verificationSessionId,
+            uploadMode: .streamedFromFile
         )
     }
 
@@ -11,6 +11,11 @@ import Foundation
 
 extension MLMultiArray {
     subscript(key: [Int]) -> NSNumber {
-        return self[key.map { NSNumber(value: $0) }]
+        get {
+            return self[key.map { NSNumber(value: $0) }]
+        }
+        set {
+            self[key.map { NSNumber(value: $0) }] = newValue
+        }
     }
 }
@@ -0,0 +1,366 @@
+//
+//  CapturedImagePyramid.swift
+//  StripeIdentity
+//
+//  Created by Stripe on 10/17/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+import Accelerate
+import CoreGraphics
+import CoreMedia
+import CoreVideo
+import Foundation
+
+/// The images derived from one camera capture, all made from a single decode of the capture.
+///
+/// The capture is decoded once into a vImage buffer that also backs `image`, without a copy. Crops are
+/// views into that buffer and smaller images are scaled from it with vImage, so the crops and downscales
+/// of a capture share one decode instead of each converting and redrawing the full frame. Images are
+/// cached by the region and size they were asked for, so asking twice returns the same image.
+///
+/// The full resolution image keeps a description of the decode it's backed by, so a pyramid made later
+/// from that image, e.g. by the uploader, reads the same pixels instead of decoding the image again.
+///
+/// Instances are safe to use from several threads at once, e.g. from concurrent encodes.
+final class CapturedImagePyramid {
+    /// The full resolution image
+    let image: CGImage
+
+    private let lock = NSLock()
+    private var sourceBuffer: vImage_Buffer?
+    /// Whether `sourceBuffer` was allocated by us, rather than being the pixels backing `image`
+    private(set) var ownsSourceBuffer = false
+    private var cachedImages: [CacheKey: CGImage] = [:]
+
+    private struct CacheKey: Hashable {
+        let region: CGRect
+        let maxPixelWidth: CGFloat
+        let maxPixelHeight: CGFloat
+
+        func hash(into hasher: inout Hasher) {
+            hasher.combine(region.origin.x)
+            hasher.combine(region.origin.y)
+            hasher.combine(region.width)
+            hasher.combine(region.height)
+            hasher.combine(maxPixelWidth)
+            hasher.combine(maxPixelHeight)
+        }
+    }
+
+    private static let bufferFormat = vImage_CGImageFormat(
+        bitsPerComponent: 8,
+        bitsPerPixel: 32,
+        colorSpace: CGColorSpaceCreateDeviceRGB(),
+        bitmapInfo: CGBitmapInfo(rawValue: CGImageAlphaInfo.noneSkipFirst.rawValue)
+    )!
+
+    /// Key of the sample buffer attachment that holds the pyramid made from the sample buffer
+    private static let attachmentKey = "com.stripe.identity.captured-image-pyramid" as CFString
+
+    /// Key of the `DecodedBitmap` associated with an image made from a decoded capture
+    private static var decodedBitmapKey: UInt8 = 0
+
+    /// The pixels backing an image made from a decoded capture. The image owns the pixels and holds
+    /// on to this description of them, so it can't outlive them.
+    private final class DecodedBitmap {
+        let buffer: vImage_Buffer
+
+        init(
+            buffer: vImage_Buffer
+        ) {
+            self.buffer = buffer
+        }
+    }
+
+    /// Decodes the pixel buffer into the pyramid's full resolution image
+    init?(
+        pixelBuffer: CVPixelBuffer
+    ) {
+        var format = CapturedImagePyramid.bufferFormat
+        var buffer = vImage_Buffer()
+        guard
+            vImageBuffer_InitWithCVPixelBuffer(
+                &buffer,
+                &format,
+                pixelBuffer,
+                nil,
+                nil,
+                vImage_Flags(kvImageNoFlags)
+            ) == kvImageNoError
+        else {
+            return nil
+        }
+
+        // The image takes ownership of the buffer's pixels and frees them when it's released
+        var error = kvImageNoError
+        guard
+            let image = vImageCreateCGImageFromBuffer(
+                &buffer,
+                &format,
+                nil,
+                nil,
+                vImage_Flags(kvImageNoAllocate),
+                &error
+            )?.takeRetainedValue(),
+            error == kvImageNoError
+        else {
+            buffer.free()
+            return nil
+        }
+        objc_setAssociatedObject(
+            image,
+            &CapturedImagePyramid.decodedBitmapKey,
+            DecodedBitmap(buffer: buffer),
+            .OBJC_ASSOCIATION_RETAIN_NONATOMIC
+        )
+        self.image = image
+        self.sourceBuffer = buffer
+    }
+
+    /// Makes a pyramid over an image that is already decoded. If the image came from a pyramid made
+    /// from a capture, its pixels are read in place. Otherwise, they're only decoded into a vImage
+    /// buffer the first time a scaled image is asked for.
+    init(
+        image: CGImage
+    ) {
+        self.image = image
+        self.sourceBuffer = (
+            objc_getAssociatedObject(image, &CapturedImagePyramid.decodedBitmapKey) as? DecodedBitmap
+        )?.buffer
+    }
+
+    deinit {
+        if ownsSourceBuffer {
+            sourceBuffer?.free()
+        }
+    }
+
+    /// The pyramid for the image in `sampleBuffer`, made the first time it's asked for and kept on the
+    /// sample buffer so that everything that handles the same capture shares it.
+    ///
+    /// - Note: Callers must not ask for the pyramid of the same sample buffer from several threads at
+    ///   once. The camera output and the scanner hand each sample buffer from one queue to the next.
+    static func pyramid(for sampleBuffer: CMSampleBuffer) -> CapturedImagePyramid? {
+        if let pyramid = CMGetAttachment(
+            sampleBuffer,
+            key: attachmentKey,
+            attachmentModeOut: nil
+        ) as? CapturedImagePyramid {
+            return pyramid
+        }
+        guard let pixelBuffer = CMSampleBufferGetImageBuffer(sampleBuffer),
+            let pyramid = CapturedImagePyramid(pixelBuffer: pixelBuffer)
+        else {
+            return nil
+        }
+        CMSetAttachment(
+            sampleBuffer,
+            key: attachmentKey,
+            value: pyramid,
+            attachmentMode: kCMAttachmentMode_ShouldNotPropagate
+        )
+        return pyramid
+    }
+
+    /// Crops the image the same way as `CGImage.cropping(toNormalizedRegion:withPadding:computationMethod:)`.
+    /// The crop shares its pixels with `image`.
+    ///
+    /// - Throws: STPCGImageError if the image could not be cropped
+    func croppedImage(
+        toNormalizedRegion normalizedRegion: CGRect,
+        withPadding cropPadding: CGFloat,
+        computationMethod: CGImage.CropPaddingComputationMethod
+    ) throws -> CGImage {
+        return try image(
+            in: pixelCropArea(
+                normalizedRegion: normalizedRegion,
+                cropPadding: cropPadding,
+                computationMethod: computationMethod
+            ),
+            maxPixelDimension: CGSize(width: CGFloat.infinity, height: CGFloat.infinity)
+        )
+    }
+
+    /// Crops the image and then scales the crop down the same way as `CGImage.scaledDown(toMaxPixelDimension:)`,
+    /// in one vImage pass from the decoded capture.
+    ///
+    /// - Throws: STPCGImageError if the image could not be cropped or scaled
+    func croppedImage(
+        toNormalizedRegion normalizedRegion: CGRect,
+        withPadding cropPadding: CGFloat,
+        computationMethod: CGImage.CropPaddingComputationMethod,
+        scaledDownToMaxPixelDimension maxPixelDimension: CGSize
+    ) throws -> CGImage {
+        return try image(
+            in: pixelCropArea(
+                normalizedRegion: normalizedRegion,
+                cropPadding: cropPadding,
+                computationMethod: computationMethod
+            ),
+            maxPixelDimension: maxPixelDimension
+        )
+    }
+
+    /// Scales the full image down the same way as `CGImage.scaledDown(toMaxPixelDimension:)`
+    ///
+    /// - Throws: STPCGImageError if the image could not be scaled
+    func scaledImage(
+        toMaxPixelDimension maxPixelDimension: CGSize
+    ) throws -> CGImage {
+        return try image(
+            in: CGRect(x: 0, y: 0, width: image.width, height: image.height),
+            maxPixelDimension: maxPixelDimension
+        )
+    }
+
+    /// The area of the capture, in pixels, that `croppedImage(toNormalizedRegion:withPadding:computationMethod:)`
+    /// crops to
+    ///
+    /// - Throws: STPCGImageError if the region doesn't overlap the capture
+    func pixelCropArea(
+        normalizedRegion: CGRect,
+        cropPadding: CGFloat,
+        computationMethod: CGImage.CropPaddingComputationMethod
+    ) throws -> CGRect {
+        // Same clamping as `CGImage.cropping(to:)`
+        let cropArea = image.computePixelCropArea(
+            normalizedRegion: normalizedRegion,
+            pixelPadding: image.computePixelPadding(
+                padding: cropPadding,
+                normalizedRegion: normalizedRegion,
+                computationMethod: computationMethod
+            )
+        ).intersection(CGRect(x: 0, y: 0, width: image.width, height: image.height)).integral
+
+        guard !cropArea.isNull, !cropArea.isEmpty else {
+            throw STPCGImageError.unableToCrop
+        }
+        return cropArea
+    }
+
+    // MARK: - Private
+
+    private func image(
+        in pixelRegion: CGRect,
+        maxPixelDimension: CGSize
+    ) throws -> CGImage {
+        let key = CacheKey(
+            region: pixelRegion,
+            maxPixelWidth: maxPixelDimension.width,
+            maxPixelHeight: maxPixelDimension.height
+        )
+        if let cachedImage = withLock({ cachedImages[key] }) {
+            return cachedImage
+        }
+
+        let scale = min(
+            min(maxPixelDimension.width, pixelRegion.width) / pixelRegion.width,
+            min(maxPixelDimension.height, pixelRegion.height) / pixelRegion.height
+        )
+
+        let regionImage: CGImage
+        if scale >= 1 {
+            guard let croppedImage = image.cropping(to: pixelRegion) else {
+                throw STPCGImageError.unableToCrop
+            }
+            regionImage = croppedImage
+        } else {
+            regionImage = try scaledImage(
+                in: pixelRegion,
+                width: Int(floor(pixelRegion.width * scale)),
+                height: Int(floor(pixelRegion.height * scale))
+            )
+        }
+
+        return withLock {
+            // Another thread may have made the same image while we did
+            if let cachedImage = cachedImages[key] {
+                return cachedImage
+            }
+            cachedImages[key] = regionImage
+            return regionImage
+        }
+    }
+
+    private func scaledImage(
+        in pixelRegion: CGRect,
+        width: Int,
+        height: Int
+    ) throws -> CGImage {
+        guard width > 0, height > 0, var source = try decodedRegion(pixelRegion) else {
+            throw STPCGImageError.unableToScaleDown
+        }
+        var format = CapturedImagePyramid.bufferFormat
+        guard
+            var destination = try? vImage_Buffer(
+                width: width,
+                height: height,
+                bitsPerPixel: format.bitsPerPixel
+            )
+        else {
+            throw STPCGImageError.unableToScaleDown
+        }
+
+        guard
+            vImageScale_ARGB8888(
+                &source,
+                &destination,
+                nil,
+                vImage_Flags(kvImageHighQualityResampling)
+            ) == kvImageNoError
+        else {
+            destination.free()
+            throw STPCGImageError.unableToScaleDown
+        }
+
+        // Hand the scaled pixels to the image rather than copying them
+        var error = kvImageNoError
+        guard
+            let scaledImage = vImageCreateCGImageFromBuffer(
+                &destination,
+                &format,
+                nil,
+                nil,
+                vImage_Flags(kvImageNoAllocate),
+                &error
+            )?.takeRetainedValue(),
+            error == kvImageNoError
+        else {
+            destination.free()
+            throw STPCGImageError.unableToScaleDown
+        }
+        return scaledImage
+    }
+
+    /// A view of the decoded capture covering `pixelRegion`, which shares its pixels with the decode
+    private func decodedRegion(_ pixelRegion: CGRect) throws -> vImage_Buffer? {
+        let buffer: vImage_Buffer? = try withLock {
+            if sourceBuffer == nil {
+                sourceBuffer = try vImage_Buffer(
+                    cgImage: image,
+                    format: CapturedImagePyramid.bufferFormat
+                )
+                ownsSourceBuffer = true
+            }
+            return sourceBuffer
+        }
+        guard let buffer = buffer, let data = buffer.data else {
+            return nil
+        }
+
+        let bytesPerPixel = Int(CapturedImagePyramid.bufferFormat.bitsPerPixel) / 8
+        return vImage_Buffer(
+            data: data.advanced(by: Int(pixelRegion.minY) * buffer.rowBytes + Int(pixelRegion.minX) * bytesPerPixel),
+            height: vImagePixelCount(pixelRegion.height),
+            width: vImagePixelCount(pixelRegion.width),
+            rowBytes: buffer.rowBytes
+        )
+    }
+
+    private func withLock<T>(_ block: () throws -> T) rethrows -> T {
+        lock.lock()
+        defer { lock.unlock() }
+        return try block()
+    }
+}
@@ -101,7 +101,7 @@ extension DocumentScanner: ImageScanner {
             }
 
             // MBDetector not avaialbe, fallback to legacy
-                return scanImageLegacy(pixelBuffer: pixelBuffer, idDetectorOutput: idDetectorOutput, cameraProperties: cameraProperties)
+                return scanImageLegacy(pixelBuffer: pixelBuffer, sampleBuffer: sampleBuffer, idDetectorOutput: idDetectorOutput, cameraProperties: cameraProperties)
         } catch {
             return Promise(error: error)
         }
@@ -109,6 +109,7 @@ extension DocumentScanner: ImageScanner {
 
     fileprivate func processCommonResults(
         pixelBuffer: CVPixelBuffer,
+        sampleBuffer: CMSampleBuffer,
         idDetectorOutput: IDDetectorOutput,
         cameraProperties: CameraSession.DeviceProperties?
     ) throws -> (motionBlurOutput: MotionBlurDetector.Output, barcodeOutput: BarcodeDetectorOutput?, blurResult: LaplacianBlurDetector.Output)  {
@@ -129,17 +130,18 @@ extension DocumentScanner: ImageScanner {
             )
         }
 
-        let blurResult: LaplacianBlurDetector.Output = try {
-            let originalImage = pixelBuffer.cgImage()
-            guard let croppedImage = try originalImage?.cropping(
-                toNormalizedRegion: idDetectorOutput.documentBounds,
-                withPadding: highResImageCropPadding,
-                computationMethod: .maxImageWidthOrHeight
-            )
+        // Measured on the camera frame itself, over the region the high-res image is cropped to
+        let blurResult: LaplacianBlurDetector.Output = {
+            guard
+                let cropArea = try? CapturedImagePyramid.pyramid(for: sampleBuffer)?.pixelCropArea(
+                    normalizedRegion: idDetectorOutput.documentBounds,
+                    cropPadding: highResImageCropPadding,
+                    computationMethod: .maxImageWidthOrHeight
+                )
             else {
                 return LaplacianBlurDetector.defaultOutput
             }
-            return blurDetector.calculateBlurOutput(inputImage: croppedImage)
+            return blurDetector.calculateBlurOutput(pixelBuffer: pixelBuffer, regionOfInterest: cropArea)
         }()
 
         return (motionBlurOutput, barcodeOutput, blurResult)
@@ -147,11 +149,12 @@ extension DocumentScanner: ImageScanner {
 
     fileprivate func scanImageLegacy(
         pixelBuffer: CVPixelBuffer,
+        sampleBuffer: CMSampleBuffer,
         idDetectorOutput: IDDetectorOutput,
         cameraProperties: CameraSession.DeviceProperties?
     ) -> Future<DocumentScannerOutput?> {
         do {
-            let commonOutputs = try processCommonResults(pixelBuffer: pixelBuffer, idDetectorOutput: idDetectorOutput, cameraProperties: cameraProperties)
+            let commonOutputs = try processCommonResults(pixelBuffer: pixelBuffer, sampleBuffer: sampleBuffer, idDetectorOutput: idDetectorOutput, cameraProperties: cameraProperties)
             return Promise(value: DocumentScannerOutput.legacy(
                 idDetectorOutput,
                 commonOutputs.barcodeOutput,
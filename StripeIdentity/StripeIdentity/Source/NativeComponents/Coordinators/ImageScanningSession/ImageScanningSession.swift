@@ -316,7 +316,7 @@ final class ImageScanningSession<
         guard delegate?.imageScanningSessionShouldScanCameraOutput(self) != false,
             case .scanning(let expectedClassification, _) = state,
             let pixelBuffer = CMSampleBufferGetImageBuffer(sampleBuffer),
-            let cgImage = pixelBuffer.cgImage()
+            let cgImage = CapturedImagePyramid.pyramid(for: sampleBuffer)?.image
         else {
             return
         }
@@ -36,8 +36,12 @@ final class IdentityImageUploader {
     let analyticsClient: IdentityAnalyticsClient
     let sheetController: VerificationSheetControllerProtocol
 
-    /// Worker queue to encode the image to jpeg
-    let imageEncodingQueue = DispatchQueue(label: "com.stripe.identity.image-encoding")
+    /// Worker queue to resize and encode images to jpeg. It's concurrent so that the
+    /// low-res and high-res images of a capture are encoded at the same time.
+    let imageEncodingQueue = DispatchQueue(
+        label: "com.stripe.identity.image-encoding",
+        attributes: .concurrent
+    )
 
     init(
         configuration: Configuration,
@@ -88,13 +92,17 @@ final class IdentityImageUploader {
         lowResFileName: String,
         highResFileName: String
     ) -> Future<LowHighResFiles> {
+        // Both images are scaled from the same decode of the image, and are
+        // encoded concurrently
+        let pyramid = CapturedImagePyramid(image: image)
+
         let lowResUploadFuture = uploadLowResImage(
-            image,
+            pyramid,
             fileName: lowResFileName
         )
 
         return uploadHighResImage(
-            image,
+            pyramid,
             regionOfInterest: highResRegionOfInterest,
             cropPaddingComputationMethod: cropPaddingComputationMethod,
             fileName: highResFileName
@@ -118,29 +126,42 @@ final class IdentityImageUploader {
         cropPaddingComputationMethod: CGImage.CropPaddingComputationMethod,
         fileName: String
     ) -> Future<StripeFile> {
-        do {
+        return uploadHighResImage(
+            CapturedImagePyramid(image: image),
+            regionOfInterest: regionOfInterest,
+            cropPaddingComputationMethod: cropPaddingComputationMethod,
+            fileName: fileName
+        )
+    }
+
+    /// Crops, resizes, and uploads the high resolution image of a capture to the server
+    func uploadHighResImage(
+        _ pyramid: CapturedImagePyramid,
+        regionOfInterest: CGRect?,
+        cropPaddingComputationMethod: CGImage.CropPaddingComputationMethod,
+        fileName: String
+    ) -> Future<StripeFile> {
+        let maxPixelDimension = CGSize(
+            width: configuration.highResImageMaxDimension,
+            height: configuration.highResImageMaxDimension
+        )
+        let cropPadding = configuration.highResImageCropPadding
+
+        return uploadJPEG(
+            fileName: fileName,
+            jpegCompressionQuality: configuration.highResImageCompressionQuality,
+            imageErrorStage: regionOfInterest == nil ? .imageResize : .highResCrop
+        ) {
             // Crop image if there's a region of interest
-            var imageToResize = image
-            if let regionOfInterest = regionOfInterest {
-                imageToResize = try image.cropping(
-                    toNormalizedRegion: regionOfInterest,
-                    withPadding: configuration.highResImageCropPadding,
-                    computationMethod: cropPaddingComputationMethod
-                )
+            guard let regionOfInterest = regionOfInterest else {
+                return try pyramid.scaledImage(toMaxPixelDimension: maxPixelDimension)
             }
-
-            return uploadJPEGResize(
-                image: imageToResize,
-                fileName: fileName,
-                jpegCompressionQuality: configuration.highResImageCompressionQuality,
-                newSize: CGSize(
-                    width: configuration.highResImageMaxDimension,
-                    height: configuration.highResImageMaxDimension
-                )
+            return try pyramid.croppedImage(
+                toNormalizedRegion: regionOfInterest,
+                withPadding: cropPadding,
+                computationMethod: cropPaddingComputationMethod,
+                scaledDownToMaxPixelDimension: maxPixelDimension
             )
-        } catch {
-            logUploadError(error, stage: .highResCrop, fileName: fileName)
-            return Promise(error: error)
         }
     }
 
@@ -149,15 +170,29 @@ final class IdentityImageUploader {
         _ image: CGImage,
         fileName: String
     ) -> Future<StripeFile> {
-        return uploadJPEGResize(
-            image: image,
+        return uploadLowResImage(
+            CapturedImagePyramid(image: image),
+            fileName: fileName
+        )
+    }
+
+    /// Resizes and uploads the low resolution image of a capture to the server
+    func uploadLowResImage(
+        _ pyramid: CapturedImagePyramid,
+        fileName: String
+    ) -> Future<StripeFile> {
+        let maxPixelDimension = CGSize(
+            width: configuration.lowResImageMaxDimension,
+            height: configuration.lowResImageMaxDimension
+        )
+
+        return uploadJPEG(
             fileName: fileName,
             jpegCompressionQuality: configuration.lowResImageCompressionQuality,
-            newSize: CGSize(
-                width: configuration.lowResImageMaxDimension,
-                height: configuration.lowResImageMaxDimension
-            )
-        )
+            imageErrorStage: .imageResize
+        ) {
+            return try pyramid.scaledImage(toMaxPixelDimension: maxPixelDimension)
+        }
     }
 
     func uploadJPEGResize(
@@ -166,17 +201,12 @@ final class IdentityImageUploader {
         jpegCompressionQuality: CGFloat,
         newSize: CGSize
     ) -> Future<StripeFile> {
-        do {
-            let resizedImage = try image.scaledDown(toMaxPixelDimension: newSize)
-
-            return uploadJPEG(
-                image: resizedImage,
-                fileName: fileName,
-                jpegCompressionQuality: jpegCompressionQuality
-            )
-        } catch {
-            logUploadError(error, stage: .imageResize, fileName: fileName)
-            return Promise(error: error)
+        return uploadJPEG(
+            fileName: fileName,
+            jpegCompressionQuality: jpegCompressionQuality,
+            imageErrorStage: .imageResize
+        ) {
+            return try CapturedImagePyramid(image: image).scaledImage(toMaxPixelDimension: newSize)
         }
     }
 
@@ -185,11 +215,40 @@ final class IdentityImageUploader {
         image: CGImage,
         fileName: String,
         jpegCompressionQuality: CGFloat
+    ) -> Future<StripeFile> {
+        return uploadJPEG(
+            fileName: fileName,
+            jpegCompressionQuality: jpegCompressionQuality,
+            imageErrorStage: .imageResize
+        ) {
+            return image
+        }
+    }
+
+    /// Crops or resizes the image with `makeImage`, converts it to JPEG data, and
+    /// uploads it to the server, all on a worker thread. Uploads run concurrently
+    /// with one another.
+    ///
+    /// - Parameter imageErrorStage: The stage logged if `makeImage` throws
+    private func uploadJPEG(
+        fileName: String,
+        jpegCompressionQuality: CGFloat,
+        imageErrorStage: UploadErrorStage,
+        makeImage: @escaping () throws -> CGImage
     ) -> Future<StripeFile> {
         let promise = Promise<StripeFile>()
         imageEncodingQueue.async { [weak self] in
             guard let self = self else { return }
 
+            let image: CGImage
+            do {
+                image = try makeImage()
+            } catch {
+                self.logUploadError(error, stage: imageErrorStage, fileName: fileName)
+                promise.reject(with: error)
+                return
+            }
+
             let uiImage = UIImage(cgImage: image)
             self.apiClient.uploadImage(
                 uiImage,
@@ -10,6 +10,7 @@ import CoreGraphics
 import CoreML
 import Foundation
 @_spi(STP) import StripeCameraCore
+@_spi(STP) import StripeCore
 import Vision
 
 /// Represents the output from the FaceDetector ML model.
@@ -25,15 +26,6 @@ struct FaceDetectorPrediction: Equatable {
     let score: Float
 }
 
-// MARK: MLBoundingBox
-
-extension FaceDetectorPrediction: MLBoundingBox {
-    // FaceDetector has no classification, so each prediction has the same classIndex
-    var classIndex: Int {
-        return 0
-    }
-}
-
 // MARK: - MultiArray
 
 extension FaceDetectorOutput: VisionBasedDetectorOutput {
@@ -94,47 +86,70 @@ extension FaceDetectorOutput: VisionBasedDetectorOutput {
         originalImageSize: CGSize,
         configuration: FaceDetector.Configuration
     ) {
-        let numPredictions = scores.shape[1].intValue
+        let bestPredictions =
+            scores.withMatrixView({ scores in
+                boxes.withMatrixView { boxes in
+                    FaceDetectorOutput.bestPredictions(
+                        boxes: boxes,
+                        scores: scores,
+                        configuration: configuration
+                    )
+                }
+            }) ?? nil
+
+        self.init(
+            centerCroppedSquarePredictions: bestPredictions ?? [],
+            originalImageSize: originalImageSize
+        )
+    }
+
+    /// Uses the non-maximum-suppression algorithm to determine the best scores and
+    /// bounding boxes, sorted by score from high to low.
+    ///
+    /// Rows are thresholded on their score before their box is read, and candidates
+    /// go straight into NMS without making a `FaceDetectorPrediction` for each.
+    private static func bestPredictions(
+        boxes: MLMultiArrayMatrixView,
+        scores: MLMultiArrayMatrixView,
+        configuration: FaceDetector.Configuration
+    ) -> [FaceDetectorPrediction] {
+        // Every row of `scores` needs a box
+        guard boxes.rows == scores.rows, boxes.columns == 4, scores.columns > 0 else {
+            return []
+        }
 
-        let predictions: [FaceDetectorPrediction] = (0..<numPredictions).compactMap { index in
+        let engine = NonMaxSuppressionEngine()
+        var candidateRows: [Int] = []
 
-            let score = scores[[0, index, 0]].floatValue
+        for row in 0..<scores.rows {
+            let score = scores.score(row: row, column: 0)
 
             // Discard results that have a score lower than minScore
             guard score >= configuration.minScore else {
-                return nil
+                continue
             }
 
-            let rect = CGRect(
-                x: boxes[[0, index, 0]].doubleValue,
-                y: boxes[[0, index, 1]].doubleValue,
-                width: boxes[[0, index, 2]].doubleValue,
-                height: boxes[[0, index, 3]].doubleValue
-            )
+            let rect = boxes.rect(atRow: row)
             // Discard results that are outside the bounds of the image
             guard CGRect.normalizedBounds.contains(rect) else {
-                return nil
+                continue
             }
-            return .init(
-                rect: rect,
-                score: score
-            )
+            candidateRows.append(row)
+            engine.append(rect: rect, score: score)
         }
 
         // Use NMS to get the best bounding boxes
-        // NOTE: The result of `nonMaxSuppression` will be sorted by score
-        let bestPredictions = nonMaxSuppression(
-            boundingBoxes: predictions,
+        // NOTE: The result of `hardNMS` will be sorted by score
+        return engine.hardNMS(
             iouThreshold: configuration.minIOU,
-            maxBoxes: FaceDetectorOutput.nmsMaxResults
+            maxOutputs: FaceDetectorOutput.nmsMaxResults
         ).map { index in
-            return predictions[index]
+            let row = candidateRows[index]
+            return .init(
+                rect: boxes.rect(atRow: row),
+                score: scores.score(row: row, column: 0)
+            )
         }
-
-        self.init(
-            centerCroppedSquarePredictions: bestPredictions,
-            originalImageSize: originalImageSize
-        )
     }
 
     /// Initializes `FaceDetectorOutput` from a list of predictions using a
@@ -10,6 +10,7 @@ import CoreGraphics
 import CoreML
 import Foundation
 @_spi(STP) import StripeCameraCore
+@_spi(STP) import StripeCore
 import Vision
 
 /// Represents the output from the IDDetector ML model.
@@ -37,16 +38,10 @@ struct IDDetectorOutput: Equatable {
 /// Represents a single prediction from the IDDetector ML model.
 /// The IDDetector outputs a large set of predictions that are then reduced into an
 /// IDDetectorOutput using the Non-Maximum Suppression algorithm.
-struct IDDetectorPrediction: MLBoundingBox {
+struct IDDetectorPrediction {
     let classification: IDDetectorOutput.Classification
     let score: Float
     let rect: CGRect
-
-    // MARK: MLBoundingBox
-
-    var classIndex: Int {
-        return classification.rawValue
-    }
 }
 
 // MARK: - MultiArray
@@ -116,60 +111,93 @@ extension IDDetectorOutput: OptionalVisionBasedDetectorOutput {
         originalImageSize: CGSize,
         configuration: IDDetector.Configuration
     ) {
+        guard
+            let bestPredictions = scores.withMatrixView({ scores in
+                boxes.withMatrixView { boxes in
+                    IDDetectorOutput.bestPredictions(
+                        boxes: boxes,
+                        scores: scores,
+                        configuration: configuration
+                    )
+                }
+            }) ?? nil
+        else {
+            return nil
+        }
+
+        self.init(
+            sortedPredictions: bestPredictions,
+            originalImageSize: originalImageSize
+        )
+    }
+
+    /// Uses the non-maximum-suppression algorithm to determine the best score and
+    /// bounding box for each classification, sorted by score from high to low.
+    ///
+    /// Candidates for every classification are collected in one pass over the
+    /// model's output. Rows are thresholded on their scores before their box is
+    /// read, and `IDDetectorPrediction`s are only made for the boxes NMS keeps.
+    private static func bestPredictions(
+        boxes: MLMultiArrayMatrixView,
+        scores: MLMultiArrayMatrixView,
+        configuration: IDDetector.Configuration
+    ) -> [IDDetectorPrediction] {
+        // Every row of `scores` needs a box
+        guard boxes.rows == scores.rows, boxes.columns == 4 else {
+            return []
+        }
+
         // NOTE: The number of classifications in `scores` may differ from
         // `IDDetectorOutput.Classification` if the model has been updated
-        // with additional classifications.
-        let numClasses = scores.shape[2].intValue
-        let numPredictions = scores.shape[1].intValue
-
-        // Aggregate all of the predictions across all the classifications into
-        // one array of bounding boxes.
-        var predictions: [IDDetectorPrediction] = []
-        predictions.reserveCapacity(numClasses * numPredictions)
-
-        (0..<numClasses).forEach { rawClassification in
-            // If the client doesn't recognize the classification, ignore the prediction
-            guard let classification = Classification(rawValue: rawClassification) else {
-                return
-            }
-            predictions += (0..<numPredictions).compactMap { index in
-                let rect = CGRect(
-                    x: boxes[[0, index, 0]].doubleValue,
-                    y: boxes[[0, index, 1]].doubleValue,
-                    width: boxes[[0, index, 2]].doubleValue,
-                    height: boxes[[0, index, 3]].doubleValue
-                )
+        // with additional classifications. If the client doesn't recognize
+        // the classification, ignore its predictions.
+        let classifications = (0..<scores.columns).compactMap(Classification.init(rawValue:))
 
+        // The rows of the candidates for each classification, in row order
+        var candidateRows = [[Int]](repeating: [], count: classifications.count)
+        for row in 0..<scores.rows {
+            var isInBounds: Bool?
+            for (classificationIndex, classification) in classifications.enumerated()
+            where scores.score(row: row, column: classification.rawValue) > configuration.minScore {
                 // Discard results that are outside the bounds of the image
-                guard CGRect.normalizedBounds.contains(rect) else {
-                    return nil
+                if isInBounds == nil {
+                    isInBounds = CGRect.normalizedBounds.contains(boxes.rect(atRow: row))
                 }
-
-                return .init(
-                    classification: classification,
-                    score: scores[[0, index, rawClassification]].floatValue,
-                    rect: rect
-                )
+                guard isInBounds == true else {
+                    break
+                }
+                candidateRows[classificationIndex].append(row)
             }
         }
 
         // Use NMS to get the best bounding box for each classification
-        // NOTE: The result of `nonMaxSuppressionMultiClass` will be sorted by score
-        let bestPredictions = nonMaxSuppressionMultiClass(
-            numClasses: numClasses,
-            boundingBoxes: predictions,
-            scoreThreshold: configuration.minScore,
-            iouThreshold: configuration.minIOU,
-            maxPerClass: 1,
-            maxTotal: numClasses
-        ).map { index in
-            return predictions[index]
+        let engine = NonMaxSuppressionEngine(capacity: candidateRows.map(\.count).max() ?? 0)
+        var bestPredictions: [IDDetectorPrediction] = []
+        for (classification, rows) in zip(classifications, candidateRows) {
+            engine.removeAll()
+            for row in rows {
+                engine.append(
+                    rect: boxes.rect(atRow: row),
+                    score: scores.score(row: row, column: classification.rawValue)
+                )
+            }
+            guard let best = engine.hardNMS(iouThreshold: configuration.minIOU, maxOutputs: 1).first else {
+                continue
+            }
+            let row = rows[best]
+            bestPredictions.append(
+                .init(
+                    classification: classification,
+                    score: scores.score(row: row, column: classification.rawValue),
+                    rect: boxes.rect(atRow: row)
+                )
+            )
         }
 
-        self.init(
-            sortedPredictions: bestPredictions,
-            originalImageSize: originalImageSize
-        )
+        // Sort by score, keeping classification order between equal scores
+        return bestPredictions.enumerated().sorted {
+            ($0.element.score, $1.offset) > ($1.element.score, $0.offset)
+        }.map(\.element)
     }
 
     /// Initializes `IDDetectorOutput` from a list of predictions.
@@ -0,0 +1,179 @@
+//
+//  LaplacianBlurDetector.swift
+//  StripeIdentity
+//
+//  Created by Chen Cen on 8/22/23.
+//
+
+import Accelerate
+import CoreVideo
+import Foundation
+@_spi(STP) import StripeCameraCore
+
+/// Detector to determine if an image is blurry based on the Laplacian of its luminance.
+///
+/// The Laplacian is computed on the CPU by default, straight from the luminance plane of camera frames.
+/// Metal is available as an alternative backend. Both compute in float.
+final class LaplacianBlurDetector {
+    struct Output: Equatable {
+        let isBlurry: Bool
+        let variance: Float
+    }
+
+    enum Backend {
+        /// SIMD on the CPU, see `LaplacianKernel`
+        case cpu
+        /// Metal Performance Shaders on the GPU, see `MetalLaplacianBackend`. Falls back to the CPU if
+        /// Metal isn't available or doesn't support the frame's pixel format.
+        case metal
+    }
+
+    let blurThreshold: Float
+    let backend: Backend
+    /// Which tiles of the image the CPU backend samples
+    let tileSampling: LaplacianTileSampling
+
+    private lazy var metalBackend: MetalLaplacianBackend? = {
+        return backend == .metal ? MetalLaplacianBackend() : nil
+    }()
+    private let metalBackendLock = NSLock()
+
+    init(
+        blurThreshold: Float,
+        backend: Backend = .cpu,
+        tileSampling: LaplacianTileSampling = .all
+    ) {
+        self.blurThreshold = blurThreshold
+        self.backend = backend
+        self.tileSampling = tileSampling
+    }
+
+    /// Default non blurry result if error occurs.
+    static let defaultOutput = Output(isBlurry: false, variance: 0)
+
+    /// Calculate the blur output of a region of a camera frame. If error occurs, return defaultOutput with
+    /// non blurry result.
+    ///
+    /// - Parameters:
+    ///   - pixelBuffer: The camera frame
+    ///   - regionOfInterest: The region to measure, in pixels
+    func calculateBlurOutput(
+        pixelBuffer: CVPixelBuffer,
+        regionOfInterest: CGRect
+    ) -> Output {
+        if let statistics = makeMetalBackend()?.statistics(of: pixelBuffer, in: regionOfInterest) {
+            return output(for: statistics)
+        }
+
+        let statistics = withLuminancePlane(of: pixelBuffer) { plane in
+            plane.region(regionOfInterest).flatMap {
+                LaplacianKernel.statistics(of: $0, sampling: tileSampling)
+            }
+        }
+        return statistics.map(output(for:)) ?? LaplacianBlurDetector.defaultOutput
+    }
+
+    /// Calculate the blur output of an image. If error occurs, return defaultOutput with non blurry result.
+    func calculateBlurOutput(inputImage: CGImage) -> Output {
+        if let statistics = makeMetalBackend()?.statistics(of: inputImage) {
+            return output(for: statistics)
+        }
+
+        guard var buffer = try? vImage_Buffer(cgImage: inputImage, format: LaplacianBlurDetector.luminanceFormat)
+        else {
+            return LaplacianBlurDetector.defaultOutput
+        }
+        defer { buffer.free() }
+
+        let plane = LuminancePlane(
+            baseAddress: buffer.data.assumingMemoryBound(to: UInt8.self),
+            width: Int(buffer.width),
+            height: Int(buffer.height),
+            rowBytes: buffer.rowBytes
+        )
+        return LaplacianKernel.statistics(of: plane, sampling: tileSampling).map(output(for:))
+            ?? LaplacianBlurDetector.defaultOutput
+    }
+
+    // MARK: - Private
+
+    /// 8-bit grayscale, used to convert images that don't come with a luminance plane
+    private static let luminanceFormat = vImage_CGImageFormat(
+        bitsPerComponent: 8,
+        bitsPerPixel: 8,
+        colorSpace: CGColorSpaceCreateDeviceGray(),
+        bitmapInfo: CGBitmapInfo(rawValue: CGImageAlphaInfo.none.rawValue)
+    )!
+
+    /// The score compared to `blurThreshold`.
+    ///
+    /// It's the statistic `blurThreshold` has always been tuned against: the first pixel written by
+    /// `MPSImageStatisticsMeanAndVariance`, which is the mean of the clamped Laplacian, on a 0–255 scale.
+    /// It used to be read back rounded to 8 bits, and is now kept in float.
+    private func output(for statistics: LaplacianStatistics) -> Output {
+        let score = statistics.mean * 255
+        return Output(isBlurry: score < blurThreshold, variance: score)
+    }
+
+    private func makeMetalBackend() -> MetalLaplacianBackend? {
+        guard backend == .metal else {
+            return nil
+        }
+        metalBackendLock.lock()
+        defer { metalBackendLock.unlock() }
+        return metalBackend
+    }
+
+    /// Calls `block` with the frame's luminance plane. Bi-planar YCbCr frames, which is what the camera
+    /// captures, are read in place. Other formats are converted to grayscale first.
+    private func withLuminancePlane<T>(
+        of pixelBuffer: CVPixelBuffer,
+        _ block: (LuminancePlane) -> T?
+    ) -> T? {
+        switch CVPixelBufferGetPixelFormatType(pixelBuffer) {
+        case kCVPixelFormatType_420YpCbCr8BiPlanarFullRange,
+            kCVPixelFormatType_420YpCbCr8BiPlanarVideoRange:
+            guard CVPixelBufferLockBaseAddress(pixelBuffer, .readOnly) == kCVReturnSuccess else {
+                return nil
+            }
+            defer { CVPixelBufferUnlockBaseAddress(pixelBuffer, .readOnly) }
+
+            guard let baseAddress = CVPixelBufferGetBaseAddressOfPlane(pixelBuffer, 0) else {
+                return nil
+            }
+            return block(
+                LuminancePlane(
+                    baseAddress: baseAddress.assumingMemoryBound(to: UInt8.self),
+                    width: CVPixelBufferGetWidthOfPlane(pixelBuffer, 0),
+                    height: CVPixelBufferGetHeightOfPlane(pixelBuffer, 0),
+                    rowBytes: CVPixelBufferGetBytesPerRowOfPlane(pixelBuffer, 0)
+                )
+            )
+        default:
+            var format = LaplacianBlurDetector.luminanceFormat
+            var buffer = vImage_Buffer()
+            guard
+                vImageBuffer_InitWithCVPixelBuffer(
+                    &buffer,
+                    &format,
+                    pixelBuffer,
+                    nil,
+                    nil,
+                    vImage_Flags(kvImageNoFlags)
+                ) == kvImageNoError
+            else {
+                return nil
+            }
+            defer { buffer.free() }
+
+            return block(
+                LuminancePlane(
+                    baseAddress: buffer.data.assumingMemoryBound(to: UInt8.self),
+                    width: Int(buffer.width),
+                    height: Int(buffer.height),
+                    rowBytes: buffer.rowBytes
+                )
+            )
+        }
+    }
+}
@@ -0,0 +1,176 @@
+//
+//  LaplacianKernel.swift
+//  StripeIdentity
+//
+//  Created by Stripe on 10/17/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+import Foundation
+
+/// A read-only view of an 8-bit luminance plane, e.g. the Y plane of a camera frame.
+/// The view doesn't own its pixels, they must stay alive while it's used.
+struct LuminancePlane {
+    let baseAddress: UnsafePointer<UInt8>
+    let width: Int
+    let height: Int
+    let rowBytes: Int
+
+    /// A view of `pixelRegion` of this plane, clamped to the plane's bounds. Returns nil if the region
+    /// doesn't overlap the plane.
+    func region(_ pixelRegion: CGRect) -> LuminancePlane? {
+        let clampedRegion = pixelRegion.integral.intersection(
+            CGRect(x: 0, y: 0, width: width, height: height)
+        )
+        guard !clampedRegion.isNull, !clampedRegion.isEmpty else {
+            return nil
+        }
+        return LuminancePlane(
+            baseAddress: baseAddress + Int(clampedRegion.minY) * rowBytes + Int(clampedRegion.minX),
+            width: Int(clampedRegion.width),
+            height: Int(clampedRegion.height),
+            rowBytes: rowBytes
+        )
+    }
+}
+
+/// Statistics of the Laplacian of a luminance plane, computed in float.
+///
+/// The Laplacian uses the same 4-neighbor kernel as `MPSImageLaplacian`, on luminance normalized to
+/// 0–1. Responses are clamped to 0–1, the way they are when `MPSImageLaplacian` writes them to an
+/// 8-bit texture, so the statistics match what the Metal backend measures.
+struct LaplacianStatistics: Equatable {
+    let mean: Float
+    let variance: Float
+    /// Number of pixels the statistics were computed over
+    let sampleCount: Int
+}
+
+/// Which parts of a plane the Laplacian is computed over
+struct LaplacianTileSampling: Equatable {
+    /// Width and height of a tile, in pixels
+    let tileSize: Int
+    /// Every `stride`th tile along each row is sampled, offset by one tile on each row of tiles, so
+    /// a stride of 2 samples a checkerboard of half of the tiles
+    let stride: Int
+
+    /// Samples every pixel
+    static let all = LaplacianTileSampling(tileSize: 64, stride: 1)
+    /// Samples half of the plane in a checkerboard of 64px tiles
+    static let checkerboard = LaplacianTileSampling(tileSize: 64, stride: 2)
+}
+
+/// Computes Laplacian statistics on the CPU with SIMD, 8 pixels at a time.
+///
+/// This only depends on the standard library so that it can be tested and benchmarked against
+/// recorded frames anywhere, without a GPU or a camera.
+enum LaplacianKernel {
+
+    /// Computes the statistics of the Laplacian over the sampled tiles of `plane`. Pixels on the
+    /// plane's edges are skipped since they don't have all of their neighbors.
+    ///
+    /// - Returns: The statistics, or nil if the plane is smaller than 3x3.
+    static func statistics(
+        of plane: LuminancePlane,
+        sampling: LaplacianTileSampling = .all
+    ) -> LaplacianStatistics? {
+        guard plane.width >= 3, plane.height >= 3 else {
+            return nil
+        }
+
+        let tileSize = max(sampling.tileSize, 1)
+        let stride = max(sampling.stride, 1)
+        let interiorWidth = plane.width - 2
+        let interiorHeight = plane.height - 2
+        let tileColumns = (interiorWidth + tileSize - 1) / tileSize
+        let tileRows = (interiorHeight + tileSize - 1) / tileSize
+
+        var sum = 0.0
+        var sumOfSquares = 0.0
+        var sampleCount = 0
+
+        for tileRow in 0..<tileRows {
+            let minY = 1 + tileRow * tileSize
+            let maxY = min(minY + tileSize, plane.height - 1)
+
+            for tileColumn in Swift.stride(from: tileRow % stride, to: tileColumns, by: stride) {
+                let minX = 1 + tileColumn * tileSize
+                let maxX = min(minX + tileSize, plane.width - 1)
+
+                for y in minY..<maxY {
+                    accumulateRow(
+                        y,
+                        from: minX,
+                        to: maxX,
+                        of: plane,
+                        sum: &sum,
+                        sumOfSquares: &sumOfSquares
+                    )
+                }
+                sampleCount += (maxX - minX) * (maxY - minY)
+            }
+        }
+
+        guard sampleCount > 0 else {
+            return nil
+        }
+        let mean = sum / Double(sampleCount)
+        let variance = max(sumOfSquares / Double(sampleCount) - mean * mean, 0)
+        return LaplacianStatistics(
+            mean: Float(mean),
+            variance: Float(variance),
+            sampleCount: sampleCount
+        )
+    }
+
+    private static let vectorWidth = 8
+    private static let normalization: Float = 1 / 255
+
+    /// Adds the clamped Laplacian of pixels `minX..<maxX` of row `y` to the sums
+    private static func accumulateRow(
+        _ y: Int,
+        from minX: Int,
+        to maxX: Int,
+        of plane: LuminancePlane,
+        sum: inout Double,
+        sumOfSquares: inout Double
+    ) {
+        let row = plane.baseAddress + y * plane.rowBytes
+        let rowAbove = row - plane.rowBytes
+        let rowBelow = row + plane.rowBytes
+
+        // Sums are kept per lane in float for the row, and added up in double across rows
+        var vectorSum = SIMD8<Float>()
+        var vectorSumOfSquares = SIMD8<Float>()
+        var x = minX
+        while x + vectorWidth <= maxX {
+            let laplacian =
+                (load(rowAbove + x) + load(rowBelow + x) + load(row + x - 1) + load(row + x + 1)
+                    - 4 * load(row + x)) * normalization
+            let response = laplacian.clamped(lowerBound: .zero, upperBound: .one)
+            vectorSum += response
+            vectorSumOfSquares += response * response
+            x += vectorWidth
+        }
+
+        var rowSum = vectorSum.sum()
+        var rowSumOfSquares = vectorSumOfSquares.sum()
+        while x < maxX {
+            let laplacian =
+                Float(
+                    Int(rowAbove[x]) + Int(rowBelow[x]) + Int(row[x - 1]) + Int(row[x + 1]) - 4 * Int(row[x])
+                ) * normalization
+            let response = min(max(laplacian, 0), 1)
+            rowSum += response
+            rowSumOfSquares += response * response
+            x += 1
+        }
+
+        sum += Double(rowSum)
+        sumOfSquares += Double(rowSumOfSquares)
+    }
+
+    private static func load(_ pointer: UnsafePointer<UInt8>) -> SIMD8<Float> {
+        return SIMD8<Float>(UnsafeRawPointer(pointer).loadUnaligned(as: SIMD8<UInt8>.self))
+    }
+}
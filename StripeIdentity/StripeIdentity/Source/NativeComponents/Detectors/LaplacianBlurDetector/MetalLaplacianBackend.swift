@@ -0,0 +1,232 @@
+//
+//  MetalLaplacianBackend.swift
+//  StripeIdentity
+//
+//  Created by Stripe on 10/17/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+import CoreVideo
+import Foundation
+import Metal
+import MetalKit
+import MetalPerformanceShaders
+
+/// Computes Laplacian statistics on the GPU with Metal Performance Shaders.
+///
+/// The pipeline objects, texture cache and destination textures are made once and reused across frames,
+/// with the Laplacian texture growing to fit the largest region it has been asked for.
+/// Camera frames are wrapped in textures through a `CVMetalTextureCache` instead of being copied.
+/// Statistics are read back as 32-bit floats.
+///
+/// Frames are measured one at a time, since they share the destination textures.
+final class MetalLaplacianBackend {
+    private let commandQueue: MTLCommandQueue
+    private let device: MTLDevice
+    private let laplacian: MPSImageLaplacian
+    private let meanAndVariance: MPSImageStatisticsMeanAndVariance
+    private let textureCache: CVMetalTextureCache
+    private let textureLoader: MTKTextureLoader
+
+    private let lock = NSLock()
+    /// Reused for every region that fits in it, only the region's part of it is written and measured
+    private var laplacianTexture: MTLTexture?
+    /// Keyed by the pixel format of the frames, which decides the number of channels
+    private var statisticsTextures: [MTLPixelFormat: MTLTexture] = [:]
+
+    init?(
+        device: MTLDevice? = MTLCreateSystemDefaultDevice()
+    ) {
+        var textureCache: CVMetalTextureCache?
+        guard let device = device,
+            let commandQueue = device.makeCommandQueue(),
+            CVMetalTextureCacheCreate(nil, nil, device, nil, &textureCache) == kCVReturnSuccess,
+            let textureCache = textureCache
+        else {
+            return nil
+        }
+        self.device = device
+        self.commandQueue = commandQueue
+        self.textureCache = textureCache
+        self.textureLoader = MTKTextureLoader(device: device)
+        self.laplacian = MPSImageLaplacian(device: device)
+        self.meanAndVariance = MPSImageStatisticsMeanAndVariance(device: device)
+    }
+
+    /// Computes the statistics of `pixelRegion` of a camera frame. Bi-planar YCbCr frames are measured
+    /// on their luminance plane, BGRA frames on the average of their color channels.
+    ///
+    /// - Returns: nil if the frame's pixel format isn't supported or the GPU work failed
+    func statistics(
+        of pixelBuffer: CVPixelBuffer,
+        in pixelRegion: CGRect
+    ) -> LaplacianStatistics? {
+        let pixelFormat: MTLPixelFormat
+        switch CVPixelBufferGetPixelFormatType(pixelBuffer) {
+        case kCVPixelFormatType_420YpCbCr8BiPlanarFullRange,
+            kCVPixelFormatType_420YpCbCr8BiPlanarVideoRange:
+            pixelFormat = .r8Unorm
+        case kCVPixelFormatType_32BGRA:
+            pixelFormat = .bgra8Unorm
+        default:
+            return nil
+        }
+
+        // The luminance plane is plane 0 and full size
+        let width = CVPixelBufferGetWidth(pixelBuffer)
+        let height = CVPixelBufferGetHeight(pixelBuffer)
+
+        var cvTexture: CVMetalTexture?
+        guard
+            CVMetalTextureCacheCreateTextureFromImage(
+                nil,
+                textureCache,
+                pixelBuffer,
+                nil,
+                pixelFormat,
+                width,
+                height,
+                0,
+                &cvTexture
+            ) == kCVReturnSuccess,
+            let cvTexture = cvTexture,
+            let sourceTexture = CVMetalTextureGetTexture(cvTexture)
+        else {
+            return nil
+        }
+
+        // The CVMetalTexture has to outlive the GPU work on its texture
+        return withExtendedLifetime(cvTexture) {
+            statistics(of: sourceTexture, in: pixelRegion)
+        }
+    }
+
+    /// Computes the statistics of the whole image, averaged over its color channels
+    func statistics(of image: CGImage) -> LaplacianStatistics? {
+        guard let sourceTexture = try? textureLoader.newTexture(cgImage: image, options: nil) else {
+            return nil
+        }
+        return statistics(
+            of: sourceTexture,
+            in: CGRect(x: 0, y: 0, width: sourceTexture.width, height: sourceTexture.height)
+        )
+    }
+
+    // MARK: - Private
+
+    private func statistics(
+        of sourceTexture: MTLTexture,
+        in pixelRegion: CGRect
+    ) -> LaplacianStatistics? {
+        let region = pixelRegion.integral.intersection(
+            CGRect(x: 0, y: 0, width: sourceTexture.width, height: sourceTexture.height)
+        )
+        guard !region.isNull, !region.isEmpty else {
+            return nil
+        }
+
+        lock.lock()
+        defer { lock.unlock() }
+
+        guard let commandBuffer = commandQueue.makeCommandBuffer(),
+            let laplacianTexture = laplacianTexture(
+                width: Int(region.width),
+                height: Int(region.height),
+                pixelFormat: sourceTexture.pixelFormat
+            ),
+            let statisticsTexture = statisticsTexture(for: sourceTexture.pixelFormat)
+        else {
+            return nil
+        }
+
+        // Only the region of interest is read from the source texture, and written to the top-left of
+        // the reused laplacian texture
+        let destinationRegion = MTLRegionMake2D(0, 0, Int(region.width), Int(region.height))
+        laplacian.offset = MPSOffset(x: Int(region.minX), y: Int(region.minY), z: 0)
+        laplacian.clipRect = destinationRegion
+        meanAndVariance.clipRectSource = destinationRegion
+        laplacian.encode(
+            commandBuffer: commandBuffer,
+            sourceTexture: sourceTexture,
+            destinationTexture: laplacianTexture
+        )
+        meanAndVariance.encode(
+            commandBuffer: commandBuffer,
+            sourceTexture: laplacianTexture,
+            destinationTexture: statisticsTexture
+        )
+        commandBuffer.commit()
+        commandBuffer.waitUntilCompleted()
+
+        guard commandBuffer.status == .completed else {
+            return nil
+        }
+
+        // The mean is written to the first pixel and the variance to the second
+        let bytesPerPixel = statisticsTexture.pixelFormat == .r32Float ? 4 : 16
+        var result = [Float](repeating: 0, count: 2 * bytesPerPixel / 4)
+        statisticsTexture.getBytes(
+            &result,
+            bytesPerRow: 2 * bytesPerPixel,
+            from: MTLRegionMake2D(0, 0, 2, 1),
+            mipmapLevel: 0
+        )
+
+        let mean: Float
+        let variance: Float
+        if statisticsTexture.pixelFormat == .r32Float {
+            mean = result[0]
+            variance = result[1]
+        } else {
+            // Average of the color channels, ignoring alpha
+            mean = (result[0] + result[1] + result[2]) / 3
+            variance = (result[4] + result[5] + result[6]) / 3
+        }
+        return LaplacianStatistics(
+            mean: mean,
+            variance: variance,
+            sampleCount: Int(region.width) * Int(region.height)
+        )
+    }
+
+    private func laplacianTexture(width: Int, height: Int, pixelFormat: MTLPixelFormat) -> MTLTexture? {
+        if let texture = laplacianTexture,
+            texture.width >= width,
+            texture.height >= height,
+            texture.pixelFormat == pixelFormat
+        {
+            return texture
+        }
+
+        // Grow to fit both the old and new regions so that regions that vary from frame to frame
+        // settle on one texture
+        let existingTexture = laplacianTexture?.pixelFormat == pixelFormat ? laplacianTexture : nil
+        let descriptor = MTLTextureDescriptor.texture2DDescriptor(
+            pixelFormat: pixelFormat,
+            width: max(width, existingTexture?.width ?? 0),
+            height: max(height, existingTexture?.height ?? 0),
+            mipmapped: false
+        )
+        descriptor.usage = [.shaderWrite, .shaderRead]
+        descriptor.storageMode = .private
+        laplacianTexture = device.makeTexture(descriptor: descriptor)
+        return laplacianTexture
+    }
+
+    private func statisticsTexture(for sourcePixelFormat: MTLPixelFormat) -> MTLTexture? {
+        if let texture = statisticsTextures[sourcePixelFormat] {
+            return texture
+        }
+
+        let descriptor = MTLTextureDescriptor.texture2DDescriptor(
+            pixelFormat: sourcePixelFormat == .r8Unorm ? .r32Float : .rgba32Float,
+            width: 2,
+            height: 1,
+            mipmapped: false
+        )
+        descriptor.usage = [.shaderWrite, .shaderRead]
+        let texture = device.makeTexture(descriptor: descriptor)
+        statisticsTextures[sourcePixelFormat] = texture
+        return texture
+    }
+}
@@ -0,0 +1,206 @@
+//
+//  MLMultiArrayMatrixView.swift
+//  StripeIdentity
+//
+//  Created by Stripe on 10/17/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+import Accelerate
+import CoreGraphics
+import CoreML
+import Foundation
+
+/// A read-only view of a `1 x rows x columns` multi-array output by an ML model, that reads elements
+/// straight from the array's memory through its strides.
+///
+/// Subscripting an `MLMultiArray` with `[NSNumber]` keys allocates the key and boxes the element for
+/// every read, which adds up over the thousands of elements a detector outputs for each frame.
+///
+/// The view doesn't own its elements, it's only valid inside `MLMultiArray.withMatrixView(_:)`.
+struct MLMultiArrayMatrixView {
+    fileprivate enum Storage {
+        case float32(UnsafePointer<Float>)
+        case float64(UnsafePointer<Double>)
+    }
+
+    let rows: Int
+    let columns: Int
+
+    private let storage: Storage
+    private let rowStride: Int
+    private let columnStride: Int
+
+    fileprivate init(
+        rows: Int,
+        columns: Int,
+        storage: Storage,
+        rowStride: Int,
+        columnStride: Int
+    ) {
+        self.rows = rows
+        self.columns = columns
+        self.storage = storage
+        self.rowStride = rowStride
+        self.columnStride = columnStride
+    }
+
+    /// The element at `row`, `column`. Elements are returned as `Double` so that they compare equal to
+    /// the `NSNumber` subscript's `doubleValue` and `floatValue` regardless of the array's data type.
+    subscript(row: Int, column: Int) -> Double {
+        let offset = row * rowStride + column * columnStride
+        switch storage {
+        case .float32(let baseAddress):
+            return Double(baseAddress[offset])
+        case .float64(let baseAddress):
+            return baseAddress[offset]
+        }
+    }
+
+    /// The bounding box in `row` of a detector's "boxes" output, which holds `x, y, width, height`
+    func rect(atRow row: Int) -> CGRect {
+        return CGRect(
+            x: self[row, 0],
+            y: self[row, 1],
+            width: self[row, 2],
+            height: self[row, 3]
+        )
+    }
+
+    /// The score in `row`, `column` of a detector's "scores" output
+    func score(row: Int, column: Int) -> Float {
+        return Float(self[row, column])
+    }
+}
+
+extension MLMultiArray {
+    /// Calls `body` with a view of this `1 x rows x columns` array.
+    ///
+    /// Float32 and Double arrays are read in place. Float16 and Int32 arrays are converted to a Float32
+    /// copy first, a row at a time with vImage and vDSP.
+    ///
+    /// - Returns: The result of `body`, or nil if the array isn't rank 3 or its data type isn't supported.
+    func withMatrixView<Result>(
+        _ body: (MLMultiArrayMatrixView) throws -> Result
+    ) rethrows -> Result? {
+        guard shape.count == 3 else {
+            return nil
+        }
+        let rows = shape[1].intValue
+        let columns = shape[2].intValue
+        let rowStride = strides[1].intValue
+        let columnStride = strides[2].intValue
+
+        // Keep the array alive while its memory is read
+        return try withExtendedLifetime(self) { () throws -> Result? in
+            switch dataType {
+            case .float32:
+                return try body(
+                    MLMultiArrayMatrixView(
+                        rows: rows,
+                        columns: columns,
+                        storage: .float32(UnsafePointer(dataPointer.assumingMemoryBound(to: Float.self))),
+                        rowStride: rowStride,
+                        columnStride: columnStride
+                    )
+                )
+            case .double:
+                return try body(
+                    MLMultiArrayMatrixView(
+                        rows: rows,
+                        columns: columns,
+                        storage: .float64(UnsafePointer(dataPointer.assumingMemoryBound(to: Double.self))),
+                        rowStride: rowStride,
+                        columnStride: columnStride
+                    )
+                )
+            default:
+                var elements = [Float](repeating: 0, count: rows * columns)
+                let didConvert = elements.withUnsafeMutableBufferPointer { destination in
+                    convertToFloat32(
+                        into: destination,
+                        rows: rows,
+                        columns: columns,
+                        rowStride: rowStride,
+                        columnStride: columnStride
+                    )
+                }
+                guard didConvert else {
+                    return nil
+                }
+                return try elements.withUnsafeBufferPointer { buffer in
+                    try body(
+                        MLMultiArrayMatrixView(
+                            rows: rows,
+                            columns: columns,
+                            storage: .float32(buffer.baseAddress!),
+                            rowStride: columns,
+                            columnStride: 1
+                        )
+                    )
+                }
+            }
+        }
+    }
+
+    /// Converts the elements of a Float16 or Int32 array into a contiguous Float32 buffer
+    ///
+    /// - Returns: false if the array's data type isn't supported
+    private func convertToFloat32(
+        into destination: UnsafeMutableBufferPointer<Float>,
+        rows: Int,
+        columns: Int,
+        rowStride: Int,
+        columnStride: Int
+    ) -> Bool {
+        guard let destinationAddress = destination.baseAddress else {
+            // Nothing to convert
+            return true
+        }
+
+        if #available(iOS 16.0, *), dataType == .float16 {
+            let source = dataPointer.assumingMemoryBound(to: UInt16.self)
+            for row in 0..<rows {
+                // Each row is converted as a column of single pixels, so that the column stride can be
+                // expressed as the source's row bytes
+                var sourceBuffer = vImage_Buffer(
+                    data: source + row * rowStride,
+                    height: vImagePixelCount(columns),
+                    width: 1,
+                    rowBytes: columnStride * MemoryLayout<UInt16>.stride
+                )
+                var destinationBuffer = vImage_Buffer(
+                    data: destinationAddress + row * columns,
+                    height: vImagePixelCount(columns),
+                    width: 1,
+                    rowBytes: MemoryLayout<Float>.stride
+                )
+                guard
+                    vImageConvert_Planar16FtoPlanarF(
+                        &sourceBuffer,
+                        &destinationBuffer,
+                        vImage_Flags(kvImageNoFlags)
+                    ) == kvImageNoError
+                else {
+                    return false
+                }
+            }
+            return true
+        }
+
+        guard dataType == .int32 else {
+            return false
+        }
+        let source = dataPointer.assumingMemoryBound(to: Int32.self)
+        for row in 0..<rows {
+            vDSP_vflt32(
+                source + row * rowStride,
+                vDSP_Stride(columnStride),
+                destinationAddress + row * columns,
+                1,
+                vDSP_Length(columns)
+            )
+        }
+        return true
+    }
+}
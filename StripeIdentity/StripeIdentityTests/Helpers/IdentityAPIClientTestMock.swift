@@ -127,12 +127,17 @@ class MockAPIRequests<ParamsType, ResponseType> {
     private var requests: [Promise<ResponseType>] = []
     private(set) var requestHistory: [ParamsType] = []
     private var requestCallbacks: [(() -> Void)] = []
+    /// Requests can be made from several threads at once, e.g. concurrent image uploads
+    private let lock = NSLock()
 
     fileprivate func makeRequest(with params: ParamsType) -> Promise<ResponseType> {
-        requestHistory.append(params)
         let promise = Promise<ResponseType>()
+        lock.lock()
+        requestHistory.append(params)
         requests.append(promise)
-        requestCallbacks.forEach { $0() }
+        let callbacks = requestCallbacks
+        lock.unlock()
+        callbacks.forEach { $0() }
         return promise
     }
 
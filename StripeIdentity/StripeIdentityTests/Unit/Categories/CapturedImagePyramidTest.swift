@@ -0,0 +1,130 @@
+//
+//  CapturedImagePyramidTest.swift
+//  StripeIdentityTests
+//
+//  Created by Stripe on 10/17/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+import CoreMedia
+@_spi(STP) import StripeCameraCore
+import XCTest
+
+@testable import StripeIdentity
+
+final class CapturedImagePyramidTest: XCTestCase {
+
+    let mockImage = CapturedImageMock.frontDriversLicense.image.cgImage!
+
+    func testCropMatchesCGImageCrop() throws {
+        let pyramid = CapturedImagePyramid(image: mockImage)
+
+        let expectedImage = try mockImage.cropping(
+            toNormalizedRegion: DocumentUploaderTest.mockRegionOfInterest,
+            withPadding: 0.08,
+            computationMethod: .maxImageWidthOrHeight
+        )
+        let croppedImage = try pyramid.croppedImage(
+            toNormalizedRegion: DocumentUploaderTest.mockRegionOfInterest,
+            withPadding: 0.08,
+            computationMethod: .maxImageWidthOrHeight
+        )
+
+        XCTAssertEqual(croppedImage.width, expectedImage.width)
+        XCTAssertEqual(croppedImage.height, expectedImage.height)
+    }
+
+    func testScaleMatchesCGImageScale() throws {
+        let pyramid = CapturedImagePyramid(image: mockImage)
+        let maxDimension = CGSize(width: 200, height: 200)
+
+        let expectedImage = try mockImage.scaledDown(toMaxPixelDimension: maxDimension)
+        let scaledImage = try pyramid.scaledImage(toMaxPixelDimension: maxDimension)
+
+        XCTAssertEqual(scaledImage.width, expectedImage.width)
+        XCTAssertEqual(scaledImage.height, expectedImage.height)
+    }
+
+    func testCropAndScale() throws {
+        let pyramid = CapturedImagePyramid(image: mockImage)
+        let maxDimension = CGSize(width: 600, height: 600)
+
+        let expectedImage = try mockImage.cropping(
+            toNormalizedRegion: DocumentUploaderTest.mockRegionOfInterest,
+            withPadding: 0.08,
+            computationMethod: .maxImageWidthOrHeight
+        ).scaledDown(toMaxPixelDimension: maxDimension)
+        let image = try pyramid.croppedImage(
+            toNormalizedRegion: DocumentUploaderTest.mockRegionOfInterest,
+            withPadding: 0.08,
+            computationMethod: .maxImageWidthOrHeight,
+            scaledDownToMaxPixelDimension: maxDimension
+        )
+
+        XCTAssertEqual(image.width, expectedImage.width)
+        XCTAssertEqual(image.height, expectedImage.height)
+    }
+
+    // Tests that an image that's already small enough isn't scaled
+    func testScaleSmallerImage() throws {
+        let pyramid = CapturedImagePyramid(image: mockImage)
+
+        let image = try pyramid.scaledImage(
+            toMaxPixelDimension: CGSize(width: mockImage.width * 2, height: mockImage.height * 2)
+        )
+
+        XCTAssertEqual(image.width, mockImage.width)
+        XCTAssertEqual(image.height, mockImage.height)
+    }
+
+    func testCachesImages() throws {
+        let pyramid = CapturedImagePyramid(image: mockImage)
+        let maxDimension = CGSize(width: 200, height: 200)
+
+        let image = try pyramid.scaledImage(toMaxPixelDimension: maxDimension)
+        XCTAssert(image === (try pyramid.scaledImage(toMaxPixelDimension: maxDimension)))
+    }
+
+    func testCropOutsideImageThrows() {
+        let pyramid = CapturedImagePyramid(image: mockImage)
+
+        XCTAssertThrowsError(
+            try pyramid.croppedImage(
+                toNormalizedRegion: CGRect(x: 2, y: 2, width: 0.5, height: 0.5),
+                withPadding: 0,
+                computationMethod: .maxImageWidthOrHeight
+            )
+        )
+    }
+
+    // Tests that everything that handles the same capture gets the same decode
+    func testSharedForSampleBuffer() throws {
+        let sampleBuffer = try XCTUnwrap(
+            CapturedImageMock.frontDriversLicense.image.convertToSampleBuffer()
+        )
+
+        let pyramid = try XCTUnwrap(CapturedImagePyramid.pyramid(for: sampleBuffer))
+        XCTAssert(pyramid === CapturedImagePyramid.pyramid(for: sampleBuffer))
+
+        let pixelBuffer = try XCTUnwrap(CMSampleBufferGetImageBuffer(sampleBuffer))
+        XCTAssertEqual(pyramid.image.width, CVPixelBufferGetWidth(pixelBuffer))
+        XCTAssertEqual(pyramid.image.height, CVPixelBufferGetHeight(pixelBuffer))
+    }
+
+    // Tests that a pyramid made from a scanned image, like the uploader's, reads the scan's decode
+    func testImageFromCaptureIsNotDecodedAgain() throws {
+        let sampleBuffer = try XCTUnwrap(
+            CapturedImageMock.frontDriversLicense.image.convertToSampleBuffer()
+        )
+        let scannedImage = try XCTUnwrap(CapturedImagePyramid.pyramid(for: sampleBuffer)?.image)
+        let maxDimension = CGSize(width: 200, height: 200)
+
+        let pyramid = CapturedImagePyramid(image: scannedImage)
+        let image = try pyramid.scaledImage(toMaxPixelDimension: maxDimension)
+
+        let expectedImage = try scannedImage.scaledDown(toMaxPixelDimension: maxDimension)
+        XCTAssertEqual(image.width, expectedImage.width)
+        XCTAssertEqual(image.height, expectedImage.height)
+        XCTAssertFalse(pyramid.ownsSourceBuffer)
+    }
+}
@@ -266,4 +266,84 @@ final class IdentityImageUploaderTest: XCTestCase {
         XCTAssertEqual(imageFromData?.scale, 1)
         XCTAssertEqual(imageFromData?.size, imageSize)
     }
+
+    func testHighResCropErrorIsLoggedAsCropStage() {
+        let uploadResponseExp = expectation(description: "Upload failed")
+
+        uploader.uploadHighResImage(
+            mockImage,
+            regionOfInterest: CGRect(x: 2, y: 2, width: 0.5, height: 0.5),
+            cropPaddingComputationMethod: .maxImageWidthOrHeight,
+            fileName: "high-res-prefix"
+        ).observe { _ in
+            uploadResponseExp.fulfill()
+        }
+        wait(for: [uploadResponseExp], timeout: 1)
+
+        let errorAnalytic = mockAnalyticsClient.loggedAnalyticPayloads(
+            withEventName: "generic_error"
+        ).first
+        XCTAssert(analytic: errorAnalytic, hasMetadata: "image_upload_stage", withValue: "highResCrop")
+        XCTAssert(analytic: errorAnalytic, hasMetadata: "file_name", withValue: "high-res-prefix")
+    }
+
+    func testResizeErrorIsLoggedAsResizeStage() {
+        let uploadResponseExp = expectation(description: "Upload failed")
+
+        uploader.uploadJPEGResize(
+            image: mockImage,
+            fileName: "low-res-prefix_full_frame",
+            jpegCompressionQuality: 0.8,
+            newSize: .zero
+        ).observe { _ in
+            uploadResponseExp.fulfill()
+        }
+        wait(for: [uploadResponseExp], timeout: 1)
+
+        let errorAnalytic = mockAnalyticsClient.loggedAnalyticPayloads(
+            withEventName: "generic_error"
+        ).first
+        XCTAssert(analytic: errorAnalytic, hasMetadata: "image_upload_stage", withValue: "imageResize")
+        XCTAssert(analytic: errorAnalytic, hasMetadata: "file_name", withValue: "low-res-prefix_full_frame")
+    }
+
+    // Tests that both images are sent without waiting on each other's upload
+    func testUploadLowAndHighResImages() {
+        let uploadRequestExpectations = mockAPIClient.makeUploadRequestExpectations(count: 2)
+        let uploadResponseExp = expectation(description: "Upload completed")
+
+        uploader.uploadLowAndHighResImages(
+            mockImage,
+            highResRegionOfInterest: DocumentUploaderTest.mockRegionOfInterest,
+            cropPaddingComputationMethod: .maxImageWidthOrHeight,
+            lowResFileName: "prefix_full_frame",
+            highResFileName: "prefix"
+        ).observe { result in
+            if case .failure(let error) = result {
+                XCTFail("Failed with \(error)")
+            }
+            uploadResponseExp.fulfill()
+        }
+
+        // Wait until both requests are made
+        wait(for: uploadRequestExpectations, timeout: 1)
+
+        let requests = mockAPIClient.imageUpload.requestHistory
+        let lowResRequest = requests.first { $0.fileName == "prefix_full_frame" }
+        let highResRequest = requests.first { $0.fileName == "prefix" }
+        XCTAssertEqual(lowResRequest?.image.size.height, 200)
+        XCTAssertEqual(lowResRequest?.compressionQuality, 0.8)
+        XCTAssertEqual(highResRequest?.image.size.width, 600)
+        XCTAssertEqual(highResRequest?.compressionQuality, 0.9)
+
+        mockAPIClient.imageUpload.respondToRequests(
+            with: .success(
+                (
+                    file: DocumentUploaderTest.mockStripeFile,
+                    metrics: DocumentUploaderTest.mockUploadMetrics
+                )
+            )
+        )
+        wait(for: [uploadResponseExp], timeout: 1)
+    }
 }
@@ -0,0 +1,182 @@
+//
+//  LaplacianBlurDetectorTest.swift
+//  StripeIdentityTests
+//
+//  Created by Stripe on 10/17/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+import CoreGraphics
+@_spi(STP) import StripeCameraCore
+import UIKit
+import XCTest
+
+@testable import StripeIdentity
+
+final class LaplacianBlurDetectorTest: XCTestCase {
+
+    func testFlatPlaneHasNoResponse() throws {
+        let statistics = try withPlane(width: 40, height: 30, pixel: { _, _ in 128 }) {
+            try XCTUnwrap(LaplacianKernel.statistics(of: $0))
+        }
+
+        XCTAssertEqual(statistics.mean, 0)
+        XCTAssertEqual(statistics.variance, 0)
+        XCTAssertEqual(statistics.sampleCount, 38 * 28)
+    }
+
+    // A single bright pixel on a black plane only has a positive response at the pixel itself,
+    // since responses are clamped to 0–1
+    func testSinglePixelResponse() throws {
+        let statistics = try withPlane(width: 21, height: 5, pixel: { x, y in x == 10 && y == 2 ? 51 : 0 }) {
+            try XCTUnwrap(LaplacianKernel.statistics(of: $0))
+        }
+
+        // Laplacian at the pixel is -4 * 51 / 255 = -0.8, which clamps to 0. Its 4 neighbors
+        // each have a response of 51 / 255 = 0.2
+        let count = Float(19 * 3)
+        XCTAssertEqual(statistics.mean, 4 * 0.2 / count, accuracy: 1e-6)
+        XCTAssertEqual(
+            statistics.variance,
+            4 * 0.04 / count - (4 * 0.2 / count) * (4 * 0.2 / count),
+            accuracy: 1e-6
+        )
+    }
+
+    // Rows that aren't a multiple of the vector width end in the scalar tail. Both should match
+    // a straightforward computation.
+    func testMatchesReferenceComputation() throws {
+        let pattern: (Int, Int) -> UInt8 = { x, y in UInt8((x * 37 + y * 91) % 256) }
+        let width = 23
+        let height = 9
+
+        var sum = 0.0
+        var sumOfSquares = 0.0
+        for y in 1..<(height - 1) {
+            for x in 1..<(width - 1) {
+                let laplacian =
+                    Int(pattern(x - 1, y)) + Int(pattern(x + 1, y)) + Int(pattern(x, y - 1))
+                    + Int(pattern(x, y + 1)) - 4 * Int(pattern(x, y))
+                let response = min(max(Double(laplacian) / 255, 0), 1)
+                sum += response
+                sumOfSquares += response * response
+            }
+        }
+        let count = Double((width - 2) * (height - 2))
+        let expectedMean = sum / count
+        let expectedVariance = sumOfSquares / count - expectedMean * expectedMean
+
+        let statistics = try withPlane(width: width, height: height, pixel: pattern) {
+            try XCTUnwrap(LaplacianKernel.statistics(of: $0))
+        }
+
+        XCTAssertEqual(statistics.sampleCount, Int(count))
+        XCTAssertEqual(Double(statistics.mean), expectedMean, accuracy: 1e-5)
+        XCTAssertEqual(Double(statistics.variance), expectedVariance, accuracy: 1e-5)
+    }
+
+    func testCheckerboardSamplingSamplesHalfOfTiles() throws {
+        let counts = try withPlane(width: 130, height: 130, pixel: { x, y in UInt8((x ^ y) & 0xFF) }) {
+            plane -> (all: Int, checkerboard: Int) in
+            let all = try XCTUnwrap(LaplacianKernel.statistics(of: plane, sampling: .all))
+            let checkerboard = try XCTUnwrap(LaplacianKernel.statistics(of: plane, sampling: .checkerboard))
+            return (all.sampleCount, checkerboard.sampleCount)
+        }
+
+        XCTAssertEqual(counts.all, 128 * 128)
+        XCTAssertEqual(counts.checkerboard, 128 * 128 / 2)
+    }
+
+    func testRegionIsClampedToPlane() throws {
+        try withPlane(width: 20, height: 10, pixel: { _, _ in 0 }) { plane in
+            let region = try XCTUnwrap(plane.region(CGRect(x: 15, y: -5, width: 10, height: 10)))
+            XCTAssertEqual(region.width, 5)
+            XCTAssertEqual(region.height, 5)
+            XCTAssertEqual(region.baseAddress, plane.baseAddress + 15)
+
+            XCTAssertNil(plane.region(CGRect(x: 30, y: 0, width: 10, height: 10)))
+        }
+    }
+
+    func testTooSmallPlane() {
+        withPlane(width: 2, height: 10, pixel: { _, _ in 0 }) {
+            XCTAssertNil(LaplacianKernel.statistics(of: $0))
+        }
+    }
+
+    func testDetectsBlurryImage() {
+        let detector = LaplacianBlurDetector(blurThreshold: 5)
+
+        let sharpOutput = detector.calculateBlurOutput(inputImage: makeImage { x, _ in x % 2 == 0 ? 255 : 0 })
+        XCTAssertFalse(sharpOutput.isBlurry)
+
+        let blurryOutput = detector.calculateBlurOutput(inputImage: makeImage { x, _ in UInt8(x) })
+        XCTAssertTrue(blurryOutput.isBlurry)
+    }
+
+    func testPixelBufferMatchesImage() throws {
+        let detector = LaplacianBlurDetector(blurThreshold: 5)
+        let image = makeImage { x, y in (x / 3 + y / 5) % 2 == 0 ? 220 : 30 }
+        let pixelBuffer = try XCTUnwrap(UIImage(cgImage: image, scale: 1, orientation: .up).convertToPixelBuffer())
+
+        let pixelBufferOutput = detector.calculateBlurOutput(
+            pixelBuffer: pixelBuffer,
+            regionOfInterest: CGRect(x: 0, y: 0, width: image.width, height: image.height)
+        )
+        let imageOutput = detector.calculateBlurOutput(inputImage: image)
+
+        XCTAssertGreaterThan(imageOutput.variance, 0)
+        XCTAssertEqual(pixelBufferOutput.variance, imageOutput.variance, accuracy: imageOutput.variance * 0.05)
+    }
+}
+
+extension LaplacianBlurDetectorTest {
+    fileprivate func withPlane<T>(
+        width: Int,
+        height: Int,
+        pixel: (Int, Int) -> UInt8,
+        _ block: (LuminancePlane) throws -> T
+    ) rethrows -> T {
+        // Pad the rows so that row bytes don't equal the width
+        let rowBytes = width + 3
+        var pixels = [UInt8](repeating: 0, count: rowBytes * height)
+        for y in 0..<height {
+            for x in 0..<width {
+                pixels[y * rowBytes + x] = pixel(x, y)
+            }
+        }
+        return try pixels.withUnsafeBufferPointer { buffer in
+            try block(
+                LuminancePlane(
+                    baseAddress: buffer.baseAddress!,
+                    width: width,
+                    height: height,
+                    rowBytes: rowBytes
+                )
+            )
+        }
+    }
+
+    fileprivate func makeImage(pixel: (Int, Int) -> UInt8) -> CGImage {
+        let width = 64
+        let height = 64
+        var pixels = [UInt8](repeating: 0, count: width * height)
+        for y in 0..<height {
+            for x in 0..<width {
+                pixels[y * width + x] = pixel(x, y)
+            }
+        }
+        return pixels.withUnsafeMutableBytes { bytes in
+            let context = CGContext(
+                data: bytes.baseAddress,
+                width: width,
+                height: height,
+                bitsPerComponent: 8,
+                bytesPerRow: width,
+                space: CGColorSpaceCreateDeviceGray(),
+                bitmapInfo: CGImageAlphaInfo.none.rawValue
+            )
+            return context!.makeImage()!
+        }
+    }
+}
@@ -0,0 +1,142 @@
+//
+//  MLDetectorOutputTest.swift
+//  StripeIdentityTests
+//
+//  Created by Stripe on 10/17/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+import CoreGraphics
+import CoreML
+import XCTest
+
+@testable import StripeIdentity
+
+final class MLDetectorOutputTest: XCTestCase {
+    private let configuration = MLDetectorConfiguration(minScore: 0.5, minIOU: 0.5)
+    // A square image so that the center-cropped square is the whole image
+    private let originalImageSize = CGSize(width: 1, height: 1)
+
+    func testIDDetectorOutput() throws {
+        let output = try XCTUnwrap(
+            IDDetectorOutput(
+                boxes: try makeArray([
+                    [0.125, 0.125, 0.5, 0.25],
+                    // Overlaps the first box with a lower score
+                    [0.1875, 0.125, 0.5, 0.25],
+                    [0.25, 0.5, 0.5, 0.25],
+                    // Outside the bounds of the image
+                    [0.75, 0.75, 0.5, 0.5],
+                ]),
+                // The last classification isn't known to the client
+                scores: try makeArray([
+                    [0.875, 0, 0, 0, 0],
+                    [0.75, 0, 0, 0, 0],
+                    [0, 0.625, 0, 0, 0.96875],
+                    [0.96875, 0, 0, 0, 0],
+                ]),
+                originalImageSize: originalImageSize,
+                configuration: configuration
+            )
+        )
+
+        XCTAssertEqual(output.classification, .passport)
+        XCTAssertEqual(output.documentBounds, CGRect(x: 0.125, y: 0.125, width: 0.5, height: 0.25))
+        XCTAssertEqual(output.allClassificationScores, [.passport: 0.875, .idCardFront: 0.625])
+    }
+
+    func testIDDetectorOutputWithoutPredictionsAboveMinScore() throws {
+        XCTAssertNil(
+            IDDetectorOutput(
+                boxes: try makeArray([[0.125, 0.125, 0.5, 0.25]]),
+                scores: try makeArray([[0.5, 0.25, 0, 0]]),
+                originalImageSize: originalImageSize,
+                configuration: configuration
+            )
+        )
+    }
+
+    func testIDDetectorOutputWithMoreScoresThanBoxes() throws {
+        XCTAssertNil(
+            IDDetectorOutput(
+                boxes: try makeArray([[0.125, 0.125, 0.5, 0.25]]),
+                scores: try makeArray([[0.875, 0, 0, 0], [0.96875, 0, 0, 0]]),
+                originalImageSize: originalImageSize,
+                configuration: configuration
+            )
+        )
+    }
+
+    func testFaceDetectorOutputWithMoreScoresThanBoxes() throws {
+        let output = FaceDetectorOutput(
+            boxes: try makeArray([[0.125, 0.125, 0.25, 0.25]]),
+            scores: try makeArray([[0.875], [0.96875]]),
+            originalImageSize: originalImageSize,
+            configuration: configuration
+        )
+
+        XCTAssertEqual(output.predictions, [])
+    }
+
+    func testFaceDetectorOutput() throws {
+        let output = FaceDetectorOutput(
+            boxes: try makeArray([
+                [0.125, 0.125, 0.25, 0.25],
+                // Overlaps the first box with a lower score
+                [0.125, 0.1875, 0.25, 0.25],
+                [0.5, 0.5, 0.25, 0.25],
+                // Below the min score
+                [0.5, 0.125, 0.25, 0.25],
+                // Outside the bounds of the image
+                [0.875, 0.875, 0.25, 0.25],
+            ]),
+            scores: try makeArray([[0.875], [0.75], [0.625], [0.25], [0.96875]]),
+            originalImageSize: originalImageSize,
+            configuration: configuration
+        )
+
+        XCTAssertEqual(
+            output.predictions,
+            [
+                .init(rect: CGRect(x: 0.125, y: 0.125, width: 0.25, height: 0.25), score: 0.875),
+                .init(rect: CGRect(x: 0.5, y: 0.5, width: 0.25, height: 0.25), score: 0.625),
+            ]
+        )
+    }
+
+    func testFaceDetectorOutputFromFloat16() throws {
+        guard #available(iOS 16.0, *) else {
+            throw XCTSkip("Float16 multi-arrays require iOS 16")
+        }
+        let output = FaceDetectorOutput(
+            boxes: try makeArray([[0.125, 0.125, 0.25, 0.25]], dataType: .float16),
+            scores: try makeArray([[0.875]], dataType: .float16),
+            originalImageSize: originalImageSize,
+            configuration: configuration
+        )
+
+        XCTAssertEqual(
+            output.predictions,
+            [.init(rect: CGRect(x: 0.125, y: 0.125, width: 0.25, height: 0.25), score: 0.875)]
+        )
+    }
+}
+
+extension MLDetectorOutputTest {
+    /// Makes a `1 x rows x columns` multi-array, like the ones output by the detector models
+    fileprivate func makeArray(
+        _ rows: [[Float]],
+        dataType: MLMultiArrayDataType = .float32
+    ) throws -> MLMultiArray {
+        let array = try MLMultiArray(
+            shape: [1, NSNumber(value: rows.count), NSNumber(value: rows.first?.count ?? 0)],
+            dataType: dataType
+        )
+        for (row, values) in rows.enumerated() {
+            for (column, value) in values.enumerated() {
+                array[[0, row, column]] = NSNumber(value: value)
+            }
+        }
+        return array
+    }
+}
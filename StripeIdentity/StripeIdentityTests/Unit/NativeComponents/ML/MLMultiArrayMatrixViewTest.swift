@@ -0,0 +1,106 @@
+//
+//  MLMultiArrayMatrixViewTest.swift
+//  StripeIdentityTests
+//
+//  Created by Stripe on 10/17/26.
+//  Copyright © 2026 Stripe, Inc. All rights reserved.
+//
+
+import CoreML
+import XCTest
+
+@testable import StripeIdentity
+
+final class MLMultiArrayMatrixViewTest: XCTestCase {
+    private let rows = 5
+    private let columns = 3
+
+    func testFloat32MatchesSubscript() throws {
+        try verifyViewMatchesSubscript(try makeArray(dataType: .float32))
+    }
+
+    func testDoubleMatchesSubscript() throws {
+        try verifyViewMatchesSubscript(try makeArray(dataType: .double))
+    }
+
+    func testInt32MatchesSubscript() throws {
+        try verifyViewMatchesSubscript(try makeArray(dataType: .int32))
+    }
+
+    func testFloat16MatchesSubscript() throws {
+        guard #available(iOS 16.0, *) else {
+            throw XCTSkip("Float16 multi-arrays require iOS 16")
+        }
+        try verifyViewMatchesSubscript(try makeArray(dataType: .float16))
+    }
+
+    // Rows padded past their last column and columns that aren't adjacent are read through the strides
+    func testNonContiguousStrides() throws {
+        let rowStride = 8
+        let columnStride = 2
+        let elements = UnsafeMutablePointer<Float>.allocate(capacity: rows * rowStride)
+        elements.initialize(repeating: -1, count: rows * rowStride)
+        for row in 0..<rows {
+            for column in 0..<columns {
+                elements[row * rowStride + column * columnStride] = Float(row * 10 + column)
+            }
+        }
+        let array = try MLMultiArray(
+            dataPointer: elements,
+            shape: [1, NSNumber(value: rows), NSNumber(value: columns)],
+            dataType: .float32,
+            strides: [NSNumber(value: rows * rowStride), NSNumber(value: rowStride), NSNumber(value: columnStride)],
+            deallocator: { $0.deallocate() }
+        )
+
+        try verifyViewMatchesSubscript(array)
+    }
+
+    func testRejectsWrongRank() throws {
+        let array = try MLMultiArray(shape: [4, 4], dataType: .float32)
+        XCTAssertNil(array.withMatrixView { $0.rows })
+    }
+
+    func testRectAndScore() throws {
+        let array = try MLMultiArray(shape: [1, 1, 4], dataType: .float32)
+        [0.25, 0.5, 0.125, 0.375].enumerated().forEach { array[[0, 0, $0.offset]] = NSNumber(value: $0.element) }
+
+        let (rect, score) = try XCTUnwrap(array.withMatrixView { ($0.rect(atRow: 0), $0.score(row: 0, column: 1)) })
+        XCTAssertEqual(rect, CGRect(x: 0.25, y: 0.5, width: 0.125, height: 0.375))
+        XCTAssertEqual(score, 0.5)
+    }
+}
+
+extension MLMultiArrayMatrixViewTest {
+    fileprivate func makeArray(dataType: MLMultiArrayDataType) throws -> MLMultiArray {
+        let array = try MLMultiArray(
+            shape: [1, NSNumber(value: rows), NSNumber(value: columns)],
+            dataType: dataType
+        )
+        for row in 0..<rows {
+            for column in 0..<columns {
+                // Values that are exact in every data type
+                array[[0, row, column]] = NSNumber(value: row * 10 + column - 7)
+            }
+        }
+        return array
+    }
+
+    fileprivate func verifyViewMatchesSubscript(
+        _ array: MLMultiArray,
+        file: StaticString = #filePath,
+        line: UInt = #line
+    ) throws {
+        let values = try XCTUnwrap(
+            array.withMatrixView { view -> [[Double]] in
+                XCTAssertEqual(view.rows, rows, file: file, line: line)
+                XCTAssertEqual(view.columns, columns, file: file, line: line)
+                return (0..<view.rows).map { row in (0..<view.columns).map { view[row, $0] } }
+            },
+            file: file,
+            line: line
+        )
+        let expected = (0..<rows).map { row in (0..<columns).map { array[[0, row, $0]].doubleValue } }
+        XCTAssertEqual(values, expected, file: file, line: line)
+    }
+}
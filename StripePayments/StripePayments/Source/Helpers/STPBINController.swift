@@ -122,6 +122,52 @@ extension STPBINRange {
     }
 }
 
+/// The BIN ranges known to an `STPBINController`, indexed for lookups by card number and by brand.
+///
+/// Tables are immutable. Merging in ranges from the card metadata service builds a new table that the
+/// controller swaps in under its lock, so a lookup never sees a partly merged set of ranges.
+struct STPBINRangeTable {
+    static let initial = STPBINRangeTable(ranges: STPBINController.STPBINRangeInitialRanges)
+
+    let ranges: [STPBINRange]
+    private let trie: DigitPrefixTrie
+    private let rangesByBrand: [STPCardBrand: [STPBINRange]]
+
+    init(
+        ranges: [STPBINRange]
+    ) {
+        self.ranges = ranges
+        self.trie = DigitPrefixTrie(
+            ranges: ranges.map { (low: $0.accountRangeLow, high: $0.accountRangeHigh) }
+        )
+        self.rangesByBrand = Dictionary(grouping: ranges, by: { $0.brand })
+    }
+
+    func merging(_ newRanges: [STPBINRange]) -> STPBINRangeTable {
+        guard !newRanges.isEmpty else { return self }
+        return STPBINRangeTable(ranges: ranges + newRanges)
+    }
+
+    /// The ranges that `matchesNumber(number)`, in order
+    func ranges(forNumber number: String) -> [STPBINRange] {
+        guard number.utf8.allSatisfy({ $0 >= 0x30 && $0 <= 0x39 }) else {
+            // the trie only indexes digits, `matchesNumber` has its own rules for anything else
+            return ranges.filter { $0.matchesNumber(number) }
+        }
+
+        var indices = trie.ranges(consistentWith: number)
+        let unindexed = trie.unindexedRanges.filter { ranges[$0].matchesNumber(number) }
+        if !unindexed.isEmpty {
+            indices = (indices + unindexed).sorted()
+        }
+        return indices.map { ranges[$0] }
+    }
+
+    func ranges(for brand: STPCardBrand) -> [STPBINRange] {
+        return rangesByBrand[brand] ?? []
+    }
+}
+
 private let CardMetadataURL = URL(string: "https://api.stripe.com/edge-internal/card-metadata")!
 
 extension STPBINRange {
@@ -161,7 +207,7 @@ extension STPBINRange {
     /// For testing
     @_spi(STP) public func reset() {
         _performSync {
-            sAllRanges = STPBINController.STPBINRangeInitialRanges
+            sRangeTable = .initial
         }
     }
 
@@ -175,29 +221,19 @@ extension STPBINRange {
     }
 
     @_spi(STP) public func allRanges() -> [STPBINRange] {
-        var ret: [STPBINRange]?
-        self._performSync(withAllRangesLock: {
-            ret = sAllRanges
-        })
-        return ret ?? []
+        return rangeTable().ranges
     }
 
     @_spi(STP) public func binRanges(forNumber number: String) -> [STPBINRange] {
-        return self.allRanges().filter { (binRange) -> Bool in
-            binRange.matchesNumber(number)
-        }
+        return rangeTable().ranges(forNumber: number)
     }
 
     @_spi(STP) public func binRanges(for brand: STPCardBrand) -> [STPBINRange] {
-        return self.allRanges().filter { (binRange) -> Bool in
-            binRange.brand == brand
-        }
+        return rangeTable().ranges(for: brand)
     }
 
     @_spi(STP) public func mostSpecificBINRange(forNumber number: String) -> STPBINRange {
-        let validRanges = self.allRanges().filter { (range) -> Bool in
-            range.matchesNumber(number)
-        }
+        let validRanges = binRanges(forNumber: number)
         return validRanges.sorted { (r1, r2) -> Bool in
             if number.isEmpty {
                 // empty numbers should always best match to unknown brand
@@ -219,12 +255,8 @@ extension STPBINRange {
     @_spi(STP) public func minCardNumberLength(for brand: STPCardBrand) -> Int {
         switch brand {
         case .visa, .amex, .mastercard, .discover, .JCB, .dinersClub, .cartesBancaires:
-            return allRanges().reduce(Int.max) { currentMinimum, range in
-                if range.brand == brand {
-                    return min(currentMinimum, Int(range.panLength))
-                } else {
-                    return currentMinimum
-                }
+            return binRanges(for: brand).reduce(Int.max) { currentMinimum, range in
+                min(currentMinimum, Int(range.panLength))
             }
         case .unionPay:
             return 16
@@ -317,9 +349,9 @@ extension STPBINRange {
                             } else if let ranges = try? ranges.get(), !ranges.isEmpty {
                                 self.sRetrievedRanges[binPrefixKey] = ranges
                             }
+                            // swap in a new table with the ranges merged, so lookups see all of them or none
                             self._performSync(withAllRangesLock: {
-                                self.sAllRanges =
-                                    self.sAllRanges + ((try? ranges.get()) ?? [])
+                                self.sRangeTable = self.sRangeTable.merging((try? ranges.get()) ?? [])
                             })
 
                             if case .failure = ranges {
@@ -402,9 +434,12 @@ extension STPBINRange {
         return binRanges
     }()
 
-    var sAllRanges: [STPBINRange] = {
-        return STPBINRangeInitialRanges
-    }()
+    var sAllRanges: [STPBINRange] {
+        get { sRangeTable.ranges }
+        set { sRangeTable = STPBINRangeTable(ranges: newValue) }
+    }
+
+    var sRangeTable: STPBINRangeTable = .initial
 
     let sAllRangesLockQueue: DispatchQueue = {
         DispatchQueue(label: "com.stripe.STPBINRange.allRanges")
@@ -416,6 +451,14 @@ extension STPBINRange {
         })
     }
 
+    func rangeTable() -> STPBINRangeTable {
+        var table = STPBINRangeTable.initial
+        _performSync(withAllRangesLock: {
+            table = sRangeTable
+        })
+        return table
+    }
+
     // sPendingRequests contains the completion blocks for a given metadata request that we have not yet gotten a response for
     var sPendingRequests: [String: [STPRetrieveBINRangesCompletionBlock]] = [:]
 